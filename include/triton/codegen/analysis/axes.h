@@ -30,6 +30,8 @@ private:
   void update_graph_elementwise(ir::instruction *i,
                                 bool is_masked_load_async=false);
   void update_graph_no_edge(ir::instruction *i);
+  void update_graph_call(ir::instruction *i);
+  void update_graph_extract_value(ir::instruction *i);
   void update_graph(ir::instruction *i);
 
 public:
@@ -0,0 +1,63 @@
+#ifndef TRITON_INCLUDE_CODEGEN_ANALYSIS_BANK_CONFLICTS_H
+#define TRITON_INCLUDE_CODEGEN_ANALYSIS_BANK_CONFLICTS_H
+
+#include <map>
+#include <vector>
+
+namespace triton{
+
+namespace ir{
+  class module;
+  class instruction;
+}
+
+namespace codegen{
+class target;
+
+namespace analysis{
+
+class layouts;
+class shared_layout;
+class swizzle;
+
+// shared memory traffic of one instruction on one buffer
+struct bank_access {
+  ir::instruction* inst;
+  bool is_write;
+  // number of shared memory wavefronts issued by all warps
+  unsigned wavefronts;
+  // number of wavefronts that would be issued without conflicts
+  unsigned phases;
+  // worst-case conflict degree of a single wavefront
+  unsigned max_ways;
+};
+
+// Static simulation of the shared memory accesses performed by each
+// warp on swizzled `shared_layout`s. Writes of `copy_to_shared` and
+// `masked_load_async` follow their scanline input layout; reads are
+// only modeled for `ldmatrix` (i.e., tensor cores on sm >= 80).
+class bank_conflicts {
+public:
+  bank_conflicts(layouts *l, swizzle *swz, target *tgt)
+    : layouts_(l), swizzle_(swz), tgt_(tgt) {}
+  // simulate `layout` for the given swizzling parameters
+  static std::vector<bank_access> simulate(shared_layout* layout, layouts* l, target* tgt,
+                                           int per_phase, int max_phase, int vec);
+  // accessors
+  const std::vector<bank_access>& get(shared_layout* layout) { return accesses_.at(layout); }
+  const std::map<shared_layout*, std::vector<bank_access>>& get_all() { return accesses_; }
+  // run
+  void run(ir::module &mod);
+
+private:
+  layouts* layouts_;
+  swizzle* swizzle_;
+  target* tgt_;
+  std::map<shared_layout*, std::vector<bank_access>> accesses_;
+};
+
+}
+}
+}
+
+#endif
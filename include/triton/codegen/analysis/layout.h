@@ -148,6 +148,11 @@ struct scanline_layout: public distributed_layout {
   // accessor
   int mts(size_t k) { return mts_.at(k); }
   int nts(size_t k) { return nts_.at(k); }
+  // number of threads spanned by the layout, padded to full warps
+  int get_num_threads();
+  // coordinates of the elements held by thread `tid`,
+  // enumerated in the same order as the code generator
+  std::vector<std::vector<int>> get_elements(int tid);
 
 public:
   // micro tile size. The size of a tile held by a thread block.
@@ -0,0 +1,63 @@
+#ifndef TRITON_INCLUDE_CODEGEN_ANALYSIS_MEMORY_H
+#define TRITON_INCLUDE_CODEGEN_ANALYSIS_MEMORY_H
+
+#include <string>
+#include <vector>
+
+namespace triton{
+
+namespace ir{
+  class module;
+  class instruction;
+}
+
+namespace codegen{
+namespace analysis{
+
+class align;
+class layouts;
+
+// global memory traffic of one load, store or atomic instruction
+struct memory_access {
+  ir::instruction* inst;
+  bool is_masked;
+  // facts inferred along the leading dimension of the pointer
+  unsigned contiguous;
+  unsigned alignment;
+  // contiguous elements held by each thread
+  unsigned nts;
+  // elements accessed by each instruction of each thread
+  unsigned vec;
+  unsigned bits;
+  // instructions issued by each thread
+  unsigned instructions;
+  // 32-byte sectors requested by each warp
+  unsigned transactions;
+  // what prevents a wider access
+  std::string limit;
+};
+
+// Static description of the global memory accesses performed by each
+// warp. The vector width is the one chosen by the code generator;
+// addresses are only assumed adjacent within runs of `contiguous` elements.
+class memory {
+private:
+  void simulate(memory_access& acc, ir::instruction* i);
+
+public:
+  memory(align* align, layouts* layouts)
+    : align_(align), layouts_(layouts) {}
+  const std::vector<memory_access>& get_all() const { return accesses_; }
+  void run(ir::module &mod);
+
+private:
+  align* align_;
+  layouts* layouts_;
+  std::vector<memory_access> accesses_;
+};
+
+}
+}
+}
+
+#endif
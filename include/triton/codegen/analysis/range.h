@@ -0,0 +1,69 @@
+#ifndef TRITON_INCLUDE_CODEGEN_ANALYSIS_RANGE_H
+#define TRITON_INCLUDE_CODEGEN_ANALYSIS_RANGE_H
+
+#include <map>
+#include <cstdint>
+
+namespace triton {
+
+namespace ir {
+  class value;
+  class module;
+  class function;
+  class phi_node;
+  class basic_block;
+  class binary_operator;
+  class icmp_inst;
+}
+
+namespace codegen{
+namespace analysis{
+
+// Integer value-range and known-bits analysis.
+// For every integer value (scalar or block), computes:
+//   - a signed interval [lo, hi] that contains all of its elements
+//   - a number of trailing bits known to be zero
+// Loop-carried values are bounded using the conditions of the branches
+// that lead to their phi node, e.g., `k < K` for `for k in range(0, K, B)`.
+class range {
+public:
+  struct interval {
+    int64_t lo;
+    int64_t hi;
+  };
+
+private:
+  // helpers
+  interval full(ir::value* v);
+  interval refine(ir::value* v, interval x);
+  ir::value* edge_cond(ir::basic_block* pred, ir::basic_block* succ);
+  interval refine_edge(ir::value* v, ir::value* cond, interval x);
+  ir::value* upper_bound(ir::phi_node* phi);
+  bool decompose(ir::value* v, ir::value*& base, interval& off);
+  bool is_less(ir::value* lhs, ir::value* rhs);
+  // known zeros
+  unsigned compute_zeros(ir::value* v);
+  // intervals
+  interval compute_interval_binop(ir::binary_operator* x);
+  interval compute_interval_icmp(ir::icmp_inst* x);
+  interval compute_interval_phi(ir::phi_node* x);
+  interval compute_interval(ir::value* v);
+  void run(ir::function* fn);
+
+public:
+  void run(ir::module &mod);
+  interval get(ir::value* v);
+  unsigned known_zeros(ir::value* v);
+  bool is_always_true(ir::value* v);
+
+private:
+  std::map<ir::value*, interval> intervals_;
+  std::map<ir::value*, unsigned> zeros_;
+  std::map<ir::phi_node*, ir::value*> upper_;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef TRITON_INCLUDE_CODEGEN_ANALYSIS_REGISTERS_H
+#define TRITON_INCLUDE_CODEGEN_ANALYSIS_REGISTERS_H
+
+#include <map>
+#include <set>
+
+namespace triton {
+
+namespace ir {
+  class value;
+  class module;
+  class function;
+  class basic_block;
+}
+
+namespace codegen{
+namespace analysis{
+
+class layouts;
+
+// Static estimate of the number of 32-bit registers held by each thread.
+// Block values are distributed according to their layout; values that
+// live in shared memory do not use registers. The peak is taken over
+// all program points of the number of registers of live values.
+class registers {
+private:
+  void live_out(ir::function* fn, std::map<ir::basic_block*, std::set<ir::value*>>& result);
+  void run(ir::function* fn);
+
+public:
+  registers(layouts* layouts, int num_warps)
+    : layouts_(layouts), num_warps_(num_warps) {}
+  void run(ir::module &mod);
+  unsigned get(ir::value* v);
+  unsigned get_max_live() const { return max_live_; }
+
+private:
+  layouts* layouts_;
+  int num_warps_;
+  std::map<ir::value*, unsigned> regs_;
+  unsigned max_live_;
+};
+
+}
+}
+}
+
+#endif
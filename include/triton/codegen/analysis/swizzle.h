@@ -16,6 +16,7 @@ namespace analysis{
 
 class layouts;
 class data_layout;
+class shared_layout;
 
 class swizzle {
 public:
@@ -25,8 +26,12 @@ public:
   int get_per_phase(data_layout* layout) { return per_phase_.at(layout); }
   int get_max_phase(data_layout* layout) { return max_phase_.at(layout); }
   int get_vec  (data_layout* layout)     { return vec_.at(layout); }
+  bool has(data_layout* layout)          { return vec_.find(layout) != vec_.end(); }
   // run
   void run(ir::module &mod);
+private:
+  void search(shared_layout* layout);
+
 private:
   layouts* layouts_;
   target* tgt_;
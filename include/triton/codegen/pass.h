@@ -3,6 +3,9 @@
 
 
 #include <memory>
+#include <vector>
+#include "triton/codegen/analysis/bank_conflicts.h"
+#include "triton/codegen/analysis/memory.h"
 
 namespace llvm{
   class Module;
@@ -28,12 +31,20 @@ namespace driver{
 namespace triton{
 namespace codegen{
 
+// static analysis results gathered while compiling
+struct compile_report {
+  std::vector<analysis::bank_access> bank_conflicts;
+  std::vector<analysis::memory_access> memory_accesses;
+};
+
 // TODO:
 // There should be a proper pass manager there!
 std::unique_ptr<llvm::Module> add_passes_to_emit_bin(ir::module &ir, llvm::LLVMContext& ctx,
                                                      codegen::target* target,
                                                      int sm, int num_warps,
-                                                     int num_stages, int &shared_static);
+                                                     int num_stages, int num_unroll, int &shared_static,
+                                                     int &num_regs, bool estimate_only = false,
+                                                     compile_report* report = nullptr);
 
 
 }
@@ -24,12 +24,14 @@ namespace llvm{
   class IRBuilder;
   class ArrayType;
   class Function;
+  class MDNode;
 }
 
 namespace triton{
 
 namespace ir{
 class attribute;
+class argument;
 class load_inst;
 class store_inst;
 }
@@ -110,6 +112,9 @@ private:
   void finalize_shared_layout(analysis::shared_layout*);
   void finalize_function(ir::function*);
   void finalize_phi_node(ir::phi_node*);
+  void set_alias_scope(Instruction* i, ir::value* ptr);
+  std::vector<Value*> flatten(ir::value* v);
+  Function* get_device_function(ir::function* fn);
 
 private:
   Type *cvt(ir::type *ty);
@@ -134,6 +139,7 @@ public:
   std::tuple<Value*, Value*, Value*, Value*> fp32x4_to_fp8x4(Value *in0, Value *in1, Value *in2, Value *in3);
   std::tuple<Value*, Value*, Value*, Value*> fp8x4_to_fp16x4(Value *in0, Value *in1, Value *in2, Value *in3);
   std::tuple<Value*, Value*, Value*, Value*> fp16x4_to_fp8x4(Value *in0, Value *in1, Value *in2, Value *in3);
+  std::tuple<Value*, Value*, Value*, Value*> int8x4_to_fp16x4(Value *in0, Value *in1, Value *in2, Value *in3);
   Value* bf16_to_fp32(Value *in0);
   Value* fp32_to_bf16(Value *in0);
 
@@ -141,6 +147,9 @@ public:
   void visit_return_inst(ir::return_inst*);
   void visit_cond_branch_inst(ir::cond_branch_inst*);
   void visit_uncond_branch_inst(ir::uncond_branch_inst*);
+  void visit_call_inst(ir::call_inst*);
+  void visit_extract_value_inst(ir::extract_value_inst*);
+  void visit_insert_value_inst(ir::insert_value_inst*);
   void visit_load_inst(ir::load_inst*);
   void visit_unmasked_load_inst(ir::unmasked_load_inst*);
   void visit_masked_load_inst(ir::masked_load_inst*);
@@ -168,9 +177,12 @@ public:
   void visit_trans_inst(ir::trans_inst*);
   void visit_sqrt_inst(ir::sqrt_inst*);
   Value* shfl_sync(Value* acc, int32_t i);
+  Value* shfl_up(Value* acc, int32_t i);
   void visit_reduce1d_inst(ir::reduce_inst*, std::function<Value*(Value*,Value*)>, Value*);
   void visit_reducend_inst(ir::reduce_inst*, std::function<Value*(Value*,Value*)>, Value*);
   void visit_reduce_inst(ir::reduce_inst*);
+  void visit_sort_inst(ir::sort_inst*);
+  void visit_scan_inst(ir::scan_inst*);
   void visit_select_inst(ir::select_inst*);
   void visit_layout_convert(ir::value *out, ir::value *in);
   void visit_cvt_layout_inst(ir::cvt_layout_inst*);
@@ -232,6 +244,10 @@ private:
   std::map<ir::value*, Value*> shoffs_;
   std::map<ir::value*, std::vector<indices_t>> idxs_;
   std::map<ir::value*, std::map<indices_t, Value*>> vals_;
+  /// flattened elements of aggregate values
+  std::map<ir::value*, std::vector<std::vector<Value*>>> structs_;
+  /// device functions
+  std::map<ir::function*, Function*> fns_;
   /// idx for multi-stage pipeline
   std::map<analysis::data_layout*, Value*> read_smem_idx_;
   std::map<analysis::data_layout*, Value*> write_smem_idx_;
@@ -245,6 +261,10 @@ private:
   multiplier mul;
   geper gep;
 
+  /// pointer arguments declared read-only / alias scopes of noalias arguments
+  std::set<ir::argument*> readonly_args_;
+  std::map<ir::argument*, llvm::MDNode*> alias_scopes_;
+
   /// PHI nodes
   std::vector<std::tuple<llvm::PHINode*, Value*, ir::basic_block*>> lazy_phi_incs_;
 
@@ -12,6 +12,7 @@ namespace ir {
   class value;
   class io_inst;
   class instruction;
+  class cvt_layout_inst;
   class builder;
 }
 
@@ -29,11 +30,17 @@ class coalesce {
 private:
   void extract_io_use(ir::value *v, std::set<ir::io_inst*>& result);
   void extract_ld(ir::io_inst *i, std::map<int, std::vector<triton::ir::io_inst *> > &result);
+  bool is_rematerializable(ir::value *v, std::map<ir::value*, bool>& memo);
   ir::value* rematerialize(ir::value *v, ir::builder& builder, std::map<ir::value*, ir::value*>& seen);
+  int hoist_cost(ir::value* v, std::map<ir::value*, int>& costs, std::map<ir::value*, bool>& memo);
+  ir::value* hoist(ir::value* v, ir::builder& builder, std::map<ir::value*, ir::value*>& seen,
+                   std::map<ir::value*, int>& costs, std::map<ir::value*, bool>& memo);
+  bool hoist(ir::cvt_layout_inst* cvt, ir::builder& builder);
+  bool sink(ir::instruction* i, ir::builder& builder);
+  void simplify(ir::module &mod);
 
 public:
   coalesce(analysis::align* align, triton::codegen::analysis::layouts *layouts);
-  triton::ir::value *simplify(ir::instruction* i, triton::ir::builder &builder);
   void run(ir::module &mod);
 
 private:
@@ -0,0 +1,47 @@
+#ifndef TRITON_INCLUDE_IR_CODEGEN_INLINE_H
+#define TRITON_INCLUDE_IR_CODEGEN_INLINE_H
+
+#include <map>
+
+// forward declaration
+namespace triton {
+namespace ir {
+class module;
+class function;
+class call_inst;
+class builder;
+}
+} // namespace triton
+
+namespace triton {
+namespace codegen {
+namespace transform {
+
+// Inlines calls to device functions. A call site is kept when
+//  - the callee is element-wise code that neither touches memory nor
+//    synchronizes, so that it needs no shared memory of its own
+//  - the callee is called from more than one site
+//  - the callee has more than `threshold` instructions
+//  - the callee has a single return
+// The values returned on each path of an inlined callee are merged with phi
+// nodes. Device functions that are no longer called are removed.
+class inliner {
+private:
+  bool can_call(ir::function* fn);
+  bool should_inline(ir::call_inst* call, const std::map<ir::function*, int>& num_calls);
+  void do_inline(ir::call_inst* call, ir::builder& builder);
+
+public:
+  inliner(int threshold = 32): threshold_(threshold) {}
+  void run(ir::module &mod);
+
+private:
+  int threshold_;
+  std::map<ir::function*, bool> can_call_;
+};
+
+} // namespace transform
+} // namespace codegen
+} // namespace triton
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef TRITON_INCLUDE_IR_CODEGEN_PERSISTENT_H
+#define TRITON_INCLUDE_IR_CODEGEN_PERSISTENT_H
+
+#include <set>
+
+// forward declaration
+namespace triton {
+namespace ir {
+class module;
+class function;
+class instruction;
+class basic_block;
+}
+} // namespace triton
+
+namespace triton {
+namespace codegen {
+namespace transform {
+
+// Turns kernels whose arguments carry the `num_programs` attribute into
+// persistent kernels. The body is wrapped in a loop that strides over
+// the virtual grid given by these arguments with the programs that were
+// actually launched:
+//  - `get_program_id` is replaced by the coordinates of the current tile
+//  - `get_num_programs` is replaced by the size of the virtual grid
+//  - pure instructions of the entry block that do not depend on the tile
+//    are hoisted out of the loop
+class persistent {
+private:
+  bool is_invariant(ir::instruction* i, const std::set<ir::basic_block*>& loop);
+  void run(ir::function* fn);
+
+public:
+  persistent() {}
+  void run(ir::module &mod);
+};
+
+} // namespace transform
+} // namespace codegen
+} // namespace triton
+
+#endif
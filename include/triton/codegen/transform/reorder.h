@@ -1,20 +1,41 @@
 #ifndef TRITON_INCLUDE_IR_CODEGEN_REORDER_H
 #define TRITON_INCLUDE_IR_CODEGEN_REORDER_H
 
+#include <vector>
+
 namespace triton {
 
 // forward declaration
 namespace ir {
 class module;
+class value;
+class instruction;
+class basic_block;
 }
 
 namespace codegen{
 
 namespace transform{
 
+// Schedules global loads as early as possible in their basic block,
+// i.e., right after the definition of their last operand, so that
+// memory latency can be overlapped with subsequent arithmetic.
+// Loads are not moved if doing so would make the estimated number of
+// live registers per thread exceed `max_regs`.
 class reorder {
+private:
+  unsigned num_regs(ir::value* v);
+  std::vector<unsigned> pressure(const std::vector<ir::instruction*>& insts, ir::basic_block* block);
+  void hoist(ir::instruction* ld, ir::basic_block* block, ir::module& mod);
+
 public:
+  reorder(int num_warps, int max_regs = 192)
+    : num_warps_(num_warps), max_regs_(max_regs) {}
   void run(ir::module& module);
+
+private:
+  int num_warps_;
+  int max_regs_;
 };
 
 }
@@ -0,0 +1,42 @@
+#ifndef TRITON_INCLUDE_IR_CODEGEN_STRENGTH_REDUCE_H
+#define TRITON_INCLUDE_IR_CODEGEN_STRENGTH_REDUCE_H
+
+#include <utility>
+
+// forward declaration
+namespace triton {
+namespace ir {
+class module;
+class value;
+class phi_node;
+class builder;
+}
+} // namespace triton
+
+namespace triton {
+namespace codegen {
+namespace transform {
+
+// Rewrites block pointer induction variables of the form
+//   p = phi [gep(splat(base), offs), pre], [gep(p, splat(stride)), latch]
+// into a scalar pointer induction variable
+//   b = phi [base, pre], [gep(b, stride), latch]
+//   p = gep(splat(b), offs)
+// so that the per-element offsets are computed once, outside of the loop.
+class strength_reduce {
+private:
+  bool decompose(ir::value *ptr, ir::builder &builder,
+                 std::pair<ir::value*, ir::value*> &result);
+  bool get_stride(ir::value *v, ir::phi_node *phi, ir::value *&stride);
+  bool rewrite(ir::phi_node *phi, ir::builder &builder);
+
+public:
+  strength_reduce() {}
+  void run(ir::module &mod);
+};
+
+} // namespace transform
+} // namespace codegen
+} // namespace triton
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef TRITON_INCLUDE_IR_CODEGEN_UNMASK_H
+#define TRITON_INCLUDE_IR_CODEGEN_UNMASK_H
+
+// forward declaration
+namespace triton {
+namespace ir {
+class module;
+class value;
+}
+} // namespace triton
+
+namespace triton {
+namespace codegen {
+
+namespace analysis{
+class range;
+}
+
+namespace transform {
+
+// Removes the parts of load/store masks that are provably all-true,
+// and replaces masked loads/stores by unmasked ones when nothing is left.
+class unmask {
+private:
+  ir::value* simplify(ir::value* mask);
+
+public:
+  unmask(analysis::range* range): range_(range) {}
+  void run(ir::module &mod);
+
+private:
+  analysis::range* range_;
+};
+
+} // namespace transform
+} // namespace codegen
+} // namespace triton
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef TRITON_INCLUDE_IR_CODEGEN_UNROLL_H
+#define TRITON_INCLUDE_IR_CODEGEN_UNROLL_H
+
+#include <map>
+#include <vector>
+#include <cstdint>
+
+// forward declaration
+namespace triton {
+namespace ir {
+class module;
+class value;
+class instruction;
+class phi_node;
+class basic_block;
+class builder;
+}
+} // namespace triton
+
+namespace triton {
+namespace codegen {
+namespace transform {
+
+// Unrolls single-block loops with a compile-time trip count.
+//  - loops with at most `max_full_unroll` iterations are fully unrolled
+//  - other loops are unrolled by `factor`; leftover iterations are
+//    emitted after the loop
+//  - when the iteration space is not a multiple of the step, the last
+//    (partial, masked) iteration is peeled off the steady-state loop
+class unroll {
+private:
+  typedef std::map<ir::value*, ir::value*> value_map_t;
+
+  struct loop_info_t {
+    ir::basic_block* pre;
+    ir::basic_block* body;
+    ir::basic_block* exit;
+    ir::phi_node* iv;
+    int64_t start;
+    int64_t step;
+    int64_t end;
+  };
+
+private:
+  bool get_loop_info(ir::basic_block* block, loop_info_t& info);
+  int64_t get_trip_count(const loop_info_t& info);
+  value_map_t clone_body(const std::vector<ir::instruction*>& insts, const value_map_t& phis,
+                         ir::builder& builder);
+  value_map_t next_iteration(ir::basic_block* block, const value_map_t& vmap);
+  void full_unroll(const loop_info_t& info, int64_t trip_count, ir::builder& builder);
+  void partial_unroll(const loop_info_t& info, int64_t trip_count, int64_t num_peeled,
+                      ir::builder& builder);
+
+public:
+  unroll(int factor = 1, int max_full_unroll = 4, bool peel_tail = true)
+    : factor_(factor), max_full_unroll_(max_full_unroll), peel_tail_(peel_tail) {}
+  void run(ir::module &mod);
+
+private:
+  int factor_;
+  int max_full_unroll_;
+  bool peel_tail_;
+};
+
+} // namespace transform
+} // namespace codegen
+} // namespace triton
+
+#endif
@@ -27,7 +27,7 @@ public:
 
 private:
   // constructors
-  basic_block(context &ctx, const std::string &name, function *parent);
+  basic_block(context &ctx, const std::string &name, function *parent, basic_block *next);
 
 public:
   // accessors
@@ -64,9 +64,10 @@ public:
   const std::vector<basic_block*>& get_predecessors() const { return preds_; }
   const std::vector<basic_block*>& get_successors() const { return succs_; }
   void add_predecessor(basic_block* pred);
+  void remove_predecessor(basic_block* pred);
 
   // factory functions
-  static basic_block* create(context &ctx, const std::string &name, function *parent);
+  static basic_block* create(context &ctx, const std::string &name, function *parent, basic_block *next = nullptr);
 
   void print(std::ostream &os);
 
@@ -67,6 +67,11 @@ public:
   value* create_br(basic_block *dest);
   value* create_cond_br(value *cond, basic_block* if_dest, basic_block* else_dest);
   value* create_ret_void();
+  value* create_ret(value *ret);
+  // Calls
+  value* create_call(function *fn, const std::vector<value*> &args);
+  value* create_extract_value(value *agg, unsigned idx);
+  value* create_insert_value(value *agg, value *val, unsigned idx);
   // Cast instructions
   value *create_cast(cast_op_t op, value *v, type *dst_ty);
   value* create_ptr_to_int(value *src, type *dst_ty);
@@ -152,6 +157,8 @@ public:
   value *create_trans(value *A, const std::vector<int> &perm = {});
   value *create_sqrt(value *A);
   value *create_reduce(value *A, reduce_inst::op_t op, unsigned axis);
+  value *create_sort(value *A, unsigned k);
+  value *create_scan(value *A, scan_inst::op_t op, unsigned axis);
   value *create_select(value *pred, value *if_value, value *else_value);
   // Intrinsics
   // These have no place in the IR, and hopefully they can be removed at some point
@@ -74,7 +74,8 @@ private:
 class global_value: public constant {
 public:
   enum linkage_types_t {
-    external
+    external,
+    internal
   };
 
 public:
@@ -82,6 +83,8 @@ public:
                linkage_types_t linkage, const std::string &name,
                unsigned addr_space);
   std::string repr() const { return get_name(); }
+  linkage_types_t get_linkage() const { return linkage_; }
+  void set_linkage(linkage_types_t linkage) { linkage_ = linkage; }
 
 private:
   linkage_types_t linkage_;
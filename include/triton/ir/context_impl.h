@@ -32,6 +32,8 @@ public:
   std::map<std::pair<type*, unsigned>, pointer_type*> ptr_tys;
   // Block types
   std::map<std::pair<type*, type::block_shapes_t>, block_type*> block_tys;
+  // Struct types
+  std::map<std::vector<type*>, struct_type*> struct_tys;
 
   // Int constants
   std::map<std::pair<type*, uint64_t>, constant_int*> int_constants_;
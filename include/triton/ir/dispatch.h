@@ -89,6 +89,18 @@ struct dispatch{
   static ir::value *min(ir::value *input, unsigned int axis, ir::builder *builder);
   static ir::value *max(ir::value *input, unsigned int axis, ir::builder *builder);
   static ir::value *sum(ir::value *input, unsigned int axis, ir::builder *builder);
+  static ir::value *argmin(ir::value *input, unsigned int axis, ir::builder *builder);
+  static ir::value *argmax(ir::value *input, unsigned int axis, ir::builder *builder);
+  static std::tuple<ir::value*, ir::value*> min_with_index(ir::value *input, unsigned int axis, ir::builder *builder);
+  static std::tuple<ir::value*, ir::value*> max_with_index(ir::value *input, unsigned int axis, ir::builder *builder);
+
+  // scans
+  static ir::value *cumsum(ir::value *input, unsigned int axis, ir::builder *builder);
+  static ir::value *cumprod(ir::value *input, unsigned int axis, ir::builder *builder);
+
+  // sorting
+  static std::tuple<ir::value*, ir::value*> sort(ir::value *input, bool descending, ir::builder *builder);
+  static std::tuple<ir::value*, ir::value*> topk(ir::value *input, unsigned k, bool largest, ir::builder *builder);
 
   // math
   static ir::value *umulhi(ir::value *x, ir::value *y, ir::builder *builder);
@@ -123,6 +123,10 @@ enum value_id_t: unsigned {
   INST_RETURN,
   INST_COND_BRANCH,
   INST_UNCOND_BRANCH,
+  // calls
+  INST_CALL,
+  INST_EXTRACT_VALUE,
+  INST_INSERT_VALUE,
   // io
   INST_UNMASKED_LOAD,
   INST_MASKED_LOAD,
@@ -151,6 +155,8 @@ enum value_id_t: unsigned {
   // array arithmetic
   INST_TRANS,
   INST_REDUCE,
+  INST_SORT,
+  INST_SCAN,
   INST_DOT,
   // intrinsics
   INST_COPY_TO_SHARED,
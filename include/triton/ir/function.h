@@ -40,6 +40,8 @@ enum attribute_kind_t {
   noalias,
   aligned,
   multiple_of,
+  equal_to_one,
+  num_programs,
   retune,
   not_implemented
 };
@@ -62,7 +64,7 @@ public:
   }
 
   bool is_llvm_attr() const {
-    return kind_ != multiple_of;
+    return kind_ != multiple_of && kind_ != equal_to_one && kind_ != num_programs;
   }
 
   std::string repr() const {
@@ -72,6 +74,8 @@ public:
       case noalias: return ".noalias";
       case aligned: return ".aligned(" + std::to_string(value_) + ")";
       case multiple_of: return ".multipleof(" + std::to_string(value_) + ")";
+      case equal_to_one: return ".equaltoone";
+      case num_programs: return ".numprograms(" + std::to_string(value_) + ")";
       case retune: return ".retunr";
       default: break;
     }
@@ -107,6 +111,11 @@ public:
   const function_type* get_fn_type() const { return fn_ty_; }
   module *get_parent() { return parent_; }
   const module *get_parent() const { return parent_; }
+  // device functions are only visible from the module
+  bool is_kernel() const { return get_linkage() == external; }
+  // the return type of device functions is only known
+  // once their body has been generated
+  void reset_type(function_type *ty);
 
   // factory methods
   static function *create(function_type *ty, linkage_types_t linkage,
@@ -27,6 +27,7 @@ class make_range;
 class basic_block;
 class context;
 class visitor;
+class function;
 
 //===----------------------------------------------------------------------===//
 //                               instruction classes
@@ -346,6 +347,60 @@ public:
 };
 
 
+//===----------------------------------------------------------------------===//
+//                               call_inst classes
+//===----------------------------------------------------------------------===//
+
+// call to a device function of the same module
+class call_inst: public instruction {
+private:
+  std::string repr_impl() const;
+  call_inst(function *fn, const std::vector<value*> &args, const std::string &name, instruction *next);
+
+public:
+  // accessors
+  function *get_fn() { return fn_; }
+  // factory methods
+  static call_inst* create(function *fn, const std::vector<value*> &args,
+                           const std::string &name = "", instruction *next = nullptr);
+  _TRITON_DEFINE_CLONE(call_inst)
+  _TRITON_DEFINE_ACCEPT(call_inst)
+
+private:
+  function *fn_;
+};
+
+// aggregates of multiple return values
+class extract_value_inst: public instruction {
+private:
+  std::string repr_impl() const { return "extract_value(" + std::to_string(idx_) + ")"; }
+  extract_value_inst(value *agg, unsigned idx, const std::string &name, instruction *next);
+
+public:
+  unsigned get_idx() const { return idx_; }
+  static instruction* create(value *agg, unsigned idx, const std::string &name = "", instruction *next = nullptr);
+  _TRITON_DEFINE_CLONE(extract_value_inst)
+  _TRITON_DEFINE_ACCEPT(extract_value_inst)
+
+private:
+  unsigned idx_;
+};
+
+class insert_value_inst: public instruction {
+private:
+  std::string repr_impl() const { return "insert_value(" + std::to_string(idx_) + ")"; }
+  insert_value_inst(value *agg, value *val, unsigned idx, const std::string &name, instruction *next);
+
+public:
+  unsigned get_idx() const { return idx_; }
+  static instruction* create(value *agg, value *val, unsigned idx, const std::string &name = "", instruction *next = nullptr);
+  _TRITON_DEFINE_CLONE(insert_value_inst)
+  _TRITON_DEFINE_ACCEPT(insert_value_inst)
+
+private:
+  unsigned idx_;
+};
+
 //===----------------------------------------------------------------------===//
 //                               getelementptr_inst classes
 //===----------------------------------------------------------------------===//
@@ -811,6 +866,46 @@ private:
   op_t op_;
 };
 
+// sorts a block in ascending order along its last axis,
+// of which only the first `k` elements are kept
+class sort_inst: public builtin_inst {
+private:
+  static type* get_res_type(value *arg, unsigned k);
+
+private:
+  sort_inst(value *arg, unsigned k, const std::string& name, instruction* next);
+  std::string repr_impl() const { return "sort"; }
+  _TRITON_DEFINE_CLONE(sort_inst)
+  _TRITON_DEFINE_ACCEPT(sort_inst)
+
+public:
+  static instruction* create(value *arg, unsigned k, const std::string &name = "", instruction *next = nullptr);
+};
+
+// inclusive prefix scan of a block along one of its axes
+class scan_inst: public builtin_inst {
+public:
+  enum op_t{
+    ADD, MUL,
+    FADD, FMUL
+  };
+
+private:
+  scan_inst(value* arg, op_t op, unsigned axis, const std::string& name, instruction* next);
+  std::string repr_impl() const { return "scan"; }
+  _TRITON_DEFINE_CLONE(scan_inst)
+  _TRITON_DEFINE_ACCEPT(scan_inst)
+
+public:
+  static instruction* create(value *arg, op_t op, unsigned axis, const std::string &name = "", instruction *next = nullptr);
+  unsigned get_axis() const { return axis_; }
+  op_t get_op() const { return op_; }
+
+private:
+  unsigned axis_;
+  op_t op_;
+};
+
 class select_inst: public builtin_inst {
 private:
   select_inst(value *pred, value *if_value, value *else_value, const std::string& name, instruction* next);
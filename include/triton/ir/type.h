@@ -85,6 +85,7 @@ public:
   bool is_bool_ty() const               { return is_integer_ty(1); }
   bool is_pointer_ty() const            { return id_ == PointerTyID; }
   bool is_block_ty() const               { return id_ == BlockTyID; }
+  bool is_struct_ty() const             { return id_ == StructTyID; }
 
   // Composite predicates
   bool is_int_or_tileint_ty();
@@ -124,6 +125,17 @@ public:
     return res;
   }
 
+  std::string struct_repr() const {
+    std::string res = "{";
+    for(size_t i = 0; i < contained_tys_.size(); i++){
+      if(i > 0)
+        res += ", ";
+      res += contained_tys_[i]->repr();
+    }
+    res += "}";
+    return res;
+  }
+
   std::string repr() const {
     switch(id_) {
       case VoidTyID: return "void";
@@ -137,7 +149,7 @@ public:
       case IntegerTyID: return "i" + std::to_string(get_integer_bitwidth());
       case FunctionTyID: return "fn";
       case PointerTyID: return get_pointer_element_ty()->repr() + "*";
-      case StructTyID: return "struct";
+      case StructTyID: return struct_repr();
       case BlockTyID: return tile_repr();
       default: break;
     }
@@ -200,6 +212,18 @@ private:
   block_shapes_t shapes_;
 };
 
+class struct_type: public composite_type {
+private:
+  struct_type(const std::vector<type*>& tys);
+
+public:
+  // accessors
+  unsigned get_num_types() const              { return contained_tys_.size(); }
+  type* get_ty(unsigned idx) const            { return contained_tys_.at(idx); }
+  // factory methods
+  static struct_type* get(const std::vector<type*>& tys);
+};
+
 class pointer_type: public type {
 private:
   pointer_type(type *ty, unsigned address_space);
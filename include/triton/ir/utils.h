@@ -13,6 +13,7 @@ class module;
 class function;
 class basic_block;
 class instruction;
+class return_inst;
 class value;
 
 class cfg {
@@ -23,6 +24,8 @@ public:
 
 void for_each_instruction(ir::module& mod, const std::function<void(triton::ir::instruction*)> &fn);
 void for_each_value(ir::module& mod, const std::function<void(triton::ir::value *)> &fn);
+std::vector<value*> get_return_values(ir::return_inst* ret);
+std::vector<value*> get_return_values(ir::function* fn);
 
 }
 }
@@ -36,6 +36,10 @@ class return_inst;
 class cond_branch_inst;
 class uncond_branch_inst;
 
+class call_inst;
+class extract_value_inst;
+class insert_value_inst;
+
 
 class unmasked_load_inst;
 class masked_load_inst;
@@ -64,6 +68,8 @@ class dot_inst;
 class trans_inst;
 class sqrt_inst;
 class reduce_inst;
+class sort_inst;
+class scan_inst;
 class select_inst;
 
 class cvt_layout_inst;
@@ -118,6 +124,10 @@ public:
   virtual void visit_cond_branch_inst(cond_branch_inst*) = 0;
   virtual void visit_uncond_branch_inst(uncond_branch_inst*) = 0;
 
+  virtual void visit_call_inst(call_inst*) = 0;
+  virtual void visit_extract_value_inst(extract_value_inst*) = 0;
+  virtual void visit_insert_value_inst(insert_value_inst*) = 0;
+
 
   virtual void visit_unmasked_load_inst(unmasked_load_inst*) = 0;
   virtual void visit_masked_load_inst(masked_load_inst*) = 0;
@@ -144,6 +154,8 @@ public:
   virtual void visit_trans_inst(trans_inst*) = 0;
   virtual void visit_sqrt_inst(sqrt_inst*) = 0;
   virtual void visit_reduce_inst(reduce_inst*) = 0;
+  virtual void visit_sort_inst(sort_inst*) = 0;
+  virtual void visit_scan_inst(scan_inst*) = 0;
   virtual void visit_select_inst(select_inst*) = 0;
 
   virtual void visit_cvt_layout_inst(cvt_layout_inst*) = 0;
@@ -49,6 +49,21 @@ inline T add_to_cache(ir::value *i, T value, std::map<ir::value*, T> &map) {
   return map[i] = value;
 }
 
+// value returned by the device function that defines `v`, if any.
+// facts inferred in the callee hold at every call site
+static ir::value* get_returned_value(ir::value *v) {
+  ir::call_inst* call = dynamic_cast<ir::call_inst*>(v);
+  unsigned idx = 0;
+  if(auto *x = dynamic_cast<ir::extract_value_inst*>(v)){
+    call = dynamic_cast<ir::call_inst*>(x->get_operand(0));
+    idx = x->get_idx();
+  }
+  if(!call || call->get_type()->is_void_ty())
+    return nullptr;
+  std::vector<ir::value*> rets = ir::get_return_values(call->get_fn());
+  return idx < rets.size() ? rets[idx] : nullptr;
+}
+
 /*
  * is constant
  */
@@ -166,6 +181,11 @@ std::vector<align::cst_info> align::populate_is_constant_gep(ir::getelementptr_i
 std::vector<align::cst_info> align::populate_is_constant_default(ir::value *v) {
   auto shapes = get_shapes(v);
   std::vector<cst_info> result(shapes.size(), {1, 0});
+  // arguments specialized on being equal to one (e.g., unit strides)
+  if(auto *x = dynamic_cast<ir::argument*>(v))
+    for(ir::attribute attr: x->get_parent()->get_attributes(x))
+      if(attr.get_kind() == ir::equal_to_one)
+        result = {cst_info{1, 1}};
   return add_to_cache(v, result, is_constant_);
 }
 
@@ -186,6 +206,8 @@ std::vector<align::cst_info> align::populate_is_constant(ir::value *v) {
     return populate_is_constant_binop(x);
   if(auto *x = dynamic_cast<ir::getelementptr_inst*>(v))
     return populate_is_constant_gep(x);
+  if(ir::value *ret = get_returned_value(v))
+    return add_to_cache(v, populate_is_constant(ret), is_constant_);
   return populate_is_constant_default(v);
 }
 
@@ -350,6 +372,8 @@ std::vector<unsigned> align::populate_max_contiguous(ir::value *v){
     return populate_max_contiguous_gep(x);
   if(auto *x = dynamic_cast<ir::phi_node*>(v))
     return populate_max_contiguous_phi(x);
+  if(ir::value *ret = get_returned_value(v))
+    return add_to_cache(v, populate_max_contiguous(ret), max_contiguous_);
   return populate_max_contiguous_default(v);
 }
 
@@ -497,6 +521,8 @@ std::vector<unsigned> align::populate_starting_multiple(ir::value *v){
     return populate_starting_multiple_broadcast(x);
   if(auto *x = dynamic_cast<ir::phi_node*>(v))
     return populate_starting_multiple_phi(x);
+  if(ir::value *ret = get_returned_value(v))
+    return add_to_cache(v, populate_starting_multiple(ret), starting_multiple_);
   return populate_starting_multiple_default(v);
 }
 
@@ -511,6 +537,10 @@ std::vector<unsigned> align::contiguous(ir::value* v) const {
   return max_contiguous_.at(v);
 }
 
+std::vector<unsigned> align::starting_multiple(ir::value* v) const {
+  return starting_multiple_.at(v);
+}
+
 
 void align::populate(ir::value *v) {
   populate_is_constant(v);
@@ -2,6 +2,7 @@
 #include "triton/ir/utils.h"
 #include "triton/ir/instructions.h"
 #include "triton/ir/type.h"
+#include "triton/ir/function.h"
 #include <iostream>
 
 
@@ -112,9 +113,42 @@ void axes::update_graph_no_edge(ir::instruction *i) {
     graph_.add_edge({i, d}, {i, d});
 }
 
+// tiles are passed to and returned from device functions in the same
+// layout as they have in the callee, so that all call sites agree
+static void add_edges(tools::graph<std::pair<ir::value*, unsigned>>& graph, ir::value* x, ir::value* y) {
+  if(!x || !y || !x->get_type()->is_block_ty())
+    return;
+  for(unsigned d = 0; d < x->get_type()->get_tile_rank(); d++)
+    graph.add_edge({x, d}, {y, d});
+}
+
+void axes::update_graph_call(ir::instruction *i) {
+  auto* call = static_cast<ir::call_inst*>(i);
+  ir::function* fn = call->get_fn();
+  for(unsigned k = 0; k < call->get_num_operands(); k++)
+    add_edges(graph_, call->get_operand(k), fn->args()[k]);
+  if(!call->get_type()->is_struct_ty())
+  for(ir::value* ret: ir::get_return_values(fn))
+    add_edges(graph_, call, ret);
+  update_graph_no_edge(i);
+}
+
+void axes::update_graph_extract_value(ir::instruction *i) {
+  auto* x = static_cast<ir::extract_value_inst*>(i);
+  auto* call = dynamic_cast<ir::call_inst*>(x->get_operand(0));
+  if(!call){
+    update_graph_no_edge(i);
+    return;
+  }
+  std::vector<ir::value*> rets = ir::get_return_values(call->get_fn());
+  add_edges(graph_, x, rets.at(x->get_idx()));
+  update_graph_no_edge(i);
+}
+
 void axes::update_graph(ir::instruction *i) {
   switch (i->get_id()) {
     case ir::INST_REDUCE:            return update_graph_reduce(i);
+    case ir::INST_SORT:              return update_graph_no_edge(i);
     case ir::INST_RESHAPE:           return update_graph_reshape(i);
     case ir::INST_SPLAT:             return update_graph_no_edge(i);
     case ir::INST_CAT:               return update_graph_elementwise(i, true);
@@ -125,6 +159,9 @@ void axes::update_graph(ir::instruction *i) {
     case ir::INST_MASKED_LOAD_ASYNC: return update_graph_elementwise(i, true);
     case ir::INST_COPY_FROM_SHARED:  return update_graph_no_edge(i);
     case ir::INST_CVT_LAYOUT:        return update_graph_no_edge(i);
+    case ir::INST_CALL:              return update_graph_call(i);
+    case ir::INST_EXTRACT_VALUE:     return update_graph_extract_value(i);
+    case ir::INST_INSERT_VALUE:      return;
     default:                         return update_graph_elementwise(i);
   }
   return;
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <set>
+#include "triton/codegen/analysis/bank_conflicts.h"
+#include "triton/codegen/analysis/layout.h"
+#include "triton/codegen/analysis/swizzle.h"
+#include "triton/codegen/target.h"
+#include "triton/ir/module.h"
+#include "triton/ir/instructions.h"
+#include "triton/ir/type.h"
+
+namespace triton{
+namespace codegen{
+namespace analysis{
+
+// offset (in elements) of the logical element (s, c) of a shared buffer
+// whose leading dimension has `ld` elements. This is the same mapping as
+// the one used by the code generator for both reads and writes
+static int swizzled_offset(int s, int c, int ld, int per_phase, int max_phase, int vec) {
+  int phase = (s / per_phase) % max_phase;
+  return s*ld + ((c / vec) ^ phase)*vec + c % vec;
+}
+
+// a warp-wide access in which each thread reads or writes `width`
+// contiguous bytes is served 128 bytes at a time; threads of the same
+// wavefront that touch different words of the same bank conflict
+static void add_wavefronts(const std::vector<int>& addrs, int width, bank_access& acc) {
+  size_t lanes = std::min(32, 128 / std::max(width, 4));
+  for(size_t i = 0; i < addrs.size(); i += lanes){
+    std::map<int, std::set<int>> banks;
+    for(size_t j = i; j < std::min(addrs.size(), i + lanes); j++)
+    for(int word = addrs[j] / 4; word <= (addrs[j] + width - 1) / 4; word++)
+      banks[word % 32].insert(word);
+    unsigned ways = 1;
+    for(auto& x: banks)
+      ways = std::max<unsigned>(ways, x.second.size());
+    acc.wavefronts += ways;
+    acc.phases += 1;
+    acc.max_ways = std::max(acc.max_ways, ways);
+  }
+}
+
+// stores of a distributed tile into shared memory
+static bool simulate_write(ir::value* arg, shared_layout* layout, layouts* l,
+                           int per_phase, int max_phase, int vec, bank_access& acc) {
+  scanline_layout* in_layout = l->get(arg)->to_scanline();
+  if(!in_layout)
+    return false;
+  auto in_order = in_layout->get_order();
+  auto out_order = layout->get_order();
+  auto shape = layout->get_shape();
+  int dtsize = layout->get_type()->get_scalar_ty()->get_primitive_size_in_bits() / 8;
+  int in_vec = (in_order == out_order) ? in_layout->nts(in_order[0]) : 1;
+  int min_vec = std::min(vec, in_vec);
+  int ld = shape[out_order[0]];
+  int num_threads = in_layout->get_num_threads();
+  std::vector<std::vector<std::vector<int>>> elts(num_threads);
+  for(int tid = 0; tid < num_threads; tid++)
+    elts[tid] = in_layout->get_elements(tid);
+  // one warp-wide store per vector of each thread
+  for(int warp = 0; warp < num_threads / 32; warp++)
+  for(size_t n = 0; n < elts[0].size(); n += min_vec){
+    std::vector<int> addrs;
+    for(int lane = 0; lane < 32; lane++){
+      const std::vector<int>& idx = elts[warp*32 + lane].at(n);
+      int off = swizzled_offset(idx[out_order[1]], idx[out_order[0]], ld, per_phase, max_phase, vec);
+      addrs.push_back(off*dtsize);
+    }
+    add_wavefronts(addrs, min_vec*dtsize, acc);
+  }
+  return true;
+}
+
+// ldmatrix: every 8x8 matrix of the operand is read by 8 threads,
+// each of which loads 16 contiguous bytes
+static void simulate_ldmatrix(shared_layout* layout, int per_phase, int max_phase, int vec, bank_access& acc) {
+  auto order = layout->get_order();
+  auto shape = layout->get_shape();
+  int dtsize = layout->get_type()->get_scalar_ty()->get_primitive_size_in_bits() / 8;
+  int row = 16 / dtsize;
+  int ld = shape[order[0]];
+  for(int s = 0; s < (int)shape[order[1]]; s += 8)
+  for(int c = 0; c < (int)shape[order[0]]; c += row){
+    std::vector<int> addrs;
+    for(int r = 0; r < 8; r++)
+      addrs.push_back(swizzled_offset(s + r, c, ld, per_phase, max_phase, vec)*dtsize);
+    add_wavefronts(addrs, 16, acc);
+  }
+}
+
+std::vector<bank_access> bank_conflicts::simulate(shared_layout* layout, layouts* l, target* tgt,
+                                                  int per_phase, int max_phase, int vec) {
+  std::vector<bank_access> result;
+  if(layout->get_rank() != 2 || per_phase <= 0 || max_phase <= 0 || vec <= 0)
+    return result;
+  // writes
+  std::set<ir::value*> seen;
+  for(ir::value* v: layout->get_values()){
+    if(!seen.insert(v).second)
+      continue;
+    ir::value* arg = nullptr;
+    if(auto* cts = dynamic_cast<ir::copy_to_shared_inst*>(v))
+      arg = cts->get_operand(0);
+    if(auto* ld = dynamic_cast<ir::masked_load_async_inst*>(v))
+      arg = ld->get_pointer_operand();
+    if(!arg || !l->has(arg))
+      continue;
+    bank_access acc = {(ir::instruction*)v, true, 0, 0, 0};
+    if(simulate_write(arg, layout, l, per_phase, max_phase, vec, acc))
+      result.push_back(acc);
+  }
+  // reads
+  bool has_ldmatrix = tgt->as_nvidia() && tgt->as_nvidia()->sm() >= 80;
+  for(ir::value* dot: {layout->hmma_dot_a(), layout->hmma_dot_b()}){
+    if(!dot || !has_ldmatrix)
+      continue;
+    bank_access acc = {(ir::instruction*)dot, false, 0, 0, 0};
+    simulate_ldmatrix(layout, per_phase, max_phase, vec, acc);
+    result.push_back(acc);
+  }
+  return result;
+}
+
+void bank_conflicts::run(ir::module &) {
+  accesses_.clear();
+  for(auto &x: layouts_->get_all()){
+    shared_layout* layout = dynamic_cast<shared_layout*>(x.second);
+    if(!layout || !swizzle_->has(layout))
+      continue;
+    accesses_[layout] = simulate(layout, layouts_, tgt_, swizzle_->get_per_phase(layout),
+                                 swizzle_->get_max_phase(layout), swizzle_->get_vec(layout));
+  }
+}
+
+}
+}
+}
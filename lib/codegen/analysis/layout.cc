@@ -235,6 +235,42 @@ scanline_layout::scanline_layout(size_t num_warps,
     shape_per_cta_[d] = mts_[d]*nts_[d];
 }
 
+int scanline_layout::get_num_threads() {
+  int ret = std::accumulate(mts_.begin(), mts_.end(), 1, std::multiplies<int>());
+  return (ret + 31) / 32 * 32;
+}
+
+std::vector<std::vector<int>> scanline_layout::get_elements(int tid) {
+  size_t rank = shape_.size();
+  // thread coordinates
+  std::vector<int> tid_k(rank);
+  for(size_t d = 0; d < rank - 1; d++){
+    tid_k[order_[d]] = tid % mts_[order_[d]];
+    tid /= mts_[order_[d]];
+  }
+  tid_k[order_[rank - 1]] = tid;
+  // element coordinates along each axis
+  std::vector<std::vector<int>> axes(rank);
+  for(size_t k = 0; k < rank; k++){
+    int per_thread = std::max<int>(nts_[k] * shape_[k] / shape_per_cta_[k], 1);
+    for(int n = 0; n < per_thread; n++)
+      axes[k].push_back((tid_k[k]*nts_[k] + n/nts_[k]*shape_per_cta_[k] + n%nts_[k]) % shape_[k]);
+  }
+  // cartesian product, fastest along order[0]
+  std::vector<std::vector<int>> ret = {{}};
+  ret[0].resize(rank);
+  for(size_t d = 0; d < rank; d++){
+    std::vector<std::vector<int>> next;
+    for(int x: axes[order_[d]])
+    for(const std::vector<int>& idx: ret){
+      next.push_back(idx);
+      next.back()[order_[d]] = x;
+    }
+    ret = next;
+  }
+  return ret;
+}
+
 
 /* -------------------------------- *
  *          Shared Layout           *
@@ -449,6 +485,19 @@ void layouts::make_graph(ir::instruction *i) {
     connect(i, opx);
     connect(opx, opy);
   }
+  // device functions see their arguments and return values
+  // in the layouts of their call sites
+  if(auto* call = dynamic_cast<ir::call_inst*>(i)){
+    for(size_t k = 0; k < call->get_num_operands(); k++)
+      connect(call->get_operand(k), call->get_fn()->args()[k]);
+    if(!call->get_type()->is_struct_ty())
+    for(ir::value* ret: ir::get_return_values(call->get_fn()))
+      connect(call, ret);
+  }
+  if(auto* x = dynamic_cast<ir::extract_value_inst*>(i))
+  if(auto* call = dynamic_cast<ir::call_inst*>(x->get_operand(0)))
+  if(ir::value* ret = ir::get_return_values(call->get_fn()).at(x->get_idx()))
+    connect(x, ret);
 }
 
 void layouts::create(size_t id, const std::vector<ir::value*>& values) {
@@ -522,6 +571,21 @@ void layouts::run(ir::module &mod) {
       layouts_[id] = new shared_layout(layout, axes_->get(arg), shapes, {red}, red->get_type()->get_scalar_ty(), align_);
       tmp_[red] = id;
     }
+    if(auto *sort = dynamic_cast<ir::sort_inst*>(i)){
+      // the whole block is sorted in shared memory
+      id++;
+      ir::value *arg = sort->get_operand(0);
+      layouts_[id] = new shared_layout(get(arg), axes_->get(arg), arg->get_type()->get_block_shapes(), {sort}, sort->get_type()->get_scalar_ty(), align_);
+      tmp_[sort] = id;
+    }
+    if(auto *scan = dynamic_cast<ir::scan_inst*>(i)){
+      // the block, with rows along the scanned axis made contiguous,
+      // followed by the totals of up to 32 warps
+      id++;
+      unsigned size = scan->get_type()->get_tile_num_elements() + 32;
+      layouts_[id] = new shared_layout(nullptr, {}, {size}, {scan}, scan->get_type()->get_scalar_ty(), align_);
+      tmp_[scan] = id;
+    }
     if(auto *val = dynamic_cast<ir::cvt_layout_inst*>(i)){
       distributed_layout* out_layout = dynamic_cast<distributed_layout*>(get(val));
       distributed_layout* in_layout = dynamic_cast<distributed_layout*>(get(i->get_operand(0)));
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <map>
+#include <set>
+#include "triton/codegen/analysis/memory.h"
+#include "triton/codegen/analysis/align.h"
+#include "triton/codegen/analysis/layout.h"
+#include "triton/ir/module.h"
+#include "triton/ir/instructions.h"
+#include "triton/ir/utils.h"
+
+namespace triton{
+namespace codegen{
+namespace analysis{
+
+// counts the distinct 32-byte sectors touched by each warp-wide
+// instruction. Elements of the leading dimension are only known to be
+// adjacent in memory within runs of `contiguous` elements, so each run
+// is considered to start a new, sector-aligned segment
+void memory::simulate(memory_access& acc, ir::instruction* i) {
+  ir::value* ptr = static_cast<ir::io_inst*>(i)->get_pointer_operand();
+  scanline_layout* layout = layouts_->get(ptr)->to_scanline();
+  int ld = layout->get_order(0);
+  int dtsize = std::max<int>(acc.bits / acc.vec / 8, 1);
+  int num_threads = layout->get_num_threads();
+  std::vector<std::vector<std::vector<int>>> elts(num_threads);
+  for(int tid = 0; tid < num_threads; tid++)
+    elts[tid] = layout->get_elements(tid);
+  acc.instructions = elts[0].size() / acc.vec;
+  unsigned total = 0;
+  for(int warp = 0; warp < num_threads / 32; warp++)
+  for(size_t n = 0; n < elts[0].size(); n += acc.vec){
+    std::set<std::pair<std::vector<int>, int>> sectors;
+    for(int lane = 0; lane < 32; lane++){
+      std::vector<int> segment = elts[warp*32 + lane].at(n);
+      int start = segment[ld] % acc.contiguous * dtsize;
+      segment[ld] /= acc.contiguous;
+      for(int s = start / 32; s <= (start + acc.vec*dtsize - 1) / 32; s++)
+        sectors.insert({segment, s});
+    }
+    total += sectors.size();
+  }
+  acc.transactions = total / (num_threads / 32);
+}
+
+void memory::run(ir::module &mod) {
+  accesses_.clear();
+  ir::for_each_instruction(mod, [&](ir::instruction* i){
+    bool is_load = dynamic_cast<ir::load_inst*>(i);
+    bool is_store = dynamic_cast<ir::store_inst*>(i);
+    bool is_atomic = dynamic_cast<ir::atomic_rmw_inst*>(i);
+    if(!is_load && !is_store && !is_atomic)
+      return;
+    ir::value* ptr = static_cast<ir::io_inst*>(i)->get_pointer_operand();
+    ir::type* ty = ptr->get_type();
+    memory_access acc;
+    acc.inst = i;
+    acc.is_masked = dynamic_cast<ir::masked_load_inst*>(i) || dynamic_cast<ir::masked_store_inst*>(i) ||
+                    dynamic_cast<ir::masked_load_async_inst*>(i) || is_atomic;
+    acc.contiguous = acc.alignment = acc.nts = acc.vec = 1;
+    acc.bits = ty->get_scalar_ty()->get_pointer_element_ty()->get_primitive_size_in_bits();
+    acc.instructions = acc.transactions = 1;
+    acc.limit = "scalar";
+    if(!ty->is_block_ty()){
+      accesses_.push_back(acc);
+      return;
+    }
+    acc.instructions = acc.transactions = 0;
+    int ld = layouts_->get(ptr)->get_order(0);
+    scanline_layout* layout = layouts_->get(ptr)->to_scanline();
+    acc.contiguous = align_->contiguous(ptr)[ld];
+    acc.alignment = align_->starting_multiple(ptr)[ld];
+    acc.nts = layout ? layout->nts(ld) : 1;
+    unsigned aln = align_->get(ptr, ld);
+    // mirrors the vector width selection of the code generator
+    unsigned max_vec = std::min(acc.nts, aln);
+    if(auto* x = dynamic_cast<ir::masked_load_async_inst*>(i)){
+      bool same_order = layouts_->get(x)->get_order() == layouts_->get(ptr)->get_order();
+      max_vec = same_order ? acc.nts : 1;
+    }
+    acc.vec = max_vec;
+    if(is_atomic)
+      acc.vec = std::min<unsigned>(acc.vec, i->get_type()->get_scalar_ty()->is_fp16_ty() ? 2 : 1);
+    if(!layout)
+      acc.limit = "layout";
+    else if(acc.vec < max_vec)
+      acc.limit = "atomic";
+    else if(acc.vec < acc.nts)
+      acc.limit = dynamic_cast<ir::masked_load_async_inst*>(i) ? "layout" :
+                  acc.contiguous < acc.nts ? "contiguity" : "alignment";
+    else if(acc.vec*acc.bits < 128)
+      acc.limit = "nts";
+    else
+      acc.limit = "none";
+    acc.bits *= acc.vec;
+    if(layout)
+      simulate(acc, i);
+    accesses_.push_back(acc);
+  });
+}
+
+}
+}
+}
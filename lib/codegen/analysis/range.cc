@@ -0,0 +1,538 @@
+#include <algorithm>
+#include <climits>
+#include <vector>
+#include "triton/codegen/analysis/range.h"
+#include "triton/ir/module.h"
+#include "triton/ir/function.h"
+#include "triton/ir/basic_block.h"
+#include "triton/ir/instructions.h"
+#include "triton/ir/constant.h"
+#include "triton/ir/utils.h"
+
+namespace triton {
+namespace codegen{
+namespace analysis{
+
+/*
+ * helpers
+ */
+
+inline bool is_int(ir::value* v) {
+  return v->get_type()->get_scalar_ty()->is_integer_ty();
+}
+
+inline unsigned bitwidth(ir::value* v) {
+  return v->get_type()->get_scalar_ty()->get_integer_bitwidth();
+}
+
+inline int64_t get_signed(ir::constant_int* x) {
+  unsigned bw = x->get_type()->get_integer_bitwidth();
+  uint64_t value = x->get_value();
+  if(bw == 1)
+    return value & 1;
+  if(bw >= 64)
+    return (int64_t)value;
+  return (int64_t)(value << (64 - bw)) >> (64 - bw);
+}
+
+inline unsigned ctz(int64_t x, unsigned bw) {
+  if(x == 0)
+    return bw;
+  unsigned ret = 0;
+  while(((x >> ret) & 1) == 0)
+    ret++;
+  return std::min(ret, bw);
+}
+
+inline int64_t floor_div(int64_t x, int64_t m) {
+  return x >= 0 ? x / m : -((-x + m - 1) / m);
+}
+
+range::interval range::full(ir::value* v) {
+  unsigned bw = bitwidth(v);
+  if(bw == 1)
+    return {0, 1};
+  if(bw >= 64)
+    return {INT64_MIN, INT64_MAX};
+  return {-(int64_t(1) << (bw - 1)), (int64_t(1) << (bw - 1)) - 1};
+}
+
+// clamp `x` to the range of `v`'s type and
+// round its bounds to multiples of known zero bits
+range::interval range::refine(ir::value* v, interval x) {
+  interval f = full(v);
+  if(x.lo < f.lo || x.hi > f.hi || x.lo > x.hi)
+    return f;
+  unsigned bw = bitwidth(v);
+  unsigned zeros = std::min<unsigned>(known_zeros(v), 32);
+  if(bw <= 32 && zeros > 0){
+    int64_t m = int64_t(1) << zeros;
+    int64_t lo = -floor_div(-x.lo, m) * m;
+    int64_t hi = floor_div(x.hi, m) * m;
+    if(lo <= hi)
+      return {lo, hi};
+  }
+  return x;
+}
+
+// condition under which `pred` branches to `succ`
+ir::value* range::edge_cond(ir::basic_block* pred, ir::basic_block* succ) {
+  auto* br = dynamic_cast<ir::cond_branch_inst*>(pred->get_inst_list().back());
+  if(!br || br->get_true_dest() != succ || br->get_false_dest() == succ)
+    return nullptr;
+  ir::value* cond = br->get_cond();
+  // loop conditions are built as where(step > 0, i < end, i > end)
+  while(auto* sel = dynamic_cast<ir::select_inst*>(cond)){
+    auto* pred = dynamic_cast<ir::constant_int*>(sel->get_pred_op());
+    if(!pred)
+      break;
+    cond = pred->get_value() ? sel->get_if_value_op() : sel->get_else_value_op();
+  }
+  return cond;
+}
+
+range::interval range::refine_edge(ir::value* v, ir::value* cond, interval x) {
+  if(auto* bin = dynamic_cast<ir::binary_operator*>(cond)){
+    if(bin->get_op() != ir::And)
+      return x;
+    x = refine_edge(v, bin->get_operand(0), x);
+    return refine_edge(v, bin->get_operand(1), x);
+  }
+  auto* cmp = dynamic_cast<ir::icmp_inst*>(cond);
+  if(!cmp || bitwidth(v) > 32)
+    return x;
+  ir::value* lhs = cmp->get_operand(0);
+  ir::value* rhs = cmp->get_operand(1);
+  ir::cmp_pred_t pred = cmp->get_pred();
+  if(rhs == v && lhs != v){
+    // mirror the predicate so that `v` is on the left-hand side
+    std::swap(lhs, rhs);
+    switch(pred){
+      case ir::ICMP_SLT: pred = ir::ICMP_SGT; break;
+      case ir::ICMP_SLE: pred = ir::ICMP_SGE; break;
+      case ir::ICMP_SGT: pred = ir::ICMP_SLT; break;
+      case ir::ICMP_SGE: pred = ir::ICMP_SLE; break;
+      default: return x;
+    }
+  }
+  if(lhs != v)
+    return x;
+  interval o = get(rhs);
+  switch(pred){
+    case ir::ICMP_SLT: x.hi = std::min(x.hi, o.hi - 1); break;
+    case ir::ICMP_SLE: x.hi = std::min(x.hi, o.hi); break;
+    case ir::ICMP_SGT: x.lo = std::max(x.lo, o.lo + 1); break;
+    case ir::ICMP_SGE: x.lo = std::max(x.lo, o.lo); break;
+    default: break;
+  }
+  return x;
+}
+
+// returns N if `phi` < N on every incoming edge
+ir::value* range::upper_bound(ir::phi_node* phi) {
+  auto it = upper_.find(phi);
+  if(it != upper_.end())
+    return it->second;
+  ir::value* result = nullptr;
+  for(unsigned n = 0; n < phi->get_num_incoming(); n++){
+    ir::value* v = phi->get_incoming_value(n);
+    ir::value* cond = edge_cond(phi->get_incoming_block(n), phi->get_parent());
+    auto* cmp = dynamic_cast<ir::icmp_inst*>(cond);
+    ir::value* bound = nullptr;
+    if(cmp && cmp->get_pred() == ir::ICMP_SLT && cmp->get_operand(0) == v)
+      bound = cmp->get_operand(1);
+    if(cmp && cmp->get_pred() == ir::ICMP_SGT && cmp->get_operand(1) == v)
+      bound = cmp->get_operand(0);
+    if(!bound || bound->get_type()->is_block_ty() || (result && bound != result)){
+      result = nullptr;
+      break;
+    }
+    result = bound;
+  }
+  return upper_[phi] = result;
+}
+
+// write `v` as splat(base) + off, where `off`
+// is a range of constant offsets
+bool range::decompose(ir::value* v, ir::value*& base, interval& off) {
+  if(!is_int(v) || bitwidth(v) > 32)
+    return false;
+  if(dynamic_cast<ir::constant_int*>(v) || dynamic_cast<ir::make_range*>(v)){
+    base = nullptr;
+    off = get(v);
+    return true;
+  }
+  if(dynamic_cast<ir::splat_inst*>(v) || dynamic_cast<ir::broadcast_inst*>(v) ||
+     dynamic_cast<ir::reshape_inst*>(v))
+    return decompose(((ir::instruction*)v)->get_operand(0), base, off);
+  auto* bin = dynamic_cast<ir::binary_operator*>(v);
+  if(bin && (bin->get_op() == ir::Add || bin->get_op() == ir::Sub)){
+    ir::value *lbase, *rbase;
+    interval loff, roff;
+    if(!decompose(bin->get_operand(0), lbase, loff) ||
+       !decompose(bin->get_operand(1), rbase, roff))
+      return false;
+    if(bin->get_op() == ir::Add){
+      if(lbase && rbase)
+        return false;
+      base = lbase ? lbase : rbase;
+      off = {loff.lo + roff.lo, loff.hi + roff.hi};
+      return true;
+    }
+    if(rbase)
+      return false;
+    base = lbase;
+    off = {loff.lo - roff.hi, loff.hi - roff.lo};
+    return true;
+  }
+  if(!v->get_type()->is_block_ty()){
+    base = v;
+    off = {0, 0};
+    return true;
+  }
+  base = nullptr;
+  off = get(v);
+  return true;
+}
+
+// checks that all elements of `lhs` are less than the corresponding
+// elements of `rhs` using loop bounds and known zero bits
+bool range::is_less(ir::value* lhs, ir::value* rhs) {
+  ir::value *lbase, *rbase;
+  interval loff, roff;
+  if(!decompose(lhs, lbase, loff) || !decompose(rhs, rbase, roff))
+    return false;
+  if(!lbase || !rbase)
+    return false;
+  // rhs must not wrap around
+  interval f = full(rhs);
+  interval rb = get(rbase);
+  if(rb.lo + roff.lo < f.lo || rb.hi + roff.hi > f.hi)
+    return false;
+  interval lb = get(lbase);
+  if(lbase == rbase)
+    return lb.lo + loff.lo >= f.lo && lb.hi + loff.hi <= f.hi &&
+           loff.hi < roff.lo;
+  // lbase < rbase and both are multiples of 2^zeros
+  auto* phi = dynamic_cast<ir::phi_node*>(lbase);
+  if(!phi || upper_bound(phi) != rbase)
+    return false;
+  if(lb.lo + loff.lo < f.lo)
+    return false;
+  unsigned zeros = std::min({known_zeros(lbase), known_zeros(rbase), 30u});
+  return loff.hi - roff.lo <= (int64_t(1) << zeros) - 1;
+}
+
+/*
+ * known zeros
+ */
+
+unsigned range::compute_zeros(ir::value* v) {
+  unsigned bw = bitwidth(v);
+  if(bw == 1)
+    return 0;
+  if(auto* x = dynamic_cast<ir::constant_int*>(v))
+    return ctz(get_signed(x), bw);
+  if(auto* x = dynamic_cast<ir::argument*>(v)){
+    for(ir::attribute attr: x->get_parent()->get_attributes(x))
+      if(attr.get_kind() == ir::multiple_of)
+        return ctz(attr.get_value(), bw);
+    return 0;
+  }
+  auto* i = dynamic_cast<ir::instruction*>(v);
+  if(!i)
+    return 0;
+  unsigned multiple_of = i->get_metadata(ir::metadata::multiple_of);
+  if(multiple_of > 0)
+    return ctz(multiple_of, bw);
+  if(auto* x = dynamic_cast<ir::binary_operator*>(i)){
+    unsigned lhs = known_zeros(x->get_operand(0));
+    unsigned rhs = known_zeros(x->get_operand(1));
+    switch(x->get_op()){
+      case ir::Add:
+      case ir::Sub:
+      case ir::Or:
+      case ir::Xor: return std::min(lhs, rhs);
+      case ir::Mul: return std::min(lhs + rhs, bw);
+      case ir::And: return std::max(lhs, rhs);
+      case ir::Shl: {
+        auto* cst = dynamic_cast<ir::constant_int*>(x->get_operand(1));
+        return cst ? std::min<unsigned>(lhs + cst->get_value(), bw) : lhs;
+      }
+      default: return 0;
+    }
+  }
+  if(auto* x = dynamic_cast<ir::cast_inst*>(i)){
+    unsigned op = known_zeros(x->get_operand(0));
+    switch(x->get_op()){
+      case ir::SExt:
+      case ir::ZExt: return op == bitwidth(x->get_operand(0)) ? bw : op;
+      case ir::Trunc: return std::min(op, bw);
+      default: return 0;
+    }
+  }
+  if(dynamic_cast<ir::splat_inst*>(i) || dynamic_cast<ir::broadcast_inst*>(i) ||
+     dynamic_cast<ir::reshape_inst*>(i))
+    return known_zeros(i->get_operand(0));
+  if(auto* x = dynamic_cast<ir::select_inst*>(i))
+    return std::min(known_zeros(x->get_if_value_op()), known_zeros(x->get_else_value_op()));
+  if(auto* x = dynamic_cast<ir::phi_node*>(i)){
+    unsigned result = bw;
+    for(unsigned n = 0; n < x->get_num_incoming(); n++)
+      result = std::min(result, known_zeros(x->get_incoming_value(n)));
+    return result;
+  }
+  if(auto* x = dynamic_cast<ir::make_range*>(i)){
+    if(x->get_last()->get_value() - x->get_first()->get_value() == 1)
+      return ctz(x->get_first()->get_value(), bw);
+    return 0;
+  }
+  return 0;
+}
+
+/*
+ * intervals
+ */
+
+range::interval range::compute_interval_binop(ir::binary_operator* x) {
+  interval a = get(x->get_operand(0));
+  interval b = get(x->get_operand(1));
+  unsigned bw = bitwidth(x);
+  if(bw == 1){
+    switch(x->get_op()){
+      case ir::And: return {a.lo & b.lo, a.hi & b.hi};
+      case ir::Or:  return {a.lo | b.lo, a.hi | b.hi};
+      default: return full(x);
+    }
+  }
+  // int64 arithmetic must not overflow
+  if(bw > 32)
+    return full(x);
+  bool b_cst = b.lo == b.hi;
+  switch(x->get_op()){
+    case ir::Add: return {a.lo + b.lo, a.hi + b.hi};
+    case ir::Sub: return {a.lo - b.hi, a.hi - b.lo};
+    case ir::Mul: {
+      int64_t c[4] = {a.lo*b.lo, a.lo*b.hi, a.hi*b.lo, a.hi*b.hi};
+      return {*std::min_element(c, c + 4), *std::max_element(c, c + 4)};
+    }
+    case ir::SDiv:
+      if(b_cst && b.lo > 0)
+        return {a.lo / b.lo, a.hi / b.lo};
+      return full(x);
+    case ir::SRem:
+      if(b.lo > 0 && a.lo >= 0)
+        return {0, std::min(a.hi, b.hi - 1)};
+      if(b.lo > 0)
+        return {-(b.hi - 1), b.hi - 1};
+      return full(x);
+    case ir::And:
+      if(a.lo >= 0 && b.lo >= 0)
+        return {0, std::min(a.hi, b.hi)};
+      if(a.lo >= 0)
+        return {0, a.hi};
+      if(b.lo >= 0)
+        return {0, b.hi};
+      return full(x);
+    case ir::Shl:
+      if(b_cst && b.lo >= 0 && b.lo < 32)
+        return {a.lo * (int64_t(1) << b.lo), a.hi * (int64_t(1) << b.lo)};
+      return full(x);
+    case ir::AShr:
+      if(b_cst && b.lo >= 0 && b.lo < 32)
+        return {a.lo >> b.lo, a.hi >> b.lo};
+      return full(x);
+    case ir::LShr:
+      if(b_cst && b.lo >= 0 && b.lo < 32 && a.lo >= 0)
+        return {a.lo >> b.lo, a.hi >> b.lo};
+      return full(x);
+    default:
+      return full(x);
+  }
+}
+
+range::interval range::compute_interval_icmp(ir::icmp_inst* x) {
+  ir::value* lhs = x->get_operand(0);
+  ir::value* rhs = x->get_operand(1);
+  interval a = get(lhs);
+  interval b = get(rhs);
+  const interval t = {1, 1}, f = {0, 0}, u = {0, 1};
+  ir::cmp_pred_t pred = x->get_pred();
+  // unsigned comparisons of non-negative values
+  if(a.lo >= 0 && b.lo >= 0){
+    switch(pred){
+      case ir::ICMP_ULT: pred = ir::ICMP_SLT; break;
+      case ir::ICMP_ULE: pred = ir::ICMP_SLE; break;
+      case ir::ICMP_UGT: pred = ir::ICMP_SGT; break;
+      case ir::ICMP_UGE: pred = ir::ICMP_SGE; break;
+      default: break;
+    }
+  }
+  switch(pred){
+    case ir::ICMP_EQ:
+      if(a.lo == a.hi && b.lo == b.hi && a.lo == b.lo) return t;
+      if(a.hi < b.lo || b.hi < a.lo) return f;
+      return u;
+    case ir::ICMP_NE:
+      if(a.lo == a.hi && b.lo == b.hi && a.lo == b.lo) return f;
+      if(a.hi < b.lo || b.hi < a.lo) return t;
+      return u;
+    case ir::ICMP_SLT:
+      if(a.hi < b.lo || is_less(lhs, rhs)) return t;
+      if(a.lo >= b.hi) return f;
+      return u;
+    case ir::ICMP_SLE:
+      if(a.hi <= b.lo || is_less(lhs, rhs)) return t;
+      if(a.lo > b.hi) return f;
+      return u;
+    case ir::ICMP_SGT:
+      if(b.hi < a.lo || is_less(rhs, lhs)) return t;
+      if(b.lo >= a.hi) return f;
+      return u;
+    case ir::ICMP_SGE:
+      if(b.hi <= a.lo || is_less(rhs, lhs)) return t;
+      if(b.lo > a.hi) return f;
+      return u;
+    default:
+      return u;
+  }
+}
+
+range::interval range::compute_interval_phi(ir::phi_node* x) {
+  interval result = {INT64_MAX, INT64_MIN};
+  for(unsigned n = 0; n < x->get_num_incoming(); n++){
+    ir::value* v = x->get_incoming_value(n);
+    interval inc = get(v);
+    ir::value* cond = edge_cond(x->get_incoming_block(n), x->get_parent());
+    if(cond)
+      inc = refine(v, refine_edge(v, cond, inc));
+    result.lo = std::min(result.lo, inc.lo);
+    result.hi = std::max(result.hi, inc.hi);
+  }
+  return result;
+}
+
+range::interval range::compute_interval(ir::value* v) {
+  if(auto* x = dynamic_cast<ir::constant_int*>(v)){
+    int64_t value = get_signed(x);
+    return {value, value};
+  }
+  if(auto* x = dynamic_cast<ir::argument*>(v)){
+    for(ir::attribute attr: x->get_parent()->get_attributes(x)){
+      if(attr.get_kind() == ir::equal_to_one)
+        return {1, 1};
+      if(attr.get_kind() == ir::num_programs)
+        return {1, INT32_MAX};
+    }
+    return full(v);
+  }
+  auto* i = dynamic_cast<ir::instruction*>(v);
+  if(!i)
+    return full(v);
+  interval result = full(v);
+  if(auto* x = dynamic_cast<ir::make_range*>(i))
+    result = {(int64_t)x->get_first()->get_value(), (int64_t)x->get_last()->get_value() - 1};
+  else if(dynamic_cast<ir::get_program_id_inst*>(i))
+    result = {0, INT32_MAX};
+  else if(dynamic_cast<ir::get_num_programs_inst*>(i))
+    result = {1, INT32_MAX};
+  else if(dynamic_cast<ir::splat_inst*>(i) || dynamic_cast<ir::broadcast_inst*>(i) ||
+          dynamic_cast<ir::reshape_inst*>(i))
+    result = get(i->get_operand(0));
+  else if(auto* x = dynamic_cast<ir::cast_inst*>(i)){
+    ir::value* op = x->get_operand(0);
+    if(is_int(op)){
+      interval arg = get(op);
+      if(x->get_op() == ir::SExt || x->get_op() == ir::Trunc)
+        result = arg;
+      if(x->get_op() == ir::ZExt)
+        result = arg.lo >= 0 ? arg : interval{0, (int64_t(1) << std::min(bitwidth(op), 62u)) - 1};
+    }
+  }
+  else if(auto* x = dynamic_cast<ir::binary_operator*>(i))
+    result = compute_interval_binop(x);
+  else if(auto* x = dynamic_cast<ir::icmp_inst*>(i))
+    result = compute_interval_icmp(x);
+  else if(auto* x = dynamic_cast<ir::select_inst*>(i)){
+    interval pred = get(x->get_pred_op());
+    interval a = get(x->get_if_value_op());
+    interval b = get(x->get_else_value_op());
+    if(pred.lo == 1)
+      result = a;
+    else if(pred.hi == 0)
+      result = b;
+    else
+      result = {std::min(a.lo, b.lo), std::max(a.hi, b.hi)};
+  }
+  else if(auto* x = dynamic_cast<ir::phi_node*>(i))
+    result = compute_interval_phi(x);
+  return refine(v, result);
+}
+
+/*
+ * public API
+ */
+
+range::interval range::get(ir::value* v) {
+  auto it = intervals_.find(v);
+  if(it != intervals_.end())
+    return it->second;
+  // values that have not been visited yet (e.g., back-edges)
+  if(dynamic_cast<ir::instruction*>(v))
+    return full(v);
+  return compute_interval(v);
+}
+
+unsigned range::known_zeros(ir::value* v) {
+  if(!is_int(v))
+    return 0;
+  auto it = zeros_.find(v);
+  if(it != zeros_.end())
+    return it->second;
+  // optimistic initial value for the fixed-point iteration
+  if(dynamic_cast<ir::instruction*>(v))
+    return bitwidth(v) == 1 ? 0 : bitwidth(v);
+  return compute_zeros(v);
+}
+
+bool range::is_always_true(ir::value* v) {
+  interval x = get(v);
+  return bitwidth(v) == 1 && x.lo == 1;
+}
+
+void range::run(ir::function* fn) {
+  std::vector<ir::instruction*> insts;
+  for(ir::basic_block* block: ir::cfg::reverse_post_order(fn))
+  for(ir::instruction* i: block->get_inst_list())
+    if(is_int(i))
+      insts.push_back(i);
+  // known zeros only decrease, so this terminates
+  bool changed = true;
+  while(changed){
+    changed = false;
+    for(ir::instruction* i: insts){
+      unsigned zeros = std::min(compute_zeros(i), known_zeros(i));
+      auto it = zeros_.find(i);
+      if(it == zeros_.end() || it->second != zeros){
+        zeros_[i] = zeros;
+        changed = true;
+      }
+    }
+  }
+  // intervals are computed in a single pass;
+  // back-edges are conservatively assumed to be unbounded
+  for(ir::instruction* i: insts)
+    intervals_[i] = compute_interval(i);
+}
+
+void range::run(ir::module &mod) {
+  intervals_.clear();
+  zeros_.clear();
+  upper_.clear();
+  for(ir::function* fn: mod.get_function_list())
+    run(fn);
+}
+
+}
+}
+}
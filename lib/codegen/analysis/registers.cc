@@ -0,0 +1,129 @@
+#include <algorithm>
+#include "triton/codegen/analysis/registers.h"
+#include "triton/codegen/analysis/layout.h"
+#include "triton/ir/module.h"
+#include "triton/ir/function.h"
+#include "triton/ir/basic_block.h"
+#include "triton/ir/instructions.h"
+
+namespace triton{
+namespace codegen{
+namespace analysis{
+
+inline bool is_variable(ir::value* v) {
+  return dynamic_cast<ir::instruction*>(v) || dynamic_cast<ir::argument*>(v);
+}
+
+// number of 32-bit registers per thread needed to hold v
+unsigned registers::get(ir::value* v) {
+  auto it = regs_.find(v);
+  if(it != regs_.end())
+    return it->second;
+  ir::type* ty = v->get_type();
+  unsigned ret = 0;
+  if(!ty->is_void_ty() && is_variable(v)){
+    ir::type* scalar_ty = ty->get_scalar_ty();
+    unsigned bits = scalar_ty->is_pointer_ty() ? 64 : scalar_ty->get_primitive_size_in_bits();
+    if(!ty->is_block_ty())
+      ret = (bits + 31) / 32;
+    else if(layouts_->has(v) && layouts_->get(v)->to_shared())
+      ret = 0;
+    else {
+      unsigned num_threads = 32 * num_warps_;
+      unsigned numel = ty->get_tile_num_elements();
+      auto* layout = layouts_->has(v) ? dynamic_cast<distributed_layout*>(layouts_->get(v)) : nullptr;
+      // elements are replicated when the tile is smaller than the layout
+      if(layout){
+        numel = 1;
+        for(size_t k = 0; k < layout->get_rank(); k++)
+          numel *= std::max<unsigned>(layout->get_shape()[k], layout->shape_per_cta(k));
+      }
+      unsigned elts = (numel + num_threads - 1) / num_threads;
+      // sub-word elements are only packed for tensor cores
+      if(!(layout && layout->to_mma()))
+        bits = std::max<unsigned>(bits, 32);
+      ret = (elts * bits + 31) / 32;
+    }
+  }
+  regs_[v] = ret;
+  return ret;
+}
+
+// values live at the end of each block
+void registers::live_out(ir::function* fn, std::map<ir::basic_block*, std::set<ir::value*>>& result) {
+  std::map<ir::basic_block*, std::set<ir::value*>> live_in;
+  bool changed;
+  do{
+    changed = false;
+    for(auto it = fn->blocks().rbegin(); it != fn->blocks().rend(); it++){
+      ir::basic_block* block = *it;
+      std::set<ir::value*> live;
+      for(ir::basic_block* succ: block->get_successors()){
+        live.insert(live_in[succ].begin(), live_in[succ].end());
+        for(ir::instruction* i: succ->get_inst_list())
+          if(auto* phi = dynamic_cast<ir::phi_node*>(i)){
+            live.erase(phi);
+            for(unsigned n = 0; n < phi->get_num_incoming(); n++)
+              if(phi->get_incoming_block(n) == block && is_variable(phi->get_incoming_value(n)))
+                live.insert(phi->get_incoming_value(n));
+          }
+      }
+      result[block] = live;
+      auto& inst_list = block->get_inst_list();
+      for(auto jt = inst_list.rbegin(); jt != inst_list.rend(); jt++){
+        ir::instruction* i = *jt;
+        live.erase(i);
+        if(dynamic_cast<ir::phi_node*>(i))
+          continue;
+        for(ir::value* op: i->ops())
+          if(is_variable(op))
+            live.insert(op);
+      }
+      for(ir::instruction* i: inst_list)
+        if(dynamic_cast<ir::phi_node*>(i))
+          live.insert(i);
+      if(live != live_in[block]){
+        live_in[block] = live;
+        changed = true;
+      }
+    }
+  }while(changed);
+}
+
+void registers::run(ir::function* fn) {
+  std::map<ir::basic_block*, std::set<ir::value*>> out;
+  live_out(fn, out);
+  for(ir::basic_block* block: fn->blocks()){
+    std::set<ir::value*> live = out[block];
+    unsigned curr = 0;
+    for(ir::value* v: live)
+      curr += get(v);
+    auto& inst_list = block->get_inst_list();
+    for(auto it = inst_list.rbegin(); it != inst_list.rend(); it++){
+      ir::instruction* i = *it;
+      // the result is written while the operands are still being read
+      if(live.insert(i).second)
+        curr += get(i);
+      max_live_ = std::max(max_live_, curr);
+      live.erase(i);
+      curr -= get(i);
+      if(dynamic_cast<ir::phi_node*>(i))
+        continue;
+      for(ir::value* op: i->ops())
+        if(is_variable(op) && live.insert(op).second)
+          curr += get(op);
+    }
+    max_live_ = std::max(max_live_, curr);
+  }
+}
+
+void registers::run(ir::module &mod) {
+  regs_.clear();
+  max_live_ = 0;
+  for(ir::function* fn: mod.get_function_list())
+    run(fn);
+}
+
+}
+}
+}
@@ -1,4 +1,5 @@
 #include "triton/codegen/analysis/swizzle.h"
+#include "triton/codegen/analysis/bank_conflicts.h"
 #include "triton/codegen/analysis/layout.h"
 #include "triton/codegen/target.h"
 #include "triton/ir/type.h"
@@ -8,10 +9,34 @@ namespace triton{
 namespace codegen{
 namespace analysis{
 
+// replaces the default swizzling parameters of `layout` by the ones
+// that minimize the number of shared memory wavefronts
+void swizzle::search(shared_layout* layout) {
+  int vec = vec_.at(layout);
+  int ld = layout->get_shape()[layout->get_order(0)];
+  auto cost = [&](int per_phase, int max_phase) {
+    unsigned ret = 0;
+    for(const bank_access& acc: bank_conflicts::simulate(layout, layouts_, tgt_, per_phase, max_phase, vec))
+      ret += acc.wavefronts;
+    return ret;
+  };
+  unsigned best = cost(per_phase_.at(layout), max_phase_.at(layout));
+  // ldmatrix computes the phase from the row index modulo 8
+  for(int per_phase = 1; per_phase <= 8; per_phase *= 2)
+  for(int max_phase = 1; per_phase*max_phase <= 8 && max_phase*vec <= ld; max_phase *= 2){
+    unsigned curr = cost(per_phase, max_phase);
+    if(curr < best){
+      best = curr;
+      per_phase_[layout] = per_phase;
+      max_phase_[layout] = max_phase;
+    }
+  }
+}
 
 void swizzle::run(ir::module &) {
     per_phase_.clear();
     max_phase_.clear();
+    vec_.clear();
 
     for(auto &x: layouts_->get_all()){
       shared_layout* layout = dynamic_cast<shared_layout*>(x.second);
@@ -43,6 +68,7 @@ void swizzle::run(ir::module &) {
         per_phase_[layout] = std::max<int>(128 / (in_layout->mts(ord[0])*in_layout->nts(ord[0])*dtsize), 1);
         max_phase_[layout] = 8 / per_phase_[layout];
         vec_[layout]       = 8;
+        search(layout);
       }
     }
 }
@@ -2,30 +2,43 @@
 #include "triton/codegen/analysis/align.h"
 #include "triton/codegen/analysis/allocation.h"
 #include "triton/codegen/analysis/axes.h"
+#include "triton/codegen/analysis/bank_conflicts.h"
 #include "triton/codegen/analysis/liveness.h"
+#include "triton/codegen/analysis/memory.h"
+#include "triton/codegen/analysis/range.h"
+#include "triton/codegen/analysis/registers.h"
 #include "triton/codegen/analysis/swizzle.h"
 #include "triton/codegen/selection/generator.h"
 #include "triton/codegen/transform/coalesce.h"
 #include "triton/codegen/transform/cts.h"
 #include "triton/codegen/transform/dce.h"
 #include "triton/codegen/transform/disassociate.h"
+#include "triton/codegen/transform/inline.h"
 #include "triton/codegen/transform/membar.h"
 #include "triton/codegen/transform/peephole.h"
+#include "triton/codegen/transform/persistent.h"
 #include "triton/codegen/transform/pipeline.h"
 #include "triton/codegen/transform/prefetch.h"
+#include "triton/codegen/transform/reorder.h"
+#include "triton/codegen/transform/strength_reduce.h"
+#include "triton/codegen/transform/unmask.h"
+#include "triton/codegen/transform/unroll.h"
 #include "triton/ir/function.h"
 #include "triton/ir/module.h"
 #include "triton/ir/print.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Verifier.h"
+#include <climits>
 namespace triton {
 namespace codegen {
 
 // TODO:
 // There should be a proper pass manager there!
 std::unique_ptr<llvm::Module> add_passes_to_emit_bin(ir::module &ir, llvm::LLVMContext& ctx, codegen::target* target,
-                                                     int cc, int num_warps, int num_stages, int& shared_static) {
+                                                     int cc, int num_warps, int num_stages, int num_unroll, int& shared_static,
+                                                     int& num_regs, bool estimate_only,
+                                                     compile_report* report) {
   // generate llvm code
   std::string name = ir.get_function_list()[0]->get_name();
   std::unique_ptr<llvm::Module> llvm(new llvm::Module(name, ctx));
@@ -34,25 +47,45 @@ std::unique_ptr<llvm::Module> add_passes_to_emit_bin(ir::module &ir, llvm::LLVMC
   // create passes
   codegen::analysis::align align;
   codegen::analysis::axes axes;
+  codegen::analysis::range range;
   codegen::transform::cts cts(cts_use_async);
   codegen::transform::pipeline pipeline(cts_use_async, num_stages);
+  codegen::transform::strength_reduce strength_reduce;
   codegen::transform::disassociate disassociate;
   codegen::analysis::layouts layouts(&axes, &align, num_warps, target);
   codegen::analysis::liveness liveness(&layouts);
   codegen::analysis::swizzle swizzle(&layouts, target);
+  codegen::analysis::bank_conflicts bank_conflicts(&layouts, &swizzle, target);
+  codegen::analysis::memory memory(&align, &layouts);
   codegen::analysis::allocation allocation(&liveness);
+  codegen::analysis::registers registers(&layouts, num_warps);
   codegen::transform::dce dce;
+  // device functions get the thread indices from the GPU special registers
+  codegen::transform::inliner inliner(target->is_gpu() ? 32 : INT_MAX);
+  codegen::transform::persistent persistent;
+  codegen::transform::unmask unmask(&range);
+  codegen::transform::unroll unroll(num_unroll);
   codegen::transform::peephole peephole(target, &layouts);
   codegen::transform::coalesce coalesce(&align, &layouts);
   codegen::transform::prefetch prefetch_s(target);
+  codegen::transform::reorder reorder(num_warps);
   codegen::transform::membar barriers(&liveness, &layouts, &allocation, &prefetch_s, target);
   codegen::generator isel(&axes, &layouts, &align, &allocation, &swizzle, target, num_warps);
   // run passes
+  inliner.run(ir);
+  persistent.run(ir);
   dce.run(ir);
   peephole.run(ir);
   dce.run(ir);
+  unroll.run(ir);
+  dce.run(ir);
+  range.run(ir);
+  unmask.run(ir);
+  dce.run(ir);
   pipeline.run(ir);
   dce.run(ir);
+  strength_reduce.run(ir);
+  dce.run(ir);
   disassociate.run(ir);
   dce.run(ir);
   align.run(ir);
@@ -77,16 +110,28 @@ std::unique_ptr<llvm::Module> add_passes_to_emit_bin(ir::module &ir, llvm::LLVMC
   layouts.run(ir);
   peephole.run(ir);
   dce.run(ir);
+  reorder.run(ir);
   align.run(ir);
   axes.run(ir);
   layouts.run(ir);
   swizzle.run(ir);
+  if (report) {
+    bank_conflicts.run(ir);
+    for (auto& x: bank_conflicts.get_all())
+      report->bank_conflicts.insert(report->bank_conflicts.end(), x.second.begin(), x.second.end());
+    memory.run(ir);
+    report->memory_accesses = memory.get_all();
+  }
   liveness.run(ir);
   allocation.run(ir);
+  registers.run(ir);
+  shared_static = allocation.allocated_size();
+  num_regs = registers.get_max_live();
+  if (estimate_only)
+    return nullptr;
   prefetch_s.run(ir);
   barriers.run(ir);
   isel.visit(ir, *llvm);
-  shared_static = allocation.allocated_size();
   return llvm;
 }
 
@@ -12,12 +12,14 @@
 #include "triton/ir/module.h"
 #include "triton/ir/function.h"
 #include "triton/ir/type.h"
+#include "triton/ir/utils.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/IntrinsicsNVPTX.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/Attributes.h"
 #include "llvm/IR/InlineAsm.h"
+#include "llvm/IR/MDBuilder.h"
 #include "llvm/Transforms/Utils/BasicBlockUtils.h"
 
 namespace triton{
@@ -116,6 +118,7 @@ Value* geper::operator()(Value *ptr, Value* off, const std::string& name){
 #define icmp_sle(...)        builder_->CreateICmpSLE(__VA_ARGS__)
 #define icmp_ult(...)        builder_->CreateICmpULT(__VA_ARGS__)
 #define insert_elt(...)      builder_->CreateInsertElement(__VA_ARGS__)
+#define insert_val(...)      builder_->CreateInsertValue(__VA_ARGS__)
 #define intrinsic(...)       builder_->CreateIntrinsic(__VA_ARGS__)
 #define load(...)            builder_->CreateLoad(__VA_ARGS__)
 #define lshr(...)            builder_->CreateLShr(__VA_ARGS__)
@@ -456,6 +459,36 @@ std::tuple<Value*, Value*, Value*, Value*> generator::fp8x4_to_fp16x4(Value *in0
   return std::make_tuple(ret0, ret1, ret2, ret3);
 }
 
+std::tuple<Value*, Value*, Value*, Value*> generator::int8x4_to_fp16x4(Value *in0, Value *in1, Value *in2, Value *in3){
+  // biased bytes are placed in the mantissa of 1024.0,
+  // so that subtracting 1024 + 128 yields the signed value
+  Type *ret_ty = StructType::get(*ctx_, {vec_ty(f16_ty, 2), vec_ty(f16_ty, 2)});
+  InlineAsm *ptx = InlineAsm::get(FunctionType::get(ret_ty, {i32_ty}, false),
+  "{"
+  ".reg .b32 a<2>, b, c;                  \n\t"
+  "xor.b32  b, $2, 0x80808080;            \n\t" // two's complement -> offset binary
+  "prmt.b32 a0, b, 0x64646464, 0x4140;    \n\t" // bytes 0, 1 into fp16 mantissas
+  "prmt.b32 a1, b, 0x64646464, 0x4342;    \n\t" // bytes 2, 3 into fp16 mantissas
+  "mov.b32  c, 0x64806480;                \n\t" // (1152, 1152)
+  "sub.f16x2 $0, a0, c;                   \n\t"
+  "sub.f16x2 $1, a1, c;                   \n\t"
+  "}", "=r,=r,r", false);
+  Value *packed_in = UndefValue::get(vec_ty(i8_ty, 4));
+  packed_in = insert_elt(packed_in, in0, (uint64_t)0);
+  packed_in = insert_elt(packed_in, in1, (uint64_t)1);
+  packed_in = insert_elt(packed_in, in2, (uint64_t)2);
+  packed_in = insert_elt(packed_in, in3, (uint64_t)3);
+  Value *in = bit_cast(packed_in, i32_ty);
+  Value *ret = call(ptx, {in});
+  Value *packed_ret0 = extract_val(ret, {0});
+  Value *packed_ret1 = extract_val(ret, {1});
+  Value *ret0 = extract_elt(packed_ret0, (uint64_t)0);
+  Value *ret1 = extract_elt(packed_ret0, (uint64_t)1);
+  Value *ret2 = extract_elt(packed_ret1, (uint64_t)0);
+  Value *ret3 = extract_elt(packed_ret1, (uint64_t)1);
+  return std::make_tuple(ret0, ret1, ret2, ret3);
+}
+
 Value* generator::bf16_to_fp32(Value *in0){
   Value *ret = UndefValue::get(vec_ty(builder_->getInt16Ty(), 2));
   ret = insert_elt(ret, in0, (uint64_t)1);
@@ -510,6 +543,24 @@ void generator::visit_cast_inst(ir::cast_inst* x) {
     return;
   }
 
+  // INT8 -> FP16/FP32, four lanes at a time
+  // the conversion is element-wise, so any four values of a thread can be packed;
+  // it is PTX inline assembly, so other targets use the generic path
+  if(tgt_->as_nvidia() && x->get_type()->is_block_ty() && x->get_op() == ir::cast_op_t::SIToFP &&
+     op_sca_ty->is_integer_ty(8) && (ret_sca_ty->is_fp16_ty() || ret_sca_ty->is_fp32_ty()) &&
+     x_idxs.size() % 4 == 0){
+    for(size_t i = 0; i < x_idxs.size(); i+=4){
+      Value *ret[4];
+      std::tie(ret[0], ret[1], ret[2], ret[3]) = int8x4_to_fp16x4(vals_[op][op_idxs[i+0]],
+                                                                  vals_[op][op_idxs[i+1]],
+                                                                  vals_[op][op_idxs[i+2]],
+                                                                  vals_[op][op_idxs[i+3]]);
+      for(int j = 0; j < 4; j++)
+        vals_[x][x_idxs[i+j]] = ret_sca_ty->is_fp32_ty() ? cast(llvm::Instruction::FPExt, ret[j], f32_ty) : ret[j];
+    }
+    return;
+  }
+
   // <> BF16
   if(ret_sca_ty->is_bf16_ty() || op_sca_ty->is_bf16_ty()){
     // FP32 -> BF16
@@ -556,7 +607,67 @@ void generator::visit_cast_inst(ir::cast_inst* x) {
  */
 void generator::visit_return_inst(ir::return_inst* rr) {
   ir::value *ret_val = rr->get_return_value();
-  ret(ret_val ? vals_[ret_val][{}] : nullptr);
+  ir::function *fn = rr->get_parent()->get_parent();
+  if(!ret_val || fn->is_kernel()){
+    ret(ret_val ? vals_[ret_val][{}] : nullptr);
+    return;
+  }
+  // device functions return the flattened elements of their result
+  Type *ret_ty = get_device_function(fn)->getReturnType();
+  Value *agg = llvm::UndefValue::get(ret_ty);
+  std::vector<Value*> elts = flatten(ret_val);
+  for(unsigned i = 0; i < elts.size(); i++)
+    agg = insert_val(agg, elts[i], {i});
+  ret(agg);
+}
+
+/**
+ * \brief Code Generation for `call`
+ */
+void generator::visit_call_inst(ir::call_inst* x) {
+  Function *fn = get_device_function(x->get_fn());
+  std::vector<Value*> args;
+  for(ir::value *op: x->ops())
+    for(Value *v: flatten(op))
+      args.push_back(v);
+  Value *res = call(fn, args);
+  if(fn->getReturnType()->isVoidTy())
+    return;
+  // unpack the flattened result
+  std::vector<ir::value*> rets = ir::get_return_values(x->get_fn());
+  unsigned off = 0;
+  if(x->get_type()->is_struct_ty()){
+    structs_[x].assign(rets.size(), {});
+    for(size_t k = 0; k < rets.size(); k++){
+      if(!rets[k])
+        continue;
+      for(size_t i = 0; i < idxs_.at(rets[k]).size(); i++)
+        structs_[x][k].push_back(extract_val(res, {off++}));
+    }
+    return;
+  }
+  for(indices_t idx: idxs_.at(x))
+    vals_[x][idx] = extract_val(res, {off++});
+}
+
+/**
+ * \brief Code Generation for `extract_value`
+ */
+void generator::visit_extract_value_inst(ir::extract_value_inst* x) {
+  const std::vector<Value*>& elts = structs_.at(x->get_operand(0)).at(x->get_idx());
+  const std::vector<indices_t>& idxs = idxs_.at(x);
+  if(elts.size() != idxs.size())
+    throw std::runtime_error("extracting a value that was never inserted");
+  for(size_t i = 0; i < idxs.size(); i++)
+    vals_[x][idxs[i]] = elts[i];
+}
+
+/**
+ * \brief Code Generation for `insert_value`
+ */
+void generator::visit_insert_value_inst(ir::insert_value_inst* x) {
+  structs_[x] = structs_.at(x->get_operand(0));
+  structs_[x].at(x->get_idx()) = flatten(x->get_operand(1));
 }
 
 /**
@@ -577,6 +688,50 @@ void generator::visit_uncond_branch_inst(ir::uncond_branch_inst* br) {
   br(dest);
 }
 
+// collects the values that pointer `v` is computed from
+static void get_base_ptrs(ir::value* v, std::set<ir::value*>& seen, std::set<ir::value*>& bases) {
+  if(!seen.insert(v).second)
+    return;
+  if(auto* gep = dynamic_cast<ir::getelementptr_inst*>(v))
+    return get_base_ptrs(gep->get_pointer_operand(), seen, bases);
+  if(dynamic_cast<ir::retile_inst*>(v))
+    return get_base_ptrs(static_cast<ir::instruction*>(v)->get_operand(0), seen, bases);
+  if(auto* phi = dynamic_cast<ir::phi_node*>(v)){
+    for(unsigned n = 0; n < phi->get_num_incoming(); n++)
+      get_base_ptrs(phi->get_incoming_value(n), seen, bases);
+    return;
+  }
+  if(auto* sel = dynamic_cast<ir::select_inst*>(v)){
+    get_base_ptrs(sel->get_if_value_op(), seen, bases);
+    get_base_ptrs(sel->get_else_value_op(), seen, bases);
+    return;
+  }
+  bases.insert(v);
+}
+
+// kernel argument that pointer `v` points into, if unique
+static ir::argument* get_base_arg(ir::value* v) {
+  std::set<ir::value*> seen;
+  std::set<ir::value*> bases;
+  get_base_ptrs(v, seen, bases);
+  if(bases.size() != 1)
+    return nullptr;
+  return dynamic_cast<ir::argument*>(*bases.begin());
+}
+
+void generator::set_alias_scope(Instruction* i, ir::value* ptr) {
+  auto it = alias_scopes_.find(get_base_arg(ptr));
+  if(it == alias_scopes_.end())
+    return;
+  std::vector<llvm::Metadata*> others;
+  for(auto& x: alias_scopes_)
+    if(x.first != it->first)
+      others.push_back(x.second);
+  i->setMetadata(llvm::LLVMContext::MD_alias_scope, llvm::MDNode::get(*ctx_, {it->second}));
+  if(!others.empty())
+    i->setMetadata(llvm::LLVMContext::MD_noalias, llvm::MDNode::get(*ctx_, others));
+}
+
 /**
  * \brief Code Generation for a (synchronous) `load`
  */
@@ -584,6 +739,9 @@ void generator::visit_load_inst(ir::load_inst* x){
   ir::value *op = x->get_pointer_operand();
   ir::masked_load_inst *mx = dynamic_cast<ir::masked_load_inst*>(x);
   Type* ty  = cvt(op->get_type()->get_scalar_ty()->get_pointer_element_ty());
+  // read-only data is loaded through the non-coherent cache; since
+  // nothing writes it, the load can be freely moved around by LLVM
+  bool is_readonly = readonly_args_.find(get_base_arg(op)) != readonly_args_.end();
   // compute vector width
   size_t vec = 1;
   if(op->get_type()->is_block_ty()){
@@ -632,6 +790,7 @@ void generator::visit_load_inst(ir::load_inst* x){
     asm_oss << " ld.global";
     if (x->get_cache_modifier() == ir::load_inst::CA) asm_oss << ".ca";
     if (x->get_cache_modifier() == ir::load_inst::CG) asm_oss << ".cg";
+    if (is_readonly) asm_oss << ".nc";
     if(n_words > 1)
       asm_oss << ".v" << n_words; // vector width
     asm_oss << ".b" << width; // word size
@@ -694,7 +853,7 @@ void generator::visit_load_inst(ir::load_inst* x){
     // ---
     // finally call inline ASM
     // ---
-    InlineAsm *inlineAsm = InlineAsm::get(asm_ty, asm_oss.str(), asm_cstrt, true);
+    InlineAsm *inlineAsm = InlineAsm::get(asm_ty, asm_oss.str(), asm_cstrt, !is_readonly);
     std::vector<Value*> args = {pred, ptr};
     for(Value *v: others)
         args.push_back(v);
@@ -760,11 +919,11 @@ void generator::visit_store_inst(ir::store_inst * x){
       Instruction *term = llvm::SplitBlockAndInsertIfThen(msk, no_op, false);
       dummy->removeFromParent();
       builder_->SetInsertPoint(term);
-      store(val, ptr);
+      set_alias_scope(store(val, ptr), ptr_op);
       builder_->SetInsertPoint(no_op);
     }
     else
-      store(val, ptr);
+      set_alias_scope(store(val, ptr), ptr_op);
   }
 }
 void generator::visit_unmasked_store_inst(ir::unmasked_store_inst* x) {
@@ -1013,11 +1172,14 @@ void generator::visit_atomic_rmw_inst(ir::atomic_rmw_inst *atom) {
       case tt::FAdd: name = "add", s_ty = "f"; break;
       case tt::Xchg: name = "exch", s_ty = "b"; break;
     }
+    // there is no signed 64-bit atomic add
+    if(atom->get_op() == tt::Add && nbits == 64)
+      s_ty = "u";
     std::string s_vec = vec == 2 ? "x2" : "";
-    std::string mod = nbits == 32 ? "" : ".noftz";
+    std::string mod = nbits == 16 ? ".noftz" : "";
 
     std::string asm_str = "@$1 atom.global.gpu." + name + mod + "." + s_ty + s_nbits + s_vec + " $0, [$2" + offset + "], $3;";
-    std::string ty_id = nbits*vec == 32 ? "r" : "h";
+    std::string ty_id = nbits*vec == 64 ? "l" : (nbits*vec == 32 ? "r" : "h");
     std::string constraint = "=" + ty_id + ",b,l," + ty_id;
     // create inline asm
     InlineAsm *iasm = InlineAsm::get(fn_ty, asm_str, constraint, true);
@@ -1752,6 +1914,21 @@ inline Value* generator::shfl_sync(Value* acc, int32_t i){
   return builder_->CreateBitCast(ret, ty);
 }
 
+inline Value* generator::shfl_up(Value* acc, int32_t i){
+  Type* ty = acc->getType();
+  std::string asm_str = "shfl.sync.up.b32 $0, $1, $2, 0x0, 0xffffffff;";
+  InlineAsm *shfl = InlineAsm::get(FunctionType::get(f32_ty, {f32_ty, i32_ty}, false), asm_str, "=f,f,r", false);
+  if(ty->getPrimitiveSizeInBits() <= 32)
+    return bit_cast(call(shfl, {bit_cast(acc, f32_ty), i32(i)}), ty);
+  acc = builder_->CreateBitCast(acc, vec_ty(f32_ty, 2));
+  Value* acc0 = builder_->CreateExtractElement(acc, i32(0));
+  Value* acc1 = builder_->CreateExtractElement(acc, i32(1));
+  Value* ret = UndefValue::get(vec_ty(f32_ty, 2));
+  ret = insert_elt(ret, shfl_up(acc0, i), i32(0));
+  ret = insert_elt(ret, shfl_up(acc1, i), i32(1));
+  return builder_->CreateBitCast(ret, ty);
+}
+
 /**
  * \brief Code Generation for `reduce` (1D case)
  */
@@ -1893,8 +2070,8 @@ void generator::visit_reduce_inst(ir::reduce_inst* x) {
   switch(op) {
     case ir::reduce_inst::ADD: neutral = ConstantInt::get(ty, 0); break;
     case ir::reduce_inst::SUB:  neutral = ConstantInt::get(ty, 0); break;
-    case ir::reduce_inst::MAX:  neutral = ConstantInt::get(ty, INT32_MIN); break;
-    case ir::reduce_inst::MIN:  neutral = ConstantInt::get(ty, INT32_MAX); break;
+    case ir::reduce_inst::MAX:  neutral = ConstantInt::get(ty, APInt::getSignedMinValue(ty->getIntegerBitWidth())); break;
+    case ir::reduce_inst::MIN:  neutral = ConstantInt::get(ty, APInt::getSignedMaxValue(ty->getIntegerBitWidth())); break;
     case ir::reduce_inst::FADD: neutral = ConstantFP::get(ty, 0); break;
     case ir::reduce_inst::FSUB: neutral = ConstantFP::get(ty, 0); break;
     case ir::reduce_inst::FMAX: neutral = ConstantFP::get(ty, -INFINITY); break;
@@ -1908,6 +2085,324 @@ void generator::visit_reduce_inst(ir::reduce_inst* x) {
     visit_reducend_inst(x, do_acc, neutral);
 }
 
+/**
+ * \brief Code Generation for `sort`
+ *
+ * The block is written to shared memory, where all threads of the CTA run
+ * a bitonic sorting network along the last axis. Each thread loads chunks of
+ * consecutive elements of a row in registers: stages that compare elements of
+ * the same chunk are run within the thread, and stages that compare chunks
+ * of the same warp with shuffles. The other stages are rounds of independent
+ * compare-and-swaps in shared memory, separated by barriers. The block goes
+ * through shared memory at least once, as its distributed layout is arbitrary.
+ * Only the first columns are read back when the result is narrower (`topk`).
+ */
+void generator::visit_sort_inst(ir::sort_inst* x) {
+  ir::value *arg = x->get_operand(0);
+  Type *ty = cvt(x->get_type()->get_scalar_ty());
+  analysis::shared_layout* layout = layouts_->get(layouts_->tmp(x))->to_shared();
+  Value *base = gep(shmem_, i32(alloc_->offset(layout)));
+  base = bit_cast(base, ptr_ty(ty, shmem_->getType()->getPointerAddressSpace()));
+  auto shape = layout->get_shape();
+  auto order = layout->get_order();
+  size_t rank = shape.size();
+  unsigned n = shape[rank - 1];
+  unsigned numel = 1;
+  for(unsigned s: shape)
+    numel *= s;
+  unsigned num_pairs = numel / 2;
+  unsigned num_threads = num_warps_ * 32;
+  Value *thread = tgt_->get_local_id(mod_, *builder_, 0);
+  // write block to shared memory
+  add_barrier();
+  for(indices_t idx: idxs_.at(arg))
+    store(vals_[arg][idx], gep(base, shared_off(shape, order, idx)));
+  add_barrier();
+  // element `col` of the flattened row `row`
+  auto ptr_at = [&](Value *row, Value *col) {
+    indices_t idx(rank);
+    for(int d = (int)rank - 2; d >= 0; d--){
+      idx[d] = urem(row, i32(shape[d]));
+      row = udiv(row, i32(shape[d]));
+    }
+    idx[rank - 1] = col;
+    return gep(base, shared_off(shape, order, idx));
+  };
+  auto greater = [&](Value *a, Value *b) {
+    return ty->isFloatingPointTy() ? fcmp(FCmpInst::FCMP_OGT, a, b) : icmp(ICmpInst::ICMP_SGT, a, b);
+  };
+  // runs `fn` for the indices thread + p0 < num, p0 = 0, num_threads, ...
+  // threads past `num` are idle, and the last round ends with a barrier
+  auto for_each_thread = [&](unsigned num, std::function<void(Value*)> fn) {
+    for(unsigned p0 = 0; p0 < num; p0 += num_threads){
+      Value *p = add(thread, i32(p0));
+      if(p0 + num_threads <= num){
+        fn(p);
+        continue;
+      }
+      Value *cond = icmp_ult(p, i32(num));
+      Instruction *barrier = add_barrier();
+      builder_->SetInsertPoint(barrier->getParent());
+      Instruction* dummy = builder_->CreateRet(nullptr);
+      Instruction *term = llvm::SplitBlockAndInsertIfThen(cond, barrier, false);
+      dummy->removeFromParent();
+      builder_->SetInsertPoint(term);
+      fn(p);
+      builder_->SetInsertPoint(barrier->getParent());
+    }
+    if(num % num_threads == 0)
+      add_barrier();
+  };
+  // compare-and-swap of the pair p of a stage
+  auto compare_swap = [&](Value *p, unsigned k, unsigned j) {
+    Value *row = udiv(p, i32(n/2));
+    Value *q = urem(p, i32(n/2));
+    Value *lo = add(mul(udiv(q, i32(j)), i32(2*j)), urem(q, i32(j)));
+    Value *ptr_lo = ptr_at(row, lo);
+    Value *ptr_hi = ptr_at(row, add(lo, i32(j)));
+    Value *a = load(ptr_lo);
+    Value *b = load(ptr_hi);
+    // the direction of the sequence alternates with bit k of the index
+    Value *asc = icmp_eq(and_(lo, i32(k)), i32(0));
+    Value *swap = select(asc, greater(a, b), greater(b, a));
+    store(select(swap, b, a), ptr_lo);
+    store(select(swap, a, b), ptr_hi);
+  };
+  // chunk q holds the C consecutive elements q*C, ..., q*C + C - 1 and is
+  // held by thread q % num_threads, so that the chunk j/C apart is held by
+  // the lane j/C apart in the same warp, as rows have a power of two length
+  unsigned C = std::min(std::min(n, std::max(numel / num_threads, 1u)), 8u);
+  unsigned num_chunks = numel / C;
+  // shuffles exchange values within a warp, so every warp
+  // must be either fully active or fully idle
+  bool use_shuffles = tgt_->as_nvidia() && num_chunks % 32 == 0;
+  unsigned max_j = use_shuffles ? 32*C : C;
+  // stages (k, j) with j < max_j, run in registers
+  auto register_stages = [&](const std::vector<std::pair<unsigned, unsigned>>& stages) {
+    for_each_thread(num_chunks, [&](Value *q) {
+      Value *row = udiv(q, i32(n/C));
+      Value *col0 = mul(urem(q, i32(n/C)), i32(C));
+      std::vector<Value*> cols(C), ptrs(C), a(C);
+      for(unsigned c = 0; c < C; c++){
+        cols[c] = add(col0, i32(c));
+        ptrs[c] = ptr_at(row, cols[c]);
+        a[c] = load(ptrs[c]);
+      }
+      for(auto stage: stages){
+        unsigned k = stage.first, j = stage.second;
+        for(unsigned c = 0; c < C; c++){
+          Value *asc = icmp_eq(and_(cols[c], i32(k)), i32(0));
+          // both elements of the pair are held by this thread
+          if(j < C){
+            if(c & j)
+              continue;
+            Value *lo = a[c], *hi = a[c + j];
+            Value *swap = select(asc, greater(lo, hi), greater(hi, lo));
+            a[c] = select(swap, hi, lo);
+            a[c + j] = select(swap, lo, hi);
+            continue;
+          }
+          // 64-bit words are exchanged as two 32-bit shuffles;
+          // the lower element of a pair keeps the minimum in ascending sequences
+          Value *b = shfl_sync(a[c], j / C);
+          Value *is_lo = icmp_eq(and_(cols[c], i32(j)), i32(0));
+          Value *keep_min = icmp_eq(is_lo, asc);
+          a[c] = select(icmp_eq(greater(a[c], b), keep_min), b, a[c]);
+        }
+      }
+      for(unsigned c = 0; c < C; c++)
+        store(a[c], ptrs[c]);
+    });
+  };
+  std::vector<std::pair<unsigned, unsigned>> stages;
+  for(unsigned k = 2; k <= n; k *= 2)
+  for(unsigned j = k / 2; j > 0; j /= 2){
+    if(j < max_j){
+      stages.push_back({k, j});
+      continue;
+    }
+    if(!stages.empty())
+      register_stages(stages);
+    stages.clear();
+    for_each_thread(num_pairs, [&](Value *p) { compare_swap(p, k, j); });
+  }
+  if(!stages.empty())
+    register_stages(stages);
+  // read sorted block
+  for(indices_t idx: idxs_.at(x))
+    vals_[x][idx] = load(gep(base, shared_off(shape, order, idx)));
+}
+
+/**
+ * \brief Code Generation for `scan`
+ *
+ * The block is written to shared memory, with rows along the scanned axis
+ * made contiguous, and split in chunks of C elements, one per thread. Each
+ * thread scans its chunk sequentially; the totals of the chunks of a row are
+ * then scanned with warp shuffles, and across warps through shared memory.
+ */
+void generator::visit_scan_inst(ir::scan_inst* x) {
+  ir::value *arg = x->get_operand(0);
+  Type *ty = cvt(x->get_type()->get_scalar_ty());
+  unsigned axis = x->get_axis();
+  // accumulation function
+  ir::scan_inst::op_t op = x->get_op();
+  auto do_acc = [&](Value *x, Value *y) -> Value* {
+    switch(op){
+    case ir::scan_inst::ADD: return add(x, y);
+    case ir::scan_inst::MUL: return mul(x, y);
+    case ir::scan_inst::FADD: return fadd(x, y);
+    case ir::scan_inst::FMUL: return fmul(x, y);
+    default: throw std::runtime_error("unreachable");
+    }
+  };
+  // neutral element
+  Value *neutral;
+  switch(op) {
+    case ir::scan_inst::ADD: neutral = ConstantInt::get(ty, 0); break;
+    case ir::scan_inst::MUL: neutral = ConstantInt::get(ty, 1); break;
+    case ir::scan_inst::FADD: neutral = ConstantFP::get(ty, 0); break;
+    case ir::scan_inst::FMUL: neutral = ConstantFP::get(ty, 1); break;
+    default: throw std::runtime_error("unreachable");
+  }
+  auto shape = x->get_type()->get_block_shapes();
+  size_t rank = shape.size();
+  unsigned n = shape[axis];
+  unsigned numel = x->get_type()->get_tile_num_elements();
+  unsigned rows = numel / n;
+
+  // a single thread holds the whole block on the host:
+  // rows are scanned sequentially, in registers
+  if(!tgt_->is_gpu()){
+    std::map<std::vector<uint64_t>, std::map<uint64_t, indices_t>> lines;
+    for(indices_t idx: idxs_.at(arg)){
+      std::vector<uint64_t> key;
+      for(size_t d = 0; d < rank; d++){
+        auto *cst = dyn_cast<ConstantInt>(idx[d]);
+        if(!cst)
+          throw std::runtime_error("scan: unsupported layout");
+        if(d != axis)
+          key.push_back(cst->getZExtValue());
+      }
+      lines[key][dyn_cast<ConstantInt>(idx[axis])->getZExtValue()] = idx;
+    }
+    for(auto& line: lines){
+      Value *acc = nullptr;
+      for(auto& elt: line.second){
+        Value *val = vals_[arg][elt.second];
+        acc = acc ? do_acc(acc, val) : val;
+        vals_[x][elt.second] = acc;
+      }
+    }
+    return;
+  }
+
+  analysis::shared_layout* layout = layouts_->get(layouts_->tmp(x))->to_shared();
+  Value *base = gep(shmem_, i32(alloc_->offset(layout)));
+  base = bit_cast(base, ptr_ty(ty, shmem_->getType()->getPointerAddressSpace()));
+  unsigned num_threads = num_warps_ * 32;
+  Value *thread = tgt_->get_local_id(mod_, *builder_, 0);
+  // offset of an element in shared memory
+  auto offset = [&](const indices_t& idx) {
+    Value *row = i32(0);
+    for(size_t d = 0; d < rank; d++)
+      if(d != axis)
+        row = add(mul(row, i32(shape[d])), idx[d]);
+    return add(mul(row, i32(n)), idx[axis]);
+  };
+  // runs `body` in the threads for which `cond` holds, then synchronizes
+  auto guarded = [&](Value *cond, std::function<void()> body) {
+    Instruction *barrier = add_barrier();
+    builder_->SetInsertPoint(barrier->getParent());
+    Instruction* dummy = builder_->CreateRet(nullptr);
+    Instruction *term = llvm::SplitBlockAndInsertIfThen(cond, barrier, false);
+    dummy->removeFromParent();
+    builder_->SetInsertPoint(term);
+    body();
+    builder_->SetInsertPoint(barrier->getParent());
+  };
+  // write block to shared memory
+  add_barrier();
+  for(indices_t idx: idxs_.at(arg))
+    store(vals_[arg][idx], gep(base, offset(idx)));
+  add_barrier();
+  // smallest chunks such that there are no more chunks than threads
+  unsigned C = 1;
+  while(C < n && C * num_threads < numel)
+    C *= 2;
+  unsigned num_chunks = numel / C;
+  unsigned chunks_per_row = n / C;
+
+  if(chunks_per_row == 1){
+    // every thread scans whole rows
+    for(unsigned r0 = 0; r0 < rows; r0 += num_threads){
+      Value *row = add(thread, i32(r0));
+      auto scan_row = [&]() {
+        Value *acc = nullptr;
+        for(unsigned k = 0; k < n; k++){
+          Value *ptr = gep(base, add(mul(row, i32(n)), i32(k)));
+          Value *val = load(ptr);
+          acc = acc ? do_acc(acc, val) : val;
+          store(acc, ptr);
+        }
+      };
+      if(r0 + num_threads <= rows)
+        scan_row();
+      else
+        guarded(icmp_ult(row, i32(rows)), scan_row);
+    }
+    if(rows % num_threads == 0)
+      add_barrier();
+  }
+  else{
+    // threads past the last chunk read the first one,
+    // but do not write anything back
+    Value *valid = icmp_ult(thread, i32(num_chunks));
+    Value *start = mul(select(valid, thread, i32(0)), i32(C));
+    // scan within thread
+    std::vector<Value*> prefix(C);
+    for(unsigned k = 0; k < C; k++){
+      Value *val = load(gep(base, add(start, i32(k))));
+      prefix[k] = k == 0 ? val : do_acc(prefix[k - 1], val);
+    }
+    // scan of the totals of the chunks within warp (Kogge-Stone);
+    // chunks of a row are held by consecutive threads
+    unsigned width = std::min<unsigned>(chunks_per_row, 32);
+    Value *lane = urem(thread, i32(width));
+    Value *acc = prefix[C - 1];
+    for(unsigned i = 1; i < width; i *= 2){
+      Value *prev = shfl_up(acc, i);
+      acc = select(icmp(ICmpInst::ICMP_UGE, lane, i32(i)), do_acc(prev, acc), acc);
+    }
+    Value *carry = select(icmp_eq(lane, i32(0)), neutral, shfl_up(acc, 1));
+    // scan across warps
+    if(chunks_per_row > 32){
+      Value *totals = gep(base, i32(numel));
+      Value *warp = udiv(thread, i32(32));
+      guarded(icmp_eq(urem(thread, i32(32)), i32(31)), [&]() {
+        store(acc, gep(totals, warp));
+      });
+      unsigned warps_per_row = chunks_per_row / 32;
+      Value *first = mul(udiv(warp, i32(warps_per_row)), i32(warps_per_row));
+      Value *warp_in_row = urem(warp, i32(warps_per_row));
+      Value *warp_carry = neutral;
+      for(unsigned w = 0; w + 1 < warps_per_row; w++){
+        Value *total = load(gep(totals, add(first, i32(w))));
+        warp_carry = select(icmp_ult(i32(w), warp_in_row), do_acc(warp_carry, total), warp_carry);
+      }
+      carry = do_acc(warp_carry, carry);
+    }
+    // write back
+    guarded(valid, [&]() {
+      for(unsigned k = 0; k < C; k++)
+        store(do_acc(carry, prefix[k]), gep(base, add(start, i32(k))));
+    });
+  }
+  // read scanned block
+  for(indices_t idx: idxs_.at(x))
+    vals_[x][idx] = load(gep(base, offset(idx)));
+}
+
 /**
  * \brief Code Generation for `select`
  */
@@ -2232,6 +2727,10 @@ void generator::visit_make_range(ir::make_range* x) {
 }
 
 void generator::visit_undef_value(ir::undef_value *x) {
+  if(auto *st = dynamic_cast<ir::struct_type*>(x->get_type())){
+    structs_[x].assign(st->get_num_types(), {});
+    return;
+  }
   Type* ty = cvt(x->get_type()->get_scalar_ty());
   for(indices_t idx: idxs_.at(x))
     vals_[x][idx] = llvm::UndefValue::get(ty);
@@ -2259,8 +2758,74 @@ void generator::visit_alloc_const(ir::alloc_const *alloc) {
 }
 
 
+/**
+ * \brief Flattened per-thread elements of a value passed to or returned
+ *        from a device function
+ */
+std::vector<Value*> generator::flatten(ir::value* v) {
+  std::vector<Value*> result;
+  if(v->get_type()->is_struct_ty()){
+    for(const std::vector<Value*>& elts: structs_.at(v))
+      result.insert(result.end(), elts.begin(), elts.end());
+    return result;
+  }
+  for(indices_t idx: idxs_.at(v))
+    result.push_back(vals_[v][idx]);
+  return result;
+}
+
+/**
+ * \brief Declaration of a device function. Blocks are passed as the
+ *        elements owned by each thread, in the order given by their layout,
+ *        and results are returned as a single LLVM struct
+ */
+Function* generator::get_device_function(ir::function* fn) {
+  auto it = fns_.find(fn);
+  if(it != fns_.end())
+    return it->second;
+  std::vector<Type*> arg_tys;
+  for(ir::argument *arg: fn->args()){
+    init_idx(arg);
+    Type *ty = cvt(arg->get_type()->get_scalar_ty());
+    arg_tys.insert(arg_tys.end(), idxs_.at(arg).size(), ty);
+  }
+  Type *ret_ty = Type::getVoidTy(*ctx_);
+  if(!fn->get_fn_type()->get_return_ty()->is_void_ty()){
+    std::vector<Type*> elt_tys;
+    for(ir::value *v: ir::get_return_values(fn)){
+      if(!v)
+        continue;
+      init_idx(v);
+      elt_tys.insert(elt_tys.end(), idxs_.at(v).size(), cvt(v->get_type()->get_scalar_ty()));
+    }
+    ret_ty = StructType::get(*ctx_, elt_tys);
+  }
+  FunctionType *fn_ty = FunctionType::get(ret_ty, arg_tys, false);
+  return fns_[fn] = Function::Create(fn_ty, Function::InternalLinkage, fn->get_name(), mod_);
+}
+
 void generator::visit_function(ir::function* fn) {
   LLVMContext &ctx = builder_->getContext();
+  lazy_phi_incs_.clear();
+  if(!fn->is_kernel()){
+    Function *ret = get_device_function(fn);
+    for(ir::basic_block *block: fn->blocks())
+      bbs_[block] = BasicBlock::Create(ctx, block->get_name(), ret);
+    builder_->SetInsertPoint(bbs_[fn->blocks()[0]]);
+    for(auto x: layouts_->get_all())
+      visit_layout(x.second);
+    // set arguments
+    auto llvm_arg = ret->arg_begin();
+    for(ir::argument *arg: fn->args()){
+      init_idx(arg);
+      for(indices_t idx: idxs_.at(arg))
+        vals_[arg][idx] = &*llvm_arg++;
+    }
+    for(ir::basic_block *block: fn->blocks())
+      visit_basic_block(block);
+    finalize_function(fn);
+    return;
+  }
   FunctionType *fn_ty = (FunctionType*)cvt(fn->get_fn_type());
   if(!tgt_->is_gpu()){
     Type *fn_ret_ty = fn_ty->getReturnType();
@@ -2283,6 +2848,21 @@ void generator::visit_function(ir::function* fn) {
         ret->addAttribute(id, cvt(attr));
     }
   }
+  // pointer arguments
+  readonly_args_.clear();
+  alias_scopes_.clear();
+  llvm::MDBuilder md_builder(ctx);
+  llvm::MDNode* domain = nullptr;
+  for(ir::argument* arg: fn->args())
+  for(ir::attribute attr: fn->get_attributes(arg)){
+    if(attr.get_kind() == ir::readonly)
+      readonly_args_.insert(arg);
+    if(attr.get_kind() == ir::noalias){
+      if(!domain)
+        domain = md_builder.createAnonymousAliasScopeDomain(fn->get_name());
+      alias_scopes_[arg] = md_builder.createAnonymousAliasScope(domain, arg->get_name());
+    }
+  }
   // set metadata
   if(tgt_->is_gpu()){
       tgt_->set_kernel(*builder_, ctx, mod_, ret);
@@ -2730,9 +3310,14 @@ void generator::visit(ir::module &src, llvm::Module &dst) {
                          nullptr, "__shared_ptr", nullptr, GlobalVariable::NotThreadLocal, 3);
     shmem_ = bit_cast(sh_mem_array, ptr_ty);
   }
-  // visit functions
+  // visit kernels first so that arguments of device functions are
+  // declared with the layouts of the current thread indices
+  for(ir::function *fn: src.get_function_list())
+    if(fn->is_kernel())
+      visit_function(fn);
   for(ir::function *fn: src.get_function_list())
-    visit_function(fn);
+    if(!fn->is_kernel())
+      visit_function(fn);
 }
 
 
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <iostream>
+#include <limits>
 #include "triton/ir/utils.h"
 #include "triton/ir/instructions.h"
 #include "triton/ir/function.h"
@@ -16,40 +17,233 @@ coalesce::coalesce(analysis::align* align, analysis::layouts *layouts)
   : align_(align), layout_(layouts) { }
 
 
-// simplify layout conversions using the following simple rules:
-//   - cvt_1(cvt_2(x)) if convert1 is the inverse of convert2
-//   - cvt_1(elementwise(x, y)) = elementwise(convert(x), convert(y))
-//ir::value* coalesce::simplify(ir::instruction *inst, ir::builder& builder){
-//  ir::value* _op = inst->get_operand(0);
-//  ir::instruction* op = dynamic_cast<ir::instruction*>(_op);
-//  analysis::mma_layout* mma_in  = layout_->get(op)  ->to_mma();
-//  analysis::mma_layout* mma_out = layout_->get(inst)->to_mma();
-//  std::cout << 1 << std::endl;
-//  // i must be layout conversion instruction
-//  if(!mma_in && !mma_out)
-//    return inst;
-//  //   - cvt_1(cvt_2(x)) if convert1 is the inverse of convert2
-//  bool is_op_cvt = op->get_id() == ir::INST_CVT_LAYOUT;
-//  if((mma_in || mma_out) && is_op_cvt &&
-//     (layout_->get(inst) == layout_->get(op->get_operand(0))))
-//    return op->get_operand(0);
-//  //   - cvt_1(elementwise(x, y)) = elementwise(cvt_1(x), cvt_2(y))
-//  if(op->get_id() != ir::INST_BINOP && op->get_id() != ir::INST_GETELEMENTPTR)
-//    return inst;
-//  std::cout << 1 << std::endl;
-//  for(size_t i = 0; i < op->get_num_operands(); i++){
-//    ir::value* arg_i = op->get_operand(i);
-//    builder.set_insert_point(op);
-//    // create new layout transform
-//    ir::instruction* new_arg_i = inst->clone();
-//    builder.insert(new_arg_i);
-//    // set the right args
-//    new_arg_i->replace_uses_of_with(new_arg_i->get_operand(0), arg_i);
-//    op->replace_uses_of_with(arg_i, simplify(new_arg_i, builder));
-//  }
-//  std::cout << 2 << std::endl;
-//  return op;
-//}
+// cost of converting `v`: the number of bits that go through shared
+// memory, plus one per element so that ties favor fewer conversions
+static int cvt_cost(ir::value* v) {
+  ir::type* ty = v->get_type()->get_scalar_ty();
+  int bits = ty->is_pointer_ty() ? 64 : ty->get_primitive_size_in_bits();
+  return v->get_type()->get_tile_num_elements() * (bits + 1);
+}
+
+// cost of values that cannot be converted. sums of costs saturate
+// at this value, so that they never overflow
+static const int inf_cost = std::numeric_limits<int>::max() / 2;
+
+static bool is_elementwise(ir::value* v) {
+  return dynamic_cast<ir::binary_operator*>(v) ||
+         dynamic_cast<ir::cast_inst*>(v) ||
+         dynamic_cast<ir::cmp_inst*>(v) ||
+         dynamic_cast<ir::getelementptr_inst*>(v) ||
+         dynamic_cast<ir::select_inst*>(v) ||
+         dynamic_cast<ir::umulhi_inst*>(v) ||
+         dynamic_cast<ir::exp_inst*>(v) ||
+         dynamic_cast<ir::log_inst*>(v) ||
+         dynamic_cast<ir::cos_inst*>(v) ||
+         dynamic_cast<ir::sin_inst*>(v) ||
+         dynamic_cast<ir::sqrt_inst*>(v);
+}
+
+// boolean tiles are never moved through shared memory
+static bool can_convert(ir::value* v) {
+  ir::type* ty = v->get_type();
+  return ty->is_block_ty() && ty->get_tile_rank() == 2 && !ty->get_scalar_ty()->is_bool_ty();
+}
+
+// erase `v` and the pure operations that only it was using
+static void erase_if_dead(ir::value* v) {
+  auto* i = dynamic_cast<ir::instruction*>(v);
+  if(!i || !i->get_users().empty())
+    return;
+  if(!is_elementwise(i) && !dynamic_cast<ir::cvt_layout_inst*>(i) &&
+     !dynamic_cast<ir::retile_inst*>(i) && !dynamic_cast<ir::make_range*>(i))
+    return;
+  std::vector<ir::value*> ops = i->ops();
+  i->erase_from_parent();
+  for(ir::value* op: ops)
+    erase_if_dead(op);
+}
+
+// values that are cheaper to recompute in any layout than to convert:
+// ranges, splats of scalars, and element-wise / retile operations on them
+bool coalesce::is_rematerializable(ir::value* v, std::map<ir::value*, bool>& memo) {
+  if(!v->get_type()->is_block_ty() || dynamic_cast<ir::constant*>(v))
+    return true;
+  auto it = memo.find(v);
+  if(it != memo.end())
+    return it->second;
+  bool ret = dynamic_cast<ir::make_range*>(v) ||
+             dynamic_cast<ir::splat_inst*>(v) ||
+             dynamic_cast<ir::broadcast_inst*>(v) ||
+             dynamic_cast<ir::reshape_inst*>(v) ||
+             is_elementwise(v);
+  memo[v] = false;
+  if(ret)
+  for(ir::value* op: static_cast<ir::instruction*>(v)->ops())
+    ret = ret && is_rematerializable(op, memo);
+  memo[v] = ret;
+  return ret;
+}
+
+ir::value* coalesce::rematerialize(ir::value *x, ir::builder &builder,
+                                   std::map<ir::value*, ir::value*>& seen) {
+  if(!x->get_type()->is_block_ty() || dynamic_cast<ir::constant*>(x))
+    return x;
+  auto it = seen.find(x);
+  if(it != seen.end())
+    return it->second;
+  auto* i = static_cast<ir::instruction*>(x);
+  ir::instruction* ret = i->clone();
+  for(size_t k = 0; k < i->get_num_operands(); k++)
+    ret->set_operand(k, rematerialize(i->get_operand(k), builder, seen));
+  builder.insert(ret);
+  seen[x] = ret;
+  return ret;
+}
+
+// cost of obtaining `v` in another layout, if conversions are pushed
+// through the element-wise operations that only feed `v`. conversions
+// that become dead are counted as savings
+int coalesce::hoist_cost(ir::value* v, std::map<ir::value*, int>& costs,
+                         std::map<ir::value*, bool>& memo) {
+  if(is_rematerializable(v, memo))
+    return 0;
+  if(dynamic_cast<ir::cvt_layout_inst*>(v))
+    return v->get_users().size() == 1 ? -cvt_cost(v) : 0;
+  auto it = costs.find(v);
+  if(it != costs.end())
+    return it->second;
+  int ret = can_convert(v) ? cvt_cost(v) : inf_cost;
+  if(is_elementwise(v) && v->get_users().size() == 1){
+    std::set<ir::value*> args(static_cast<ir::instruction*>(v)->ops().begin(),
+                              static_cast<ir::instruction*>(v)->ops().end());
+    int sum = 0;
+    for(ir::value* arg: args)
+      sum = std::min(sum + hoist_cost(arg, costs, memo), inf_cost);
+    ret = std::min(ret, sum);
+  }
+  costs[v] = ret;
+  return ret;
+}
+
+// obtain `v` in another layout, following the choices of `hoist_cost`:
+// convert(elementwise(x, y)) = elementwise(convert(x), convert(y)),
+// convert(convert(x)) = x, convert(x) = x if x can be recomputed
+ir::value* coalesce::hoist(ir::value* v, ir::builder& builder, std::map<ir::value*, ir::value*>& seen,
+                           std::map<ir::value*, int>& costs, std::map<ir::value*, bool>& memo) {
+  if(is_rematerializable(v, memo))
+    return rematerialize(v, builder, seen);
+  if(auto* cvt = dynamic_cast<ir::cvt_layout_inst*>(v))
+    return cvt->get_operand(0);
+  auto it = seen.find(v);
+  if(it != seen.end())
+    return it->second;
+  ir::value* ret;
+  if(hoist_cost(v, costs, memo) < cvt_cost(v)){
+    auto* i = static_cast<ir::instruction*>(v);
+    ir::instruction* new_i = i->clone();
+    for(size_t k = 0; k < i->get_num_operands(); k++)
+      new_i->set_operand(k, hoist(i->get_operand(k), builder, seen, costs, memo));
+    ret = builder.insert(new_i);
+  }
+  else
+    ret = builder.insert(ir::cvt_layout_inst::create(v));
+  seen[v] = ret;
+  return ret;
+}
+
+bool coalesce::hoist(ir::cvt_layout_inst* cvt, ir::builder& builder) {
+  auto* op = dynamic_cast<ir::instruction*>(cvt->get_operand(0));
+  if(!op || !is_elementwise(op) || op->get_users().size() != 1)
+    return false;
+  std::map<ir::value*, int> costs;
+  std::map<ir::value*, bool> memo;
+  if(hoist_cost(op, costs, memo) >= cvt_cost(cvt))
+    return false;
+  builder.set_insert_point(op);
+  std::map<ir::value*, ir::value*> seen;
+  cvt->replace_all_uses_with(hoist(op, builder, seen, costs, memo));
+  erase_if_dead(cvt);
+  return true;
+}
+
+// elementwise(convert(x), convert(y)) = convert(elementwise(x, y))
+// when x and y live in the same layout
+bool coalesce::sink(ir::instruction* op, ir::builder& builder) {
+  if(!is_elementwise(op) || !can_convert(op))
+    return false;
+  std::set<ir::value*> args(op->ops().begin(), op->ops().end());
+  std::map<ir::value*, bool> memo;
+  int before = 0;
+  int after = cvt_cost(op);
+  analysis::data_layout* layout = nullptr;
+  for(ir::value* arg: args){
+    if(!arg->get_type()->is_block_ty())
+      continue;
+    if(auto* arg_cvt = dynamic_cast<ir::cvt_layout_inst*>(arg)){
+      ir::value* in = arg_cvt->get_operand(0);
+      if(arg->get_users().size() != 1 || !layout_->has(in))
+        return false;
+      if(layout && layout_->get(in)->get_order() != layout->get_order())
+        return false;
+      layout = layout_->get(in);
+      before += cvt_cost(arg);
+      continue;
+    }
+    if(!is_rematerializable(arg, memo))
+      return false;
+  }
+  if(after >= before)
+    return false;
+  // rewrite
+  builder.set_insert_point(op);
+  std::map<ir::value*, ir::value*> seen;
+  ir::instruction* new_op = op->clone();
+  for(size_t k = 0; k < op->get_num_operands(); k++){
+    ir::value* arg = op->get_operand(k);
+    ir::value* new_arg = arg;
+    if(auto* arg_cvt = dynamic_cast<ir::cvt_layout_inst*>(arg))
+      new_arg = arg_cvt->get_operand(0);
+    else
+      new_arg = rematerialize(arg, builder, seen);
+    new_op->set_operand(k, new_arg);
+  }
+  builder.insert(new_op);
+  ir::value* new_cvt = builder.insert(ir::cvt_layout_inst::create(new_op));
+  op->replace_all_uses_with(new_cvt);
+  erase_if_dead(op);
+  return true;
+}
+
+// move layout conversions through element-wise operations until their
+// total cost cannot be reduced anymore
+void coalesce::simplify(ir::module &mod) {
+  ir::builder& builder = mod.get_builder();
+  bool changed;
+  do{
+    changed = false;
+    std::vector<ir::instruction*> insts;
+    ir::for_each_instruction(mod, [&](ir::instruction* i){ insts.push_back(i); });
+    for(ir::instruction* i: insts){
+      // convert(convert(x)) = convert(x)
+      auto* cvt = dynamic_cast<ir::cvt_layout_inst*>(i);
+      if(cvt)
+      if(auto* op = dynamic_cast<ir::cvt_layout_inst*>(cvt->get_operand(0))){
+        cvt->replace_uses_of_with(op, op->get_operand(0));
+        erase_if_dead(op);
+        changed = true;
+        break;
+      }
+      if(cvt && hoist(cvt, builder)){
+        changed = true;
+        break;
+      }
+      if(!cvt && sink(i, builder)){
+        changed = true;
+        break;
+      }
+    }
+  }while(changed);
+}
 
 void coalesce::run(ir::module &mod) {
   ir::builder& builder = mod.get_builder();
@@ -80,6 +274,8 @@ void coalesce::run(ir::module &mod) {
 //        new_x->replace_uses_of_with(new_x, new_x);
     }
   }
+  // remove redundant conversions
+  simplify(mod);
   for(ir::function *fn: mod.get_function_list())
   for(ir::basic_block *block: fn->blocks())
   for(ir::instruction* i: block->get_inst_list()){
@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <stdexcept>
+#include "triton/codegen/transform/inline.h"
+#include "triton/ir/module.h"
+#include "triton/ir/function.h"
+#include "triton/ir/basic_block.h"
+#include "triton/ir/instructions.h"
+#include "triton/ir/builder.h"
+#include "triton/ir/utils.h"
+
+namespace triton {
+namespace codegen{
+namespace transform{
+
+inline ir::value* lookup(const std::map<ir::value*, ir::value*>& vmap, ir::value* v) {
+  auto it = vmap.find(v);
+  return it == vmap.end() ? v : it->second;
+}
+
+inline std::vector<ir::call_inst*> get_calls(ir::function* fn) {
+  std::vector<ir::call_inst*> result;
+  for(ir::basic_block* block: fn->blocks())
+  for(ir::instruction* i: block->get_inst_list())
+    if(auto* call = dynamic_cast<ir::call_inst*>(i))
+      result.push_back(call);
+  return result;
+}
+
+// instructions that would be duplicated at each call site
+inline int get_cost(ir::function* fn) {
+  int result = 0;
+  for(ir::basic_block* block: fn->blocks())
+  for(ir::instruction* i: block->get_inst_list())
+    if(!dynamic_cast<ir::terminator_inst*>(i) && !dynamic_cast<ir::insert_value_inst*>(i))
+      result++;
+  return result;
+}
+
+bool inliner::can_call(ir::function* fn) {
+  auto it = can_call_.find(fn);
+  if(it != can_call_.end())
+    return it->second;
+  can_call_[fn] = true;
+  bool ret = true;
+  int num_rets = 0;
+  for(ir::basic_block* block: fn->blocks())
+  for(ir::instruction* i: block->get_inst_list()){
+    if(auto* call = dynamic_cast<ir::call_inst*>(i)){
+      ret = ret && can_call(call->get_fn());
+      continue;
+    }
+    num_rets += dynamic_cast<ir::return_inst*>(i) != nullptr;
+    ret = ret && (dynamic_cast<ir::binary_operator*>(i) ||
+                  dynamic_cast<ir::cmp_inst*>(i) ||
+                  dynamic_cast<ir::cast_inst*>(i) ||
+                  dynamic_cast<ir::getelementptr_inst*>(i) ||
+                  dynamic_cast<ir::select_inst*>(i) ||
+                  dynamic_cast<ir::umulhi_inst*>(i) ||
+                  dynamic_cast<ir::exp_inst*>(i) ||
+                  dynamic_cast<ir::log_inst*>(i) ||
+                  dynamic_cast<ir::cos_inst*>(i) ||
+                  dynamic_cast<ir::sin_inst*>(i) ||
+                  dynamic_cast<ir::sqrt_inst*>(i) ||
+                  dynamic_cast<ir::splat_inst*>(i) ||
+                  dynamic_cast<ir::broadcast_inst*>(i) ||
+                  dynamic_cast<ir::reshape_inst*>(i) ||
+                  dynamic_cast<ir::make_range*>(i) ||
+                  dynamic_cast<ir::phi_node*>(i) ||
+                  dynamic_cast<ir::terminator_inst*>(i) ||
+                  dynamic_cast<ir::insert_value_inst*>(i) ||
+                  dynamic_cast<ir::extract_value_inst*>(i));
+  }
+  // the analyses of call sites assume a single return
+  return can_call_[fn] = ret && num_rets == 1;
+}
+
+bool inliner::should_inline(ir::call_inst* call, const std::map<ir::function*, int>& num_calls) {
+  ir::function* fn = call->get_fn();
+  if(!can_call(fn))
+    return true;
+  if(num_calls.at(fn) <= 1)
+    return true;
+  return get_cost(fn) <= threshold_;
+}
+
+void inliner::do_inline(ir::call_inst* call, ir::builder& builder) {
+  ir::function* fn = call->get_fn();
+  ir::basic_block* entry = call->get_parent();
+  ir::function* caller = entry->get_parent();
+  ir::context& ctx = entry->get_context();
+  std::map<ir::value*, ir::value*> vmap;
+  for(size_t k = 0; k < fn->args().size(); k++)
+    vmap[fn->args()[k]] = call->get_operand(k);
+  const auto& fn_blocks = fn->blocks();
+  std::vector<ir::value*> rets;
+  if(fn_blocks.size() == 1){
+    // straight-line callee: clone its body before the call
+    builder.set_insert_point(call);
+    for(ir::instruction* i: fn_blocks[0]->get_inst_list()){
+      if(dynamic_cast<ir::return_inst*>(i))
+        continue;
+      ir::instruction* c = i->clone();
+      for(unsigned k = 0; k < c->get_num_operands(); k++)
+        c->set_operand(k, lookup(vmap, i->get_operand(k)));
+      builder.insert(c);
+      vmap[i] = c;
+    }
+    for(ir::value* v: ir::get_return_values(fn))
+      rets.push_back(lookup(vmap, v));
+  }
+  else {
+    // split the block of the call site after the call
+    const auto& blocks = caller->blocks();
+    auto it = std::find(blocks.begin(), blocks.end(), entry);
+    ir::basic_block* next = std::next(it) == blocks.end() ? nullptr : *std::next(it);
+    ir::basic_block* exit = ir::basic_block::create(ctx, entry->get_name() + ".cont", caller, next);
+    auto& insts = entry->get_inst_list();
+    std::vector<ir::instruction*> moved(std::next(std::find(insts.begin(), insts.end(), call)), insts.end());
+    for(ir::instruction* i: moved){
+      entry->erase(i);
+      exit->get_inst_list().push_back(i);
+      i->set_parent(exit);
+    }
+    std::vector<ir::basic_block*> succs = entry->get_successors();
+    for(ir::basic_block* succ: succs){
+      succ->remove_predecessor(entry);
+      succ->add_predecessor(exit);
+      for(ir::instruction* i: succ->get_inst_list())
+      if(auto* phi = dynamic_cast<ir::phi_node*>(i))
+      for(unsigned n = 0; n < phi->get_num_incoming(); n++)
+        if(phi->get_incoming_block(n) == entry)
+          phi->set_incoming_block(n, exit);
+    }
+    // clone the blocks of the callee between the two halves
+    for(ir::basic_block* block: fn_blocks)
+      vmap[block] = ir::basic_block::create(ctx, block->get_name(), caller, exit);
+    std::vector<std::pair<ir::instruction*, ir::instruction*>> clones;
+    std::vector<std::pair<ir::return_inst*, ir::basic_block*>> exits;
+    for(ir::basic_block* block: fn_blocks){
+      builder.set_insert_point((ir::basic_block*)vmap.at(block));
+      for(ir::instruction* i: block->get_inst_list()){
+        if(auto* ret = dynamic_cast<ir::return_inst*>(i)){
+          exits.push_back({ret, builder.get_insert_block()});
+          builder.create_br(exit);
+          continue;
+        }
+        ir::instruction* c = i->clone();
+        builder.insert(c);
+        vmap[i] = c;
+        clones.push_back({i, c});
+      }
+    }
+    if(exits.empty())
+      throw std::runtime_error("device functions must return");
+    // operands may be defined in blocks that were cloned later
+    for(auto& x: clones){
+      for(unsigned k = 0; k < x.second->get_num_operands(); k++)
+        x.second->set_operand(k, lookup(vmap, x.first->get_operand(k)));
+      if(auto* phi = dynamic_cast<ir::phi_node*>(x.first))
+      for(unsigned n = 0; n < phi->get_num_incoming(); n++)
+        ((ir::phi_node*)x.second)->set_incoming_block(n, (ir::basic_block*)vmap.at(phi->get_incoming_block(n)));
+    }
+    for(ir::basic_block* block: fn_blocks)
+    for(ir::basic_block* pred: block->get_predecessors())
+      ((ir::basic_block*)vmap.at(block))->add_predecessor((ir::basic_block*)vmap.at(pred));
+    // merge the values returned on each path
+    std::vector<std::vector<ir::value*>> vals;
+    for(auto& x: exits)
+      vals.push_back(ir::get_return_values(x.first));
+    builder.set_insert_point(exit->get_first_non_phi());
+    for(size_t k = 0; k < vals[0].size(); k++){
+      bool defined = true;
+      for(auto& v: vals)
+        defined = defined && v[k];
+      if(!defined || exits.size() == 1){
+        rets.push_back(defined ? lookup(vmap, vals[0][k]) : nullptr);
+        continue;
+      }
+      ir::phi_node* phi = builder.create_phi(vals[0][k]->get_type(), exits.size());
+      for(size_t n = 0; n < exits.size(); n++)
+        phi->add_incoming(lookup(vmap, vals[n][k]), exits[n].second);
+      rets.push_back(phi);
+    }
+    builder.set_insert_point(entry);
+    builder.create_br((ir::basic_block*)vmap.at(fn_blocks[0]));
+  }
+  // forward the returned values
+  if(call->get_type()->is_struct_ty()){
+    std::vector<ir::user*> users(call->get_users().begin(), call->get_users().end());
+    for(ir::user* u: users){
+      auto* x = dynamic_cast<ir::extract_value_inst*>(u);
+      if(!x || !rets.at(x->get_idx()))
+        throw std::runtime_error("unsupported use of an aggregate return value");
+      x->replace_all_uses_with(rets[x->get_idx()]);
+      x->erase_from_parent();
+    }
+  }
+  else if(!rets.empty())
+    call->replace_all_uses_with(rets[0]);
+  call->erase_from_parent();
+}
+
+void inliner::run(ir::module &mod) {
+  ir::builder& builder = mod.get_builder();
+  can_call_.clear();
+  std::vector<ir::function*>& fns = mod.get_function_list();
+  // inline until all remaining call sites are worth keeping
+  bool changed;
+  do{
+    changed = false;
+    std::map<ir::function*, int> num_calls;
+    for(ir::function* fn: fns)
+    for(ir::call_inst* call: get_calls(fn))
+      num_calls[call->get_fn()]++;
+    for(ir::function* fn: fns)
+    for(ir::call_inst* call: get_calls(fn))
+      if(should_inline(call, num_calls)){
+        do_inline(call, builder);
+        changed = true;
+      }
+  }while(changed);
+  // remove device functions that are not called anymore
+  std::vector<ir::function*> dead;
+  do{
+    std::set<ir::function*> called;
+    for(ir::function* fn: fns)
+    for(ir::call_inst* call: get_calls(fn))
+      called.insert(call->get_fn());
+    dead.clear();
+    for(ir::function* fn: fns)
+      if(!fn->is_kernel() && called.find(fn) == called.end())
+        dead.push_back(fn);
+    for(ir::function* fn: dead)
+      mod.remove_function(fn);
+  }while(!dead.empty());
+}
+
+}
+}
+}
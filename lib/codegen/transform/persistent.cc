@@ -0,0 +1,143 @@
+#include <algorithm>
+#include "triton/codegen/transform/persistent.h"
+#include "triton/ir/module.h"
+#include "triton/ir/function.h"
+#include "triton/ir/basic_block.h"
+#include "triton/ir/instructions.h"
+#include "triton/ir/builder.h"
+
+namespace triton {
+namespace codegen{
+namespace transform{
+
+// instructions without side effects whose result
+// only depends on values defined outside of the loop
+bool persistent::is_invariant(ir::instruction* i, const std::set<ir::basic_block*>& loop) {
+  bool is_pure = dynamic_cast<ir::binary_operator*>(i) ||
+                 dynamic_cast<ir::cmp_inst*>(i) ||
+                 dynamic_cast<ir::cast_inst*>(i) ||
+                 dynamic_cast<ir::getelementptr_inst*>(i) ||
+                 dynamic_cast<ir::splat_inst*>(i) ||
+                 dynamic_cast<ir::broadcast_inst*>(i) ||
+                 dynamic_cast<ir::reshape_inst*>(i) ||
+                 dynamic_cast<ir::make_range*>(i);
+  if(!is_pure)
+    return false;
+  for(ir::value* op: i->ops()){
+    auto* op_inst = dynamic_cast<ir::instruction*>(op);
+    if(op_inst && loop.find(op_inst->get_parent()) != loop.end())
+      return false;
+  }
+  return true;
+}
+
+void persistent::run(ir::function* fn) {
+  // size of the virtual grid
+  ir::value* grid[3] = {nullptr, nullptr, nullptr};
+  bool found = false;
+  for(ir::argument* arg: fn->args())
+  for(ir::attribute attr: fn->get_attributes(arg))
+    if(attr.get_kind() == ir::num_programs && attr.get_value() < 3){
+      grid[attr.get_value()] = arg;
+      found = true;
+    }
+  if(!found)
+    return;
+  ir::builder& builder = fn->get_parent()->get_builder();
+  ir::basic_block* entry = fn->blocks()[0];
+  ir::context& ctx = entry->get_context();
+  int rank = 0;
+  for(int d = 0; d < 3; d++){
+    if(grid[d])
+      rank = d + 1;
+    else
+      grid[d] = builder.get_int32(1);
+  }
+  // collect instructions to rewrite
+  std::vector<ir::get_program_id_inst*> pids;
+  std::vector<ir::get_num_programs_inst*> nums;
+  std::vector<ir::return_inst*> rets;
+  std::set<ir::basic_block*> loop;
+  for(ir::basic_block* block: fn->blocks()){
+    loop.insert(block);
+    for(ir::instruction* i: block->get_inst_list()){
+      if(auto* x = dynamic_cast<ir::get_program_id_inst*>(i))
+        pids.push_back(x);
+      if(auto* x = dynamic_cast<ir::get_num_programs_inst*>(i))
+        nums.push_back(x);
+      if(auto* x = dynamic_cast<ir::return_inst*>(i))
+        rets.push_back(x);
+    }
+  }
+  ir::basic_block* preheader = ir::basic_block::create(ctx, "persistent.preheader", fn, entry);
+  ir::basic_block* latch = ir::basic_block::create(ctx, "persistent.latch", fn);
+  ir::basic_block* exit = ir::basic_block::create(ctx, "persistent.exit", fn);
+  loop.insert(latch);
+  // the programs that were actually launched
+  // start at their id and stride over all tiles
+  builder.set_insert_point(preheader);
+  ir::value* start = builder.create_get_program_id(0);
+  ir::value* step = builder.create_get_num_programs(0);
+  ir::value* total = grid[0];
+  for(int d = 1; d < rank; d++)
+    total = builder.create_mul(total, grid[d]);
+  builder.create_cond_br(builder.create_icmpSLT(start, total), entry, exit);
+  // coordinates of the current tile
+  builder.set_insert_point(entry->get_first_non_phi());
+  ir::phi_node* tile = builder.create_phi(builder.get_int32_ty(), 2);
+  tile->add_incoming(start, preheader);
+  // tiles are numbered along the first axis first
+  ir::value* coords[3];
+  ir::value* rest = tile;
+  for(int d = 0; d < 3; d++){
+    if(d >= rank)
+      coords[d] = builder.get_int32(0);
+    else if(d == rank - 1)
+      coords[d] = rest;
+    else{
+      coords[d] = builder.create_srem(rest, grid[d]);
+      rest = builder.create_sdiv(rest, grid[d]);
+    }
+  }
+  for(ir::get_program_id_inst* x: pids){
+    x->replace_all_uses_with(coords[x->get_axis()]);
+    x->erase_from_parent();
+  }
+  for(ir::get_num_programs_inst* x: nums){
+    x->replace_all_uses_with(grid[x->get_axis()]);
+    x->erase_from_parent();
+  }
+  // move on to the next tile instead of returning
+  for(ir::return_inst* x: rets){
+    builder.set_insert_point(x);
+    builder.create_br(latch);
+    x->erase_from_parent();
+  }
+  builder.set_insert_point(latch);
+  ir::value* next = builder.create_add(tile, step);
+  builder.create_cond_br(builder.create_icmpSLT(next, total), entry, exit);
+  tile->add_incoming(next, latch);
+  builder.set_insert_point(exit);
+  builder.create_ret_void();
+  // the entry block is executed for every tile: setup code that
+  // does not depend on the tile is only executed once per program
+  ir::instruction* term = preheader->get_inst_list().back();
+  std::vector<ir::instruction*> insts(entry->begin(), entry->end());
+  for(ir::instruction* i: insts){
+    if(!is_invariant(i, loop))
+      continue;
+    entry->erase(i);
+    builder.set_insert_point(term);
+    builder.insert(i);
+  }
+}
+
+void persistent::run(ir::module &mod) {
+  for(ir::function* fn: mod.get_function_list())
+    if(fn->is_kernel())
+      run(fn);
+}
+
+}
+}
+}
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <algorithm>
+#include <map>
 #include "triton/ir/module.h"
 #include "triton/ir/function.h"
 #include "triton/ir/basic_block.h"
@@ -10,40 +11,123 @@ namespace triton {
 namespace codegen{
 namespace transform{
 
-void reorder::run(ir::module& mod){
-//    ir::builder &builder = mod.get_builder();
-//    std::vector<std::pair<ir::instruction*, ir::value*>> to_replace;
-
-//    for(ir::function *fn: mod.get_function_list())
-//    for(ir::basic_block *block: fn->blocks())
-//    for(ir::instruction* i: block->get_inst_list()){
-//      if(auto* ld = dynamic_cast<ir::masked_load_inst*>(i)){
-//        ir::value* _ptr = ld->get_pointer_operand();
-//        ir::value* _msk = ld->get_mask_operand();
-//        ir::value* _val = ld->get_false_value_operand();
-//        auto ptr = std::find(block->begin(), block->end(), _ptr);
-//        auto msk = std::find(block->begin(), block->end(), _msk);
-//        auto val = std::find(block->begin(), block->end(), _val);
-//        if(ptr == block->end() || msk == block->end() || val == block->end())
-//          continue;
-//        auto it = std::find(block->begin(), block->end(), i);
-//        int dist_ptr = std::distance(ptr, it);
-//        int dist_msk = std::distance(msk, it);
-//        int dist_val = std::distance(val, it);
-//        if(dist_ptr < dist_msk && dist_ptr < dist_val)
-//          builder.set_insert_point(++ptr);
-//        if(dist_msk < dist_ptr && dist_msk < dist_val)
-//          builder.set_insert_point(++msk);
-//        if(dist_val < dist_ptr && dist_val < dist_msk)
-//          builder.set_insert_point(++val);
-//        ir::value* new_ld = builder.create_masked_load(_ptr, _msk, _val);
-//        to_replace.push_back(std::make_pair(ld, new_ld));
-//      }
-//    }
-
-//    for(auto& x: to_replace)
-//      x.first->replace_all_uses_with(x.second);
+inline bool is_load(ir::instruction* i) {
+  return i->get_id() == ir::INST_MASKED_LOAD ||
+         i->get_id() == ir::INST_UNMASKED_LOAD;
+}
+
+// loads may not be moved above these
+inline bool is_fence(ir::instruction* i) {
+  switch(i->get_id()){
+    case ir::INST_UNMASKED_STORE:
+    case ir::INST_MASKED_STORE:
+    case ir::INST_ATOMIC_CAS:
+    case ir::INST_ATOMIC_EXCH:
+    case ir::INST_ATOMIC_RMW:
+    case ir::INST_BARRIER:
+    case ir::INST_ASYNC_WAIT:
+    // device functions that are not inlined may have side-effects
+    case ir::INST_CALL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// number of 32-bit registers per thread needed to hold v
+unsigned reorder::num_regs(ir::value* v) {
+  ir::type* ty = v->get_type();
+  if(ty->is_void_ty())
+    return 0;
+  ir::type* scalar_ty = ty->get_scalar_ty();
+  unsigned bits = scalar_ty->is_pointer_ty() ? 64 : scalar_ty->get_primitive_size_in_bits();
+  unsigned numel = ty->is_block_ty() ? ty->get_tile_num_elements() : 1;
+  unsigned num_threads = 32 * num_warps_;
+  unsigned regs = (numel * bits / 32 + num_threads - 1) / num_threads;
+  return std::max<unsigned>(regs, 1);
+}
 
+// estimated register pressure before each instruction of `block`
+std::vector<unsigned> reorder::pressure(const std::vector<ir::instruction*>& insts, ir::basic_block* block) {
+  int n = insts.size();
+  std::map<ir::value*, int> pos;
+  for(int k = 0; k < n; k++)
+    pos[insts[k]] = k;
+  // live ranges
+  std::map<ir::value*, std::pair<int, int>> live;
+  for(int k = 0; k < n; k++){
+    ir::instruction* i = insts[k];
+    // values defined in other blocks are live-in
+    for(ir::value* op: i->ops()){
+      if(pos.find(op) != pos.end() || dynamic_cast<ir::basic_block*>(op))
+        continue;
+      auto it = live.insert({op, {-1, k}}).first;
+      it->second.second = std::max(it->second.second, k);
+    }
+    if(i->get_users().empty())
+      continue;
+    int last = k;
+    for(ir::user* u: i->get_users()){
+      auto* ui = dynamic_cast<ir::instruction*>(u);
+      bool local = ui && ui->get_parent() == block && !dynamic_cast<ir::phi_node*>(ui);
+      last = std::max(last, local ? pos.at(ui) : n - 1);
+    }
+    live[i] = {k, last};
+  }
+  std::vector<unsigned> result(n, 0);
+  for(auto& x: live){
+    unsigned regs = num_regs(x.first);
+    for(int k = x.second.first + 1; k <= x.second.second; k++)
+      result[k] += regs;
+  }
+  return result;
+}
+
+void reorder::hoist(ir::instruction* ld, ir::basic_block* block, ir::module& mod) {
+  std::vector<ir::instruction*> insts(block->begin(), block->end());
+  int curr = std::find(insts.begin(), insts.end(), ld) - insts.begin();
+  int first = std::find(insts.begin(), insts.end(), *block->get_first_non_phi()) - insts.begin();
+  // earliest legal position: after the last operand
+  // and after the last memory side-effect
+  int earliest = first;
+  for(int k = curr - 1; k >= first; k--){
+    ir::instruction* i = insts[k];
+    bool is_op = std::find(ld->op_begin(), ld->op_end(), i) != ld->op_end();
+    if(is_op || is_fence(i)){
+      earliest = k + 1;
+      break;
+    }
+  }
+  // keep loads hoisted to the same place grouped in program order
+  while(earliest < curr && is_load(insts[earliest]))
+    earliest++;
+  if(earliest >= curr)
+    return;
+  // do not extend the live range of the loaded value
+  // over instructions where the register budget is exhausted
+  std::vector<unsigned> live = pressure(insts, block);
+  unsigned cost = num_regs(ld);
+  int dst = curr;
+  while(dst > earliest && live[dst - 1] + cost <= (unsigned)max_regs_)
+    dst--;
+  if(dst == curr)
+    return;
+  ir::builder& builder = mod.get_builder();
+  builder.set_insert_point(insts[dst]);
+  block->erase(ld);
+  builder.insert(ld);
+}
+
+void reorder::run(ir::module& mod){
+  for(ir::function *fn: mod.get_function_list())
+  for(ir::basic_block *block: fn->blocks()){
+    std::vector<ir::instruction*> loads;
+    for(ir::instruction* i: block->get_inst_list())
+      if(is_load(i))
+        loads.push_back(i);
+    for(ir::instruction* ld: loads)
+      hoist(ld, block, mod);
+  }
 }
 
 }
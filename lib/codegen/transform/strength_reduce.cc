@@ -0,0 +1,149 @@
+#include <vector>
+#include "triton/codegen/transform/strength_reduce.h"
+#include "triton/ir/module.h"
+#include "triton/ir/function.h"
+#include "triton/ir/basic_block.h"
+#include "triton/ir/instructions.h"
+#include "triton/ir/builder.h"
+#include "triton/ir/utils.h"
+
+namespace triton {
+namespace codegen{
+namespace transform{
+
+// returns the scalar integer broadcast by `v`, if any
+static ir::value* get_splat_int(ir::value* v) {
+  auto* splat = dynamic_cast<ir::splat_inst*>(v);
+  if(!splat)
+    return nullptr;
+  ir::value* arg = splat->get_operand(0);
+  if(arg->get_type()->is_block_ty() || !arg->get_type()->is_integer_ty())
+    return nullptr;
+  return arg;
+}
+
+// `v` is gep(phi, splat(stride))
+bool strength_reduce::get_stride(ir::value *v, ir::phi_node *phi, ir::value *&stride) {
+  auto* gep = dynamic_cast<ir::getelementptr_inst*>(v);
+  if(!gep || gep->get_pointer_operand() != phi || gep->get_num_operands() != 2)
+    return false;
+  stride = get_splat_int(*gep->idx_begin());
+  return stride != nullptr;
+}
+
+// write `ptr` as gep(splat(base), offs); scalar increments
+// of the form gep(ptr, splat(inc)) are folded into base
+bool strength_reduce::decompose(ir::value *ptr, ir::builder &builder,
+                                std::pair<ir::value*, ir::value*> &result) {
+  auto* gep = dynamic_cast<ir::getelementptr_inst*>(ptr);
+  if(!gep || gep->get_num_operands() != 2)
+    return false;
+  ir::value* base = gep->get_pointer_operand();
+  ir::value* idx = *gep->idx_begin();
+  if(auto* splat = dynamic_cast<ir::splat_inst*>(base)){
+    ir::value* arg = splat->get_operand(0);
+    if(arg->get_type()->is_block_ty())
+      return false;
+    result = {arg, idx};
+    return true;
+  }
+  ir::value* inc = get_splat_int(idx);
+  if(!inc || !decompose(base, builder, result))
+    return false;
+  builder.set_insert_point(gep);
+  result.first = builder.create_gep(result.first, {inc});
+  return true;
+}
+
+bool strength_reduce::rewrite(ir::phi_node *phi, ir::builder &builder) {
+  ir::type* ty = phi->get_type();
+  if(!ty->is_block_ty() || !ty->get_scalar_ty()->is_pointer_ty())
+    return false;
+  if(phi->get_num_incoming() != 2)
+    return false;
+  // find loop-carried increment
+  ir::value* stride = nullptr;
+  int latch_idx = -1;
+  for(unsigned n = 0; n < 2; n++)
+    if(get_stride(phi->get_incoming_value(n), phi, stride)){
+      latch_idx = n;
+      break;
+    }
+  if(latch_idx < 0)
+    return false;
+  auto* latch = static_cast<ir::instruction*>(phi->get_incoming_value(latch_idx));
+  ir::basic_block* latch_block = phi->get_incoming_block(latch_idx);
+  ir::value* init = phi->get_incoming_value(1 - latch_idx);
+  ir::basic_block* init_block = phi->get_incoming_block(1 - latch_idx);
+  // classify users
+  std::vector<ir::user*> phi_users;
+  std::vector<ir::user*> latch_users;
+  bool has_direct_use = false;
+  for(ir::user* u: phi->get_users()){
+    if(u == latch)
+      continue;
+    phi_users.push_back(u);
+    ir::value* inc;
+    has_direct_use = has_direct_use || !get_stride(u, phi, inc);
+  }
+  for(ir::user* u: latch->get_users())
+    if(u != phi)
+      latch_users.push_back(u);
+  // the incremented tile would have to be rebuilt twice
+  // per iteration. keep the original induction variable
+  if(has_direct_use && !latch_users.empty())
+    return false;
+  std::pair<ir::value*, ir::value*> base_offs;
+  if(!decompose(init, builder, base_offs))
+    return false;
+  ir::value* base = base_offs.first;
+  ir::value* offs = base_offs.second;
+  auto shape = ty->get_block_shapes();
+  // scalar induction variable
+  builder.set_insert_point(phi);
+  ir::phi_node* new_phi = builder.create_phi(base->get_type(), 2);
+  builder.set_insert_point(latch);
+  ir::value* next = builder.create_gep(new_phi, {stride});
+  new_phi->add_incoming(base, init_block);
+  new_phi->add_incoming(next, latch_block);
+  // rebuild uses of the original induction variable
+  ir::value* tile = nullptr;
+  for(ir::user* u: phi_users){
+    ir::value* inc;
+    if(get_stride(u, phi, inc)){
+      auto* i = static_cast<ir::instruction*>(u);
+      builder.set_insert_point(i);
+      ir::value* ptr = builder.create_gep(new_phi, {inc});
+      i->replace_all_uses_with(builder.create_gep(builder.create_splat(ptr, shape), {offs}));
+      continue;
+    }
+    if(!tile){
+      builder.set_insert_point(phi->get_parent()->get_first_non_phi());
+      tile = builder.create_gep(builder.create_splat(new_phi, shape), {offs});
+    }
+    u->replace_uses_of_with(phi, tile);
+  }
+  if(!latch_users.empty()){
+    builder.set_insert_point(latch);
+    ir::value* next_tile = builder.create_gep(builder.create_splat(next, shape), {offs});
+    for(ir::user* u: latch_users)
+      u->replace_uses_of_with(latch, next_tile);
+  }
+  return true;
+}
+
+void strength_reduce::run(ir::module &mod) {
+  ir::builder &builder = mod.get_builder();
+  std::vector<ir::phi_node*> phis;
+  ir::for_each_instruction(mod, [&](ir::instruction *i){
+    if(auto* phi = dynamic_cast<ir::phi_node*>(i))
+      phis.push_back(phi);
+  });
+  // original phi nodes and increments are cleaned up by dce
+  for(ir::phi_node* phi: phis)
+    rewrite(phi, builder);
+}
+
+}
+}
+}
@@ -0,0 +1,72 @@
+#include <vector>
+#include "triton/codegen/transform/unmask.h"
+#include "triton/codegen/analysis/range.h"
+#include "triton/ir/module.h"
+#include "triton/ir/function.h"
+#include "triton/ir/basic_block.h"
+#include "triton/ir/instructions.h"
+#include "triton/ir/builder.h"
+#include "triton/ir/utils.h"
+
+namespace triton {
+namespace codegen{
+namespace transform{
+
+// returns nullptr if `mask` is always true, and
+// `mask` stripped of its always-true conjuncts otherwise
+ir::value* unmask::simplify(ir::value* mask) {
+  if(range_->is_always_true(mask))
+    return nullptr;
+  auto* bin = dynamic_cast<ir::binary_operator*>(mask);
+  if(!bin || bin->get_op() != ir::And)
+    return mask;
+  ir::value* lhs = simplify(bin->get_operand(0));
+  ir::value* rhs = simplify(bin->get_operand(1));
+  if(!lhs)
+    return rhs;
+  if(!rhs)
+    return lhs;
+  return mask;
+}
+
+void unmask::run(ir::module &mod) {
+  ir::builder &builder = mod.get_builder();
+  std::vector<ir::instruction*> to_visit;
+  ir::for_each_instruction(mod, [&](ir::instruction* i){
+    if(i->get_id() == ir::INST_MASKED_LOAD || i->get_id() == ir::INST_MASKED_STORE)
+      to_visit.push_back(i);
+  });
+  for(ir::instruction* i: to_visit){
+    // masked load
+    if(auto* ld = dynamic_cast<ir::masked_load_inst*>(i)){
+      ir::value* mask = simplify(ld->get_mask_operand());
+      if(mask == ld->get_mask_operand())
+        continue;
+      builder.set_insert_point(ld);
+      ir::value* new_ld;
+      if(mask)
+        new_ld = builder.create_masked_load(ld->get_pointer_operand(), mask, ld->get_false_value_operand(),
+                                            ld->get_cache_modifier());
+      else
+        new_ld = builder.create_load(ld->get_pointer_operand(), ld->get_cache_modifier());
+      ld->replace_all_uses_with(new_ld);
+      ld->erase_from_parent();
+    }
+    // masked store
+    if(auto* st = dynamic_cast<ir::masked_store_inst*>(i)){
+      ir::value* mask = simplify(st->get_mask_operand());
+      if(mask == st->get_mask_operand())
+        continue;
+      builder.set_insert_point(st);
+      if(mask)
+        builder.create_masked_store(st->get_pointer_operand(), st->get_value_operand(), mask);
+      else
+        builder.create_store(st->get_pointer_operand(), st->get_value_operand());
+      st->erase_from_parent();
+    }
+  }
+}
+
+}
+}
+}
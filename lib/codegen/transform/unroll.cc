@@ -0,0 +1,266 @@
+#include <algorithm>
+#include "triton/codegen/transform/unroll.h"
+#include "triton/ir/module.h"
+#include "triton/ir/function.h"
+#include "triton/ir/basic_block.h"
+#include "triton/ir/instructions.h"
+#include "triton/ir/constant.h"
+#include "triton/ir/builder.h"
+
+namespace triton {
+namespace codegen{
+namespace transform{
+
+inline int64_t get_signed(ir::constant_int* x) {
+  unsigned bw = x->get_type()->get_integer_bitwidth();
+  uint64_t value = x->get_value();
+  if(bw >= 64)
+    return (int64_t)value;
+  return (int64_t)(value << (64 - bw)) >> (64 - bw);
+}
+
+inline ir::value* lookup(const std::map<ir::value*, ir::value*>& vmap, ir::value* v) {
+  auto it = vmap.find(v);
+  return it == vmap.end() ? v : it->second;
+}
+
+// loop conditions are built as where(step > 0, i < end, i > end)
+inline ir::value* fold_select(ir::value* cond) {
+  while(auto* sel = dynamic_cast<ir::select_inst*>(cond)){
+    auto* pred = dynamic_cast<ir::constant_int*>(sel->get_pred_op());
+    if(!pred)
+      break;
+    cond = pred->get_value() ? sel->get_if_value_op() : sel->get_else_value_op();
+  }
+  return cond;
+}
+
+inline std::vector<ir::phi_node*> get_phis(ir::basic_block* block) {
+  std::vector<ir::phi_node*> result;
+  for(ir::instruction* i: block->get_inst_list())
+    if(auto* phi = dynamic_cast<ir::phi_node*>(i))
+      result.push_back(phi);
+  return result;
+}
+
+// non-phi instructions, without the terminator
+inline std::vector<ir::instruction*> get_body(ir::basic_block* block) {
+  std::vector<ir::instruction*> result;
+  for(ir::instruction* i: block->get_inst_list())
+    if(!dynamic_cast<ir::phi_node*>(i) && i != block->get_inst_list().back())
+      result.push_back(i);
+  return result;
+}
+
+inline bool has_mask(const std::vector<ir::instruction*>& insts) {
+  for(ir::instruction* i: insts)
+    if(i->get_id() == ir::INST_MASKED_LOAD || i->get_id() == ir::INST_MASKED_STORE)
+      return true;
+  return false;
+}
+
+// redirect the values that flow from `block` to phi nodes of `exit`
+inline void update_exit_phis(ir::basic_block* block, ir::basic_block* exit,
+                             const std::map<ir::value*, ir::value*>& vmap,
+                             ir::basic_block* new_block) {
+  for(ir::instruction* i: exit->get_inst_list()){
+    auto* phi = dynamic_cast<ir::phi_node*>(i);
+    if(!phi)
+      continue;
+    for(unsigned n = 0; n < phi->get_num_incoming(); n++){
+      if(phi->get_incoming_block(n) != block)
+        continue;
+      ir::value* v = phi->get_incoming_value(n);
+      ir::value* new_v = lookup(vmap, v);
+      if(new_v != v)
+        phi->replace_uses_of_with(v, new_v);
+      phi->set_incoming_block(n, new_block);
+    }
+  }
+}
+
+bool unroll::get_loop_info(ir::basic_block* block, loop_info_t& info) {
+  auto* br = dynamic_cast<ir::cond_branch_inst*>(block->get_inst_list().back());
+  if(!br || br->get_true_dest() != block || br->get_false_dest() == block)
+    return false;
+  const auto& preds = block->get_predecessors();
+  if(preds.size() != 2 || preds[0] == preds[1])
+    return false;
+  ir::basic_block* pre = preds[0] == block ? preds[1] : preds[0];
+  // loop condition: iv + step < end
+  auto* cmp = dynamic_cast<ir::icmp_inst*>(fold_select(br->get_cond()));
+  if(!cmp)
+    return false;
+  auto* next = dynamic_cast<ir::binary_operator*>(cmp->get_operand(0));
+  auto* end = dynamic_cast<ir::constant_int*>(cmp->get_operand(1));
+  if(!next || !end || next->get_op() != ir::Add || next->get_parent() != block)
+    return false;
+  auto* iv = dynamic_cast<ir::phi_node*>(next->get_operand(0));
+  auto* step = dynamic_cast<ir::constant_int*>(next->get_operand(1));
+  if(!iv || !step || iv->get_parent() != block || iv->get_num_incoming() != 2)
+    return false;
+  if(iv->get_value_for_block(block) != next)
+    return false;
+  auto* start = dynamic_cast<ir::constant_int*>(iv->get_value_for_block(pre));
+  if(!start)
+    return false;
+  info = {pre, block, br->get_false_dest(), iv, get_signed(start), get_signed(step), get_signed(end)};
+  bool fwd = info.step > 0 && cmp->get_pred() == ir::ICMP_SLT;
+  bool bwd = info.step < 0 && cmp->get_pred() == ir::ICMP_SGT;
+  if(!fwd && !bwd)
+    return false;
+  // values defined in the loop may only escape through phi nodes of the exit block
+  for(ir::instruction* i: block->get_inst_list())
+  for(ir::user* u: i->get_users()){
+    auto* ui = dynamic_cast<ir::instruction*>(u);
+    if(!ui)
+      return false;
+    if(ui->get_parent() == block)
+      continue;
+    if(!dynamic_cast<ir::phi_node*>(ui) || ui->get_parent() != info.exit)
+      return false;
+  }
+  return true;
+}
+
+int64_t unroll::get_trip_count(const loop_info_t& info) {
+  int64_t dist = info.step > 0 ? info.end - info.start : info.start - info.end;
+  int64_t step = std::abs(info.step);
+  // the body is executed at least once when the loop is entered
+  return std::max<int64_t>((dist + step - 1) / step, 1);
+}
+
+// clone `insts`, replacing operands according to `phis`
+unroll::value_map_t unroll::clone_body(const std::vector<ir::instruction*>& insts, const value_map_t& phis,
+                                       ir::builder& builder) {
+  value_map_t vmap = phis;
+  for(ir::instruction* i: insts){
+    ir::instruction* c = i->clone();
+    for(unsigned k = 0; k < c->get_num_operands(); k++)
+      c->set_operand(k, lookup(vmap, i->get_operand(k)));
+    builder.insert(c);
+    vmap[i] = c;
+  }
+  return vmap;
+}
+
+// values of the phi nodes of `block` at the next iteration
+unroll::value_map_t unroll::next_iteration(ir::basic_block* block, const value_map_t& vmap) {
+  value_map_t result;
+  for(ir::phi_node* phi: get_phis(block))
+    result[phi] = lookup(vmap, phi->get_value_for_block(block));
+  return result;
+}
+
+void unroll::full_unroll(const loop_info_t& info, int64_t trip_count, ir::builder& builder) {
+  ir::basic_block* block = info.body;
+  std::vector<ir::phi_node*> phis = get_phis(block);
+  std::vector<ir::instruction*> insts = get_body(block);
+  ir::instruction* term = block->get_inst_list().back();
+  // straight-line copies of the body
+  builder.set_insert_point(term);
+  value_map_t vmap;
+  for(ir::phi_node* phi: phis)
+    vmap[phi] = phi->get_value_for_block(info.pre);
+  for(int64_t n = 0; n < trip_count; n++){
+    if(n > 0)
+      vmap = next_iteration(block, vmap);
+    vmap = clone_body(insts, vmap, builder);
+  }
+  update_exit_phis(block, info.exit, vmap, block);
+  // remove the original loop
+  term->erase_from_parent();
+  for(ir::instruction* i: insts)
+    i->erase_from_parent();
+  for(ir::phi_node* phi: phis)
+    phi->erase_from_parent();
+  block->remove_predecessor(block);
+  info.exit->remove_predecessor(block);
+  builder.set_insert_point(block);
+  builder.create_br(info.exit);
+}
+
+void unroll::partial_unroll(const loop_info_t& info, int64_t trip_count, int64_t num_peeled,
+                            ir::builder& builder) {
+  ir::basic_block* block = info.body;
+  ir::function* fn = block->get_parent();
+  std::vector<ir::phi_node*> phis = get_phis(block);
+  std::vector<ir::instruction*> insts = get_body(block);
+  ir::instruction* term = block->get_inst_list().back();
+  int64_t num_steady = trip_count - num_peeled;
+  int64_t factor = std::max<int64_t>(1, std::min<int64_t>(factor_, num_steady));
+  int64_t num_trips = num_steady / factor;
+  int64_t num_epilogue = num_steady % factor + num_peeled;
+  // unrolled steady state: the original body is the first copy
+  builder.set_insert_point(term);
+  value_map_t vmap;
+  for(int64_t n = 1; n < factor; n++)
+    vmap = clone_body(insts, next_iteration(block, vmap), builder);
+  value_map_t last = vmap;
+  value_map_t next = next_iteration(block, vmap);
+  // the induction variable is advanced by factor*step at once, so that
+  // its multiple of factor*step is known by subsequent analyses
+  ir::type* ty = info.iv->get_type();
+  ir::value* step = ir::constant_int::get(ty, factor * info.step);
+  ir::value* iv_next = builder.create_add(info.iv, step);
+  ir::value* end = ir::constant_int::get(ty, info.start + num_trips * factor * info.step);
+  ir::value* cond = info.step > 0 ? builder.create_icmpSLT(iv_next, end) :
+                                    builder.create_icmpSGT(iv_next, end);
+  next[info.iv] = iv_next;
+  for(ir::phi_node* phi: phis){
+    ir::value* v = phi->get_value_for_block(block);
+    if(next.at(phi) != v)
+      phi->replace_uses_of_with(v, next.at(phi));
+  }
+  // leftover iterations after the loop
+  ir::basic_block* exit = block;
+  if(num_epilogue > 0){
+    const auto& blocks = fn->blocks();
+    auto it = std::find(blocks.begin(), blocks.end(), block);
+    ir::basic_block* next_block = std::next(it) == blocks.end() ? nullptr : *std::next(it);
+    exit = ir::basic_block::create(block->get_context(), "epilogue", fn, next_block);
+    builder.set_insert_point(exit);
+    vmap = next;
+    for(int64_t n = 0; n < num_epilogue; n++){
+      if(n > 0)
+        vmap = next_iteration(block, vmap);
+      vmap = clone_body(insts, vmap, builder);
+    }
+    last = vmap;
+    builder.create_br(info.exit);
+  }
+  update_exit_phis(block, info.exit, last, exit);
+  // new loop condition
+  term->erase_from_parent();
+  block->remove_predecessor(block);
+  info.exit->remove_predecessor(block);
+  builder.set_insert_point(block);
+  builder.create_cond_br(cond, block, num_epilogue > 0 ? exit : info.exit);
+}
+
+void unroll::run(ir::module &mod) {
+  ir::builder &builder = mod.get_builder();
+  for(ir::function* fn: mod.get_function_list()){
+    std::vector<ir::basic_block*> blocks = fn->blocks();
+    for(ir::basic_block* block: blocks){
+      loop_info_t info;
+      if(!get_loop_info(block, info))
+        continue;
+      int64_t trip_count = get_trip_count(info);
+      if(trip_count <= max_full_unroll_){
+        full_unroll(info, trip_count, builder);
+        continue;
+      }
+      // peel the last iteration when it is partial
+      bool partial_tail = (info.end - info.start) % info.step != 0;
+      int64_t num_peeled = peel_tail_ && partial_tail && has_mask(get_body(block)) ? 1 : 0;
+      if(factor_ <= 1 && num_peeled == 0)
+        continue;
+      partial_unroll(info, trip_count, num_peeled, builder);
+    }
+  }
+}
+
+}
+}
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "triton/ir/basic_block.h"
 #include "triton/ir/instructions.h"
 #include "triton/ir/type.h"
@@ -9,14 +10,14 @@ namespace ir {
 class phi_node;
 
 
-basic_block::basic_block(context &ctx, const std::string &name, function *parent):
+basic_block::basic_block(context &ctx, const std::string &name, function *parent, basic_block *next):
     value(type::get_label_ty(ctx), name), ctx_(ctx), parent_(parent) {
   if(parent_)
-    parent_->insert_block(this);
+    parent_->insert_block(this, next);
 }
 
-basic_block* basic_block::create(context &ctx, const std::string &name, function *parent){
-  return new basic_block(ctx, name, parent);
+basic_block* basic_block::create(context &ctx, const std::string &name, function *parent, basic_block *next){
+  return new basic_block(ctx, name, parent, next);
 }
 
 void basic_block::add_predecessor(basic_block *pred) {
@@ -25,6 +26,16 @@ void basic_block::add_predecessor(basic_block *pred) {
     pred->succs_.push_back(this);
 }
 
+void basic_block::remove_predecessor(basic_block *pred) {
+  auto it = std::find(preds_.begin(), preds_.end(), pred);
+  if(it == preds_.end())
+    return;
+  preds_.erase(it);
+  auto jt = std::find(pred->succs_.begin(), pred->succs_.end(), this);
+  if(jt != pred->succs_.end())
+    pred->succs_.erase(jt);
+}
+
 
 
 basic_block::iterator basic_block::get_first_non_phi(){
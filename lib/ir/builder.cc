@@ -113,6 +113,26 @@ value *builder::create_ret_void() {
   return insert(return_inst::create(ctx_));
 }
 
+value *builder::create_ret(value* ret) {
+  return insert(return_inst::create(ctx_, ret));
+}
+
+//===----------------------------------------------------------------------===//
+//                               call instructions
+//===----------------------------------------------------------------------===//
+
+value *builder::create_call(function *fn, const std::vector<value*> &args) {
+  return insert(call_inst::create(fn, args));
+}
+
+value *builder::create_extract_value(value *agg, unsigned idx) {
+  return insert(extract_value_inst::create(agg, idx));
+}
+
+value *builder::create_insert_value(value *agg, value *val, unsigned idx) {
+  return insert(insert_value_inst::create(agg, val, idx));
+}
+
 //===----------------------------------------------------------------------===//
 //                               cast instructions
 //===----------------------------------------------------------------------===//
@@ -365,6 +385,14 @@ value *builder::create_reduce(value *A, reduce_inst::op_t op, unsigned axis) {
   return insert(reduce_inst::create(A, op, axis));
 }
 
+value *builder::create_sort(value *A, unsigned k) {
+  return insert(sort_inst::create(A, k));
+}
+
+value *builder::create_scan(value *A, scan_inst::op_t op, unsigned axis) {
+  return insert(scan_inst::create(A, op, axis));
+}
+
 value *builder::create_select(value *pred, value *if_value, value *else_value){
   return insert(select_inst::create(pred, if_value, else_value));
 }
@@ -714,6 +714,167 @@ ir::value *dispatch::sum(ir::value *input, unsigned int axis, ir::builder *build
   return reduce_impl(input, axis, builder, "sum", ir::reduce_inst::FADD, ir::reduce_inst::ADD);
 }
 
+//===----------------------------------------------------------------------===//
+//                               Scans
+//===----------------------------------------------------------------------===//
+
+ir::value *scan_impl(ir::value *input, unsigned int axis, ir::builder *builder, const std::string &name,
+                     ir::scan_inst::op_t FLOAT_OP, ir::scan_inst::op_t INT_OP) {
+  ir::type *ty = input->get_type();
+  if(!ty->is_block_ty() || axis >= ty->get_tile_rank())
+    throw semantic_error(name + " expects a block and one of its axes");
+  unsigned n = ty->get_block_shapes()[axis];
+  if((n & (n - 1)) != 0)
+    throw semantic_error("the scanned dimension of a block must be a power of 2");
+  ir::type *scalar_ty = ty->get_scalar_ty();
+  // like reductions, integers are extended to 32-bits;
+  // half-precision floats are accumulated in 32-bits
+  if(scalar_ty->is_integer_ty() && scalar_ty->get_integer_bitwidth() <= 32){
+    input = dispatch::cast(input, type::get_int32_ty(scalar_ty->get_context()), builder);
+    return builder->create_scan(input, INT_OP, axis);
+  }
+  if(scalar_ty->is_integer_ty())
+    return builder->create_scan(input, INT_OP, axis);
+  if(scalar_ty->is_floating_point_ty() && scalar_ty->get_primitive_size_in_bits() < 32){
+    input = dispatch::cast(input, builder->get_float_ty(), builder);
+    return dispatch::cast(builder->create_scan(input, FLOAT_OP, axis), scalar_ty, builder);
+  }
+  if(scalar_ty->is_floating_point_ty())
+    return builder->create_scan(input, FLOAT_OP, axis);
+  return throw_unreachable(name);
+}
+
+ir::value *dispatch::cumsum(ir::value *input, unsigned int axis, ir::builder *builder) {
+  return scan_impl(input, axis, builder, "cumsum", ir::scan_inst::FADD, ir::scan_inst::ADD);
+}
+
+ir::value *dispatch::cumprod(ir::value *input, unsigned int axis, ir::builder *builder) {
+  return scan_impl(input, axis, builder, "cumprod", ir::scan_inst::FMUL, ir::scan_inst::MUL);
+}
+
+//===----------------------------------------------------------------------===//
+//                               Value/Index Pairs
+//===----------------------------------------------------------------------===//
+
+// pairs are packed into 64-bit words: a 32-bit key whose signed order is
+// the order of the values, followed by the index of the value along `axis`.
+// comparing packed words compares values first and indices second
+ir::value *pack_with_index(ir::value *input, unsigned axis, bool invert_key, bool invert_idx,
+                           const std::string &name, ir::builder *builder) {
+  ir::type *ty = input->get_type();
+  ir::type *scalar_ty = ty->get_scalar_ty();
+  bool is_float = scalar_ty->is_floating_point_ty() && !scalar_ty->is_fp64_ty();
+  bool is_int = scalar_ty->is_integer_ty() && scalar_ty->get_integer_bitwidth() <= 32;
+  if(!is_float && !is_int)
+    throw semantic_error(name + " only supports floating-point or integer values of at most 32 bits");
+  ir::type *i32_ty = builder->get_int32_ty();
+  ir::type *i64_ty = builder->get_int64_ty();
+  // the magnitude bits of negative floats are flipped
+  ir::value *key;
+  if(is_float){
+    key = dispatch::bitcast(dispatch::cast(input, builder->get_float_ty(), builder), i32_ty, builder);
+    ir::value *neg = dispatch::less_than(key, builder->get_int32(0), builder);
+    key = dispatch::where(neg, dispatch::xor_(key, builder->get_int32(0x7fffffff), builder), key, builder);
+  }
+  else
+    key = dispatch::cast(input, i32_ty, builder);
+  if(invert_key)
+    key = dispatch::invert(key, builder);
+  // index along axis
+  dispatch::shape_t shape = ty->get_block_shapes();
+  dispatch::shape_t idx_shape(shape.size(), 1);
+  idx_shape[axis] = shape[axis];
+  ir::value *idx = dispatch::arange(0, shape[axis], builder);
+  if(shape.size() > 1)
+    idx = dispatch::broadcast(dispatch::reshape(idx, idx_shape, builder), shape, builder);
+  if(invert_idx)
+    idx = dispatch::invert(idx, builder);
+  idx = dispatch::and_(dispatch::cast(idx, i64_ty, builder), builder->get_int64(0xffffffff), builder);
+  key = dispatch::shl(dispatch::cast(key, i64_ty, builder), builder->get_int64(32), builder);
+  return dispatch::or_(key, idx, builder);
+}
+
+ir::value *unpack_value(ir::value *packed, ir::type *scalar_ty, bool invert_key, ir::builder *builder) {
+  ir::type *i32_ty = builder->get_int32_ty();
+  ir::value *key = dispatch::cast(dispatch::lshr(packed, builder->get_int64(32), builder), i32_ty, builder);
+  if(invert_key)
+    key = dispatch::invert(key, builder);
+  if(scalar_ty->is_integer_ty())
+    return dispatch::cast(key, scalar_ty, builder);
+  ir::value *neg = dispatch::less_than(key, builder->get_int32(0), builder);
+  key = dispatch::where(neg, dispatch::xor_(key, builder->get_int32(0x7fffffff), builder), key, builder);
+  return dispatch::cast(dispatch::bitcast(key, builder->get_float_ty(), builder), scalar_ty, builder);
+}
+
+ir::value *unpack_index(ir::value *packed, bool invert_idx, ir::builder *builder) {
+  ir::value *idx = dispatch::cast(packed, builder->get_int32_ty(), builder);
+  return invert_idx ? dispatch::invert(idx, builder) : idx;
+}
+
+//===----------------------------------------------------------------------===//
+//                               Indexed Reductions
+//===----------------------------------------------------------------------===//
+
+// ties are broken in favor of the lowest index: its bits are inverted
+// when the largest packed word is selected
+std::tuple<ir::value*, ir::value*> indexed_reduce_impl(ir::value *input, unsigned int axis, bool is_max,
+                                                       const std::string &name, ir::builder *builder) {
+  ir::type *ty = input->get_type();
+  if(!ty->is_block_ty() || axis >= ty->get_tile_rank())
+    throw semantic_error(name + " expects a block and one of its axes");
+  ir::value *packed = pack_with_index(input, axis, false, is_max, name, builder);
+  ir::value *ret = builder->create_reduce(packed, is_max ? ir::reduce_inst::MAX : ir::reduce_inst::MIN, axis);
+  return std::make_tuple(unpack_value(ret, ty->get_scalar_ty(), false, builder),
+                         unpack_index(ret, is_max, builder));
+}
+
+std::tuple<ir::value*, ir::value*> dispatch::min_with_index(ir::value *input, unsigned int axis, ir::builder *builder) {
+  return indexed_reduce_impl(input, axis, false, "min_with_index", builder);
+}
+
+std::tuple<ir::value*, ir::value*> dispatch::max_with_index(ir::value *input, unsigned int axis, ir::builder *builder) {
+  return indexed_reduce_impl(input, axis, true, "max_with_index", builder);
+}
+
+ir::value *dispatch::argmin(ir::value *input, unsigned int axis, ir::builder *builder) {
+  return std::get<1>(min_with_index(input, axis, builder));
+}
+
+ir::value *dispatch::argmax(ir::value *input, unsigned int axis, ir::builder *builder) {
+  return std::get<1>(max_with_index(input, axis, builder));
+}
+
+//===----------------------------------------------------------------------===//
+//                               Sorting
+//===----------------------------------------------------------------------===//
+
+std::tuple<ir::value*, ir::value*> sort_impl(ir::value *input, unsigned k, bool descending,
+                                             const std::string &name, ir::builder *builder) {
+  ir::type *ty = input->get_type();
+  if(!ty->is_block_ty())
+    throw semantic_error(name + " expects a block");
+  unsigned axis = ty->get_tile_rank() - 1;
+  unsigned n = ty->get_block_shapes()[axis];
+  if(n < 2 || (n & (n - 1)) != 0)
+    throw semantic_error("the last dimension of a sorted block must be a power of 2");
+  if(k < 1 || k > n || (k & (k - 1)) != 0)
+    throw semantic_error(name + ": k must be a power of 2 no larger than the last dimension");
+  // packed words are sorted in ascending order, so keys are inverted
+  // to sort values in descending order. ties are broken by index and
+  // the result is deterministic
+  ir::value *sorted = builder->create_sort(pack_with_index(input, axis, descending, false, name, builder), k);
+  return std::make_tuple(unpack_value(sorted, ty->get_scalar_ty(), descending, builder),
+                         unpack_index(sorted, false, builder));
+}
+
+std::tuple<ir::value*, ir::value*> dispatch::sort(ir::value *input, bool descending, ir::builder *builder) {
+  unsigned n = input->get_type()->is_block_ty() ? input->get_type()->get_block_shapes().back() : 0;
+  return sort_impl(input, n, descending, "sort", builder);
+}
+
+std::tuple<ir::value*, ir::value*> dispatch::topk(ir::value *input, unsigned k, bool largest, ir::builder *builder) {
+  return sort_impl(input, k, largest, "topk", builder);
+}
 
 //===----------------------------------------------------------------------===//
 //                               Math
@@ -48,6 +48,12 @@ function::function(function_type *ty, linkage_types_t linkage,
     parent->push_function(this);
 }
 
+void function::reset_type(function_type *ty) {
+  assert(ty->get_num_params() == fn_ty_->get_num_params());
+  fn_ty_ = ty;
+  ty_ = ty;
+}
+
 /* basic block */
 void function::insert_block(basic_block *block, basic_block *next) {
   auto it = std::find(blocks_.begin(), blocks_.end(), next);
@@ -5,6 +5,7 @@
 #include "triton/ir/instructions.h"
 #include "triton/ir/constant.h"
 #include "triton/ir/type.h"
+#include "triton/ir/function.h"
 
 namespace triton{
 namespace ir{
@@ -360,6 +361,46 @@ cond_branch_inst::cond_branch_inst(basic_block *if_dst, basic_block *else_dst, v
 }
 
 
+//===----------------------------------------------------------------------===//
+//                               call_inst classes
+//===----------------------------------------------------------------------===//
+
+call_inst::call_inst(function *fn, const std::vector<value*> &args, const std::string &name, instruction *next)
+  : instruction(fn->get_fn_type()->get_return_ty(), INST_CALL, args.size(), name, next), fn_(fn) {
+  for(size_t i = 0; i < args.size(); i++)
+    set_operand(i, args[i]);
+}
+
+std::string call_inst::repr_impl() const {
+  return "call " + fn_->get_name();
+}
+
+call_inst* call_inst::create(function *fn, const std::vector<value*> &args, const std::string &name, instruction *next) {
+  return new call_inst(fn, args, name, next);
+}
+
+// extract_value
+extract_value_inst::extract_value_inst(value *agg, unsigned idx, const std::string &name, instruction *next)
+  : instruction(((struct_type*)agg->get_type())->get_ty(idx), INST_EXTRACT_VALUE, 1, name, next), idx_(idx) {
+  set_operand(0, agg);
+}
+
+instruction* extract_value_inst::create(value *agg, unsigned idx, const std::string &name, instruction *next) {
+  return new extract_value_inst(agg, idx, name, next);
+}
+
+// insert_value
+insert_value_inst::insert_value_inst(value *agg, value *val, unsigned idx, const std::string &name, instruction *next)
+  : instruction(agg->get_type(), INST_INSERT_VALUE, 2, name, next), idx_(idx) {
+  set_operand(0, agg);
+  set_operand(1, val);
+}
+
+instruction* insert_value_inst::create(value *agg, value *val, unsigned idx, const std::string &name, instruction *next) {
+  return new insert_value_inst(agg, val, idx, name, next);
+}
+
+
 //===----------------------------------------------------------------------===//
 //                               getelementptr_inst classes
 //===----------------------------------------------------------------------===//
@@ -710,6 +751,40 @@ instruction* reduce_inst::create(value *arg, op_t op, unsigned axis, const std::
   return new reduce_inst(arg, op, axis, name, next);
 }
 
+//===----------------------------------------------------------------------===//
+//                               sort instructions
+//===----------------------------------------------------------------------===//
+
+type* sort_inst::get_res_type(value *arg, unsigned k) {
+  ir::block_type::block_shapes_t shapes = arg->get_type()->get_block_shapes();
+  shapes.back() = k;
+  return block_type::get(arg->get_type()->get_scalar_ty(), shapes);
+}
+
+sort_inst::sort_inst(value *arg, unsigned k, const std::string &name, instruction *next)
+  : builtin_inst(get_res_type(arg, k), INST_SORT, 1, name, next){
+  set_operand(0, arg);
+}
+
+instruction* sort_inst::create(value *arg, unsigned k, const std::string &name, instruction *next) {
+  return new sort_inst(arg, k, name, next);
+}
+
+//===----------------------------------------------------------------------===//
+//                               scan instructions
+//===----------------------------------------------------------------------===//
+
+scan_inst::scan_inst(value *arg, op_t op, unsigned axis, const std::string &name, instruction *next)
+  : builtin_inst(arg->get_type(), INST_SCAN, 1, name, next),
+    axis_(axis),
+    op_(op){
+  set_operand(0, arg);
+}
+
+instruction* scan_inst::create(value *arg, op_t op, unsigned axis, const std::string &name, instruction *next) {
+  return new scan_inst(arg, op, axis, name, next);
+}
+
 
 //===----------------------------------------------------------------------===//
 //                               select instructions
@@ -157,6 +157,30 @@ function *module::get_or_insert_function(const std::string &name, function_type
   return fn;
 }
 
+void module::remove_function(function *fn) {
+  functions_.erase(std::find(functions_.begin(), functions_.end(), fn));
+  for(auto it = symbols_.begin(); it != symbols_.end(); )
+    it = it->second == fn ? symbols_.erase(it) : std::next(it);
+  for(auto it = values_.begin(); it != values_.end(); )
+    it = it->first.second && it->first.second->get_parent() == fn ? values_.erase(it) : std::next(it);
+  // drop all uses first, as instructions may use values defined in later blocks
+  std::vector<instruction*> insts;
+  for(basic_block *block: fn->blocks()){
+    insts.insert(insts.end(), block->begin(), block->end());
+    sealed_blocks_.erase(block);
+    incomplete_phis_.erase(block);
+  }
+  for(instruction *i: insts)
+    i->erase_from_parent();
+  for(instruction *i: insts)
+    delete i;
+  for(basic_block *block: fn->blocks())
+    delete block;
+  for(argument *arg: fn->args())
+    delete arg;
+  delete fn;
+}
+
 
 }
 }
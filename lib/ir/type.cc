@@ -173,6 +173,25 @@ bool composite_type::index_valid(value *idx) const{
   return idx->get_type()->is_int_or_tileint_ty();
 }
 
+//===----------------------------------------------------------------------===//
+//                               struct_type class
+//===----------------------------------------------------------------------===//
+
+struct_type::struct_type(const std::vector<type*>& tys)
+    : composite_type(tys.at(0)->get_context(), StructTyID) {
+  contained_tys_ = tys;
+}
+
+struct_type* struct_type::get(const std::vector<type*>& tys) {
+  assert(tys.size() && "Can't create an empty struct!");
+  // look-up
+  context_impl *impl = tys[0]->get_context().p_impl.get();
+  struct_type *&entry = impl->struct_tys[tys];
+  if(!entry)
+    entry = new struct_type(tys);
+  return entry;
+}
+
 //===----------------------------------------------------------------------===//
 //                               tile_type class
 //===----------------------------------------------------------------------===//
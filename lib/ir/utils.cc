@@ -4,6 +4,7 @@
 #include "triton/ir/basic_block.h"
 #include "triton/ir/function.h"
 #include "triton/ir/module.h"
+#include "triton/ir/instructions.h"
 
 namespace triton{
 namespace ir{
@@ -64,5 +65,32 @@ void for_each_value(module &mod, const std::function<void (value *)> &do_work) {
   }
 }
 
+// one value per element of the (possibly aggregate) return type of a
+// device function; elements that are never inserted are null
+std::vector<value*> get_return_values(return_inst* ret) {
+  value* val = ret->get_return_value();
+  if(!val)
+    return {};
+  if(!val->get_type()->is_struct_ty())
+    return {val};
+  std::vector<value*> result(((struct_type*)val->get_type())->get_num_types(), nullptr);
+  while(auto* ins = dynamic_cast<insert_value_inst*>(val)){
+    if(!result[ins->get_idx()])
+      result[ins->get_idx()] = ins->get_operand(1);
+    val = ins->get_operand(0);
+  }
+  return result;
+}
+
+std::vector<value*> get_return_values(function* fn) {
+  for(basic_block *block: fn->blocks())
+  for(instruction *i: block->get_inst_list()){
+    auto* ret = dynamic_cast<return_inst*>(i);
+    if(ret && ret->get_return_value())
+      return get_return_values(ret);
+  }
+  return {};
+}
+
 }
 }
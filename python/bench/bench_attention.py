@@ -0,0 +1,86 @@
+import torch
+import triton
+
+# Throughput benchmarks
+confs = [
+    triton.testing.Benchmark(
+        x_names=['N_CTX'],
+        x_vals=[512, 1024, 2048, 4096, 8192],
+        line_arg='provider',
+        line_vals=['triton', 'torch'],
+        line_names=['Triton', 'Torch'],
+        ylabel='TFLOPS',
+        plot_name=f'attention-{mode}-{"causal" if causal else "full"}-Z{Z}-H{H}-D{D}',
+        args={'Z': Z, 'H': H, 'D': D, 'causal': causal, 'mode': mode, 'dtype': torch.float16},
+    ) for mode in ['forward', 'backward'] for causal in [False, True] for Z, H, D in [(4, 16, 64)]
+]
+
+# Memory benchmarks
+mem_confs = [
+    triton.testing.Benchmark(
+        x_names=['N_CTX'],
+        x_vals=[512, 1024, 2048, 4096, 8192],
+        line_arg='provider',
+        line_vals=['triton', 'torch'],
+        line_names=['Triton', 'Torch'],
+        ylabel='MB',
+        plot_name=f'attention-{mode}-memory-Z{Z}-H{H}-D{D}',
+        args={'Z': Z, 'H': H, 'D': D, 'causal': False, 'mode': mode, 'dtype': torch.float16},
+    ) for mode in ['forward', 'backward'] for Z, H, D in [(4, 16, 64)]
+]
+
+
+def _torch_attention(q, k, v, causal, sm_scale):
+    p = torch.matmul(q, k.transpose(-1, -2)) * sm_scale
+    if causal:
+        N_CTX = q.shape[2]
+        mask = torch.tril(torch.ones((N_CTX, N_CTX), device=q.device, dtype=torch.bool))
+        p = p.masked_fill(~mask, float('-inf'))
+    p = torch.softmax(p.float(), dim=-1).to(q.dtype)
+    return torch.matmul(p, v)
+
+
+def _make_fn(Z, H, N_CTX, D, causal, mode, dtype, provider):
+    q, k, v = [torch.randn((Z, H, N_CTX, D), dtype=dtype, device='cuda', requires_grad=True) for _ in range(3)]
+    sm_scale = D ** -0.5
+    op = {'triton': triton.ops.attention, 'torch': _torch_attention}[provider]
+    fn = lambda: op(q, k, v, causal, sm_scale)
+    if mode == 'backward':
+        o = fn()
+        do = torch.randn_like(o)
+        fn = lambda: o.backward(do, retain_graph=True)
+    return fn, [q, k, v]
+
+
+@triton.testing.perf_report(confs)
+def bench_op(Z, H, N_CTX, D, causal, mode, dtype, provider):
+    fn, grads = _make_fn(Z, H, N_CTX, D, causal, mode, dtype, provider)
+    ms, min_ms, max_ms = triton.testing.do_bench(fn, grad_to_none=grads)
+    # two matmuls forward, five backward (one of which re-computes the scores)
+    num_flops = 4 * Z * H * N_CTX * N_CTX * D
+    if mode == 'backward':
+        num_flops *= 2.5
+    if causal:
+        num_flops *= 0.5
+    tflops = lambda ms: num_flops / ms * 1e-9
+    return tflops(ms), tflops(max_ms), tflops(min_ms)
+
+
+@triton.testing.perf_report(mem_confs)
+def bench_memory(Z, H, N_CTX, D, causal, mode, dtype, provider):
+    fn, _ = _make_fn(Z, H, N_CTX, D, causal, mode, dtype, provider)
+    torch.cuda.synchronize()
+    torch.cuda.reset_peak_memory_stats()
+    base = torch.cuda.memory_allocated()
+    try:
+        fn()
+    except RuntimeError:
+        return None
+    torch.cuda.synchronize()
+    mb = (torch.cuda.max_memory_allocated() - base) * 1e-6
+    return mb, mb, mb
+
+
+if __name__ == '__main__':
+    bench_op.run(print_data=True)
+    bench_memory.run(print_data=True)
@@ -0,0 +1,38 @@
+import torch
+import triton
+
+# 3x3 convolutions of ResNet-50, NHWC
+confs = [
+    triton.testing.Benchmark(
+              x_names = ['N'],
+              x_vals  = [1, 8, 32, 64, 128],
+              line_arg  = 'provider',
+              line_vals  = ['triton', 'torch'],
+              line_names = ['Triton', 'Torch'],
+              ylabel  = 'TFLOPS',
+              plot_name = f'conv-3x3-{H}x{W}x{C}',
+              args = {'H': H, 'W': W, 'C': C, 'K': C, 'R': 3, 'S': 3, 'dtype': torch.float16}
+    )\
+    for H, W, C in [(56, 56, 64), (28, 28, 128), (14, 14, 256), (7, 7, 512)]
+]
+
+
+@triton.testing.perf_report(confs)
+def bench_op(N, H, W, C, K, R, S, dtype, provider):
+    # create inputs
+    x = torch.randn((N, H, W, C), device='cuda', dtype=dtype)
+    w = torch.randn((K, R, S, C), device='cuda', dtype=dtype)
+    tflops = lambda ms: 2. * N * H * W * K * C * R * S / ms * 1e-9
+    if provider == 'triton':
+        fn = lambda: triton.ops.conv2d(x, w, padding=1)
+    if provider == 'torch':
+        # channels-last views of the same data
+        x_cl = x.permute(0, 3, 1, 2)
+        w_cl = w.permute(0, 3, 1, 2)
+        fn = lambda: torch.nn.functional.conv2d(x_cl, w_cl, padding=1)
+    mean_ms, min_ms, max_ms = triton.testing.do_bench(fn)
+    return tflops(mean_ms), tflops(max_ms), tflops(min_ms)
+
+
+if __name__ == '__main__':
+    bench_op.run(print_data=True)
@@ -15,8 +15,23 @@ confs = [
     for mode in ['forward', 'backward']
 ]
 
+# Large vocabularies, processed in chunks
+large_confs = [
+    triton.testing.Benchmark(
+              x_names = ['N'],
+              x_vals  = [32768, 131072, 262144],
+              line_arg  = 'provider',
+              line_vals  = ['triton', 'torch'],
+              line_names = ['Triton', 'Torch'],
+              ylabel  = 'GBPS',
+              plot_name = f'{mode}-vocab-1024',
+              args = {'M': 1024, 'dtype': torch.float16, 'mode': mode}
+    )\
+    for mode in ['forward', 'backward']
+]
+
 
-@triton.testing.perf_report(confs)
+@triton.testing.perf_report(confs + large_confs)
 def bench_op(M, N, dtype, mode, provider):
     # create inputs
     x = torch.randn(M, N, dtype=dtype, device='cuda', requires_grad=True)
@@ -0,0 +1,33 @@
+import torch
+import triton
+
+confs = [
+    triton.testing.Benchmark(
+              x_names = ['N'],
+              x_vals  = [2**i for i in range(10, 25, 2)],
+              line_arg  = 'provider',
+              line_vals  = ['triton', 'torch'],
+              line_names = ['Triton', 'Torch'],
+              ylabel  = 'GBPS',
+              plot_name = f'cumsum-{M}',
+              args = {'M': M, 'dtype': torch.float32}
+    )\
+    for M in [1, 64]
+]
+
+
+@triton.testing.perf_report(confs)
+def bench_op(M, N, dtype, provider):
+    # create inputs
+    x = torch.randn(M, N, dtype=dtype, device='cuda')
+    # x is read once and y is written once
+    num_gb = 2 * x.numel() * x.element_size() * 1e-9
+    gbps = lambda ms: num_gb / ms * 1e3
+    op = {'torch': lambda: torch.cumsum(x, dim=-1), \
+         'triton': lambda: triton.ops.cumsum(x)}[provider]
+    mean_ms, min_ms, max_ms = triton.testing.do_bench(op)
+    return gbps(mean_ms), gbps(min_ms), gbps(max_ms)
+
+
+if __name__ == '__main__':
+    bench_op.run(print_data=True)
@@ -0,0 +1,41 @@
+import torch
+import triton
+
+confs = [
+    triton.testing.Benchmark(
+              x_names = ['N'],
+              x_vals  = [1024 * i for i in range(1, 17)],
+              line_arg  = 'provider',
+              line_vals  = ['triton', 'torch'],
+              line_names = ['Triton', 'Torch'],
+              ylabel  = 'GBPS',
+              plot_name = f'dropout-{mode}-4096',
+              args = {'M': 4096, 'p': 0.1, 'dtype': torch.float16, 'mode': mode}
+    )\
+    for mode in ['forward', 'backward']
+]
+
+
+@triton.testing.perf_report(confs)
+def bench_op(M, N, p, dtype, mode, provider):
+    # create inputs
+    x = torch.randn(M, N, dtype=dtype, device='cuda', requires_grad=True)
+    bias = torch.randn(N, dtype=dtype, device='cuda', requires_grad=True)
+    residual = torch.randn(M, N, dtype=dtype, device='cuda', requires_grad=True)
+    # bytes that must be moved by a fused implementation; no mask is read or written
+    num_gb = ({'forward': 3, 'backward': 2}[mode] * x.numel() * x.element_size() * 1e-9)
+    gbps = lambda ms: num_gb / ms * 1e3
+    op = {'torch': lambda: torch.nn.functional.dropout(x + bias, p) + residual, \
+         'triton': lambda: triton.ops.dropout(x, p, bias=bias, residual=residual)}[provider]
+    if mode == 'forward':
+        mean_ms, min_ms, max_ms = triton.testing.do_bench(op)
+    if mode == 'backward':
+        y = op()
+        dy = torch.randn_like(y)
+        fn = lambda: y.backward(dy, retain_graph=True)
+        mean_ms, min_ms, max_ms = triton.testing.do_bench(fn, grad_to_none=[x, bias, residual])
+    return gbps(mean_ms), gbps(min_ms), gbps(max_ms)
+
+
+if __name__ == '__main__':
+    bench_op.run(print_data=True)
@@ -0,0 +1,39 @@
+import torch
+import triton
+
+# Mixture-of-experts layer: tokens are routed unevenly to E experts
+confs = [
+    triton.testing.Benchmark(
+              x_names = ['E'],
+              x_vals  = [4, 8, 16, 32, 64],
+              line_arg  = 'provider',
+              line_vals  = ['triton-grouped', 'triton-loop', 'torch-loop'],
+              line_names = ['Triton (grouped)', 'Triton (one launch per expert)', 'Torch (one launch per expert)'],
+              ylabel  = 'TFLOPS',
+              plot_name = f'moe-{tokens}-tokens',
+              args = {'tokens': tokens, 'D': 1024, 'H': 4096, 'dtype': torch.float16}
+    )\
+    for tokens in [4096, 16384]
+]
+
+
+@triton.testing.perf_report(confs)
+def bench_op(E, tokens, D, H, dtype, provider):
+    # create inputs
+    torch.manual_seed(0)
+    counts = torch.multinomial(torch.ones(E), tokens, replacement=True).bincount(minlength=E).tolist()
+    a = [torch.randn((M, D), device='cuda', dtype=dtype) for M in counts]
+    b = [torch.randn((D, H), device='cuda', dtype=dtype) for _ in counts]
+    tflops = lambda ms: 2. * tokens * D * H / ms * 1e-9
+    if provider == 'triton-grouped':
+        fn = lambda: triton.ops.grouped_matmul(a, b)
+    if provider == 'triton-loop':
+        fn = lambda: [triton.ops.matmul(x, y) for x, y in zip(a, b)]
+    if provider == 'torch-loop':
+        fn = lambda: [torch.matmul(x, y) for x, y in zip(a, b)]
+    mean_ms, min_ms, max_ms = triton.testing.do_bench(fn)
+    return tflops(mean_ms), tflops(max_ms), tflops(min_ms)
+
+
+if __name__ == '__main__':
+    bench_op.run(print_data=True)
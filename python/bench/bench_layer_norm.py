@@ -0,0 +1,41 @@
+import torch
+import triton
+
+confs = [
+    triton.testing.Benchmark(
+              x_names = ['N'],
+              x_vals  = [512, 1024, 2048, 3072, 4096, 6144, 8192, 12288, 16384],
+              line_arg  = 'provider',
+              line_vals  = ['triton', 'torch'],
+              line_names = ['Triton', 'Torch'],
+              ylabel  = 'GBPS',
+              plot_name = f'layer-norm-{mode}-4096',
+              args = {'M': 4096, 'dtype': torch.float16, 'mode': mode}
+    )\
+    for mode in ['forward', 'backward']
+]
+
+
+@triton.testing.perf_report(confs)
+def bench_op(M, N, dtype, mode, provider):
+    # create inputs
+    x = torch.randn(M, N, dtype=dtype, device='cuda', requires_grad=True)
+    w = torch.rand(N, dtype=dtype, device='cuda', requires_grad=True)
+    b = torch.rand(N, dtype=dtype, device='cuda', requires_grad=True)
+    # x and y are read / written once in the forward pass; x, dy and dx in the backward pass
+    num_gb = ({'forward': 2, 'backward': 3}[mode] * x.numel() * x.element_size() * 1e-9)
+    gbps = lambda ms: num_gb / ms * 1e3
+    op = {'torch': lambda x: torch.nn.functional.layer_norm(x, (N, ), w, b), \
+         'triton': lambda x: triton.ops.layer_norm(x, w, b)}[provider]
+    if mode == 'forward':
+        mean_ms, min_ms, max_ms = triton.testing.do_bench(lambda: op(x))
+    if mode == 'backward':
+        y = op(x)
+        dy = torch.randn_like(y)
+        fn = lambda: y.backward(dy, retain_graph=True)
+        mean_ms, min_ms, max_ms = triton.testing.do_bench(fn, grad_to_none=[x, w, b])
+    return gbps(mean_ms), gbps(min_ms), gbps(max_ms)
+
+
+if __name__ == '__main__':
+    bench_op.run(print_data=True)
@@ -41,8 +41,23 @@ transformer_confs = [
       for M in [2048]
 ]
 
+# Skinny benchmarks: too few output tiles to fill the GPU, which
+# is where split-k and stream-k configs are expected to help
+skinny_confs = [
+    triton.testing.Benchmark(
+        x_names=["M"],
+        x_vals=[1, 8, 16, 32, 64, 128],
+        line_arg="provider",
+        line_vals=["cublas", "triton", "cutlass"],
+        line_names=["cuBLAS", "Triton", "CUTLASS"],
+        ylabel="TFLOPS",
+        plot_name=f"matmul-skinny-N{N}-K{K}",
+        args={"N": N, "K": K, "AT": False, "BT": False, "dtype": torch.float16},
+    ) for N, K in [(4096, 4096), (4096, 12288), (12288, 4096)]
+]
+
 
-@triton.testing.perf_report(square_confs)
+@triton.testing.perf_report(square_confs + skinny_confs)
 def bench_op(M, N, K, AT, BT, dtype, provider, warmup=25, rep=75):
     a = torch.rand((K, M) if AT else (M, K), device="cuda", dtype=dtype)
     b = torch.rand((N, K) if BT else (K, N), device="cuda", dtype=dtype)
@@ -0,0 +1,43 @@
+import torch
+import triton
+
+# Weight-only quantized linear layers, as found in LLM serving:
+# small batches, for which the cost is dominated by weight loads
+confs = [
+    triton.testing.Benchmark(
+              x_names = ['M'],
+              x_vals  = [1, 4, 16, 32, 64, 128, 256],
+              line_arg  = 'provider',
+              line_vals  = ['triton-int4', 'triton-int8', 'triton-fp16', 'torch-dequant-int8', 'cublas-fp16'],
+              line_names = ['Triton (int4)', 'Triton (int8)', 'Triton (fp16)', 'Torch (dequantize, then matmul)', 'cuBLAS (fp16)'],
+              ylabel  = 'GBPS',
+              plot_name = f'quant-matmul-{N}x{K}',
+              args = {'N': N, 'K': K, 'group_size': 128}
+    )\
+    for N, K in [(4096, 4096), (11008, 4096), (4096, 11008)]
+]
+
+
+@triton.testing.perf_report(confs)
+def bench_op(M, N, K, group_size, provider):
+    # create inputs
+    a = torch.randn((M, K), device='cuda', dtype=torch.float16)
+    w = torch.randn((K, N), device='cuda', dtype=torch.float16)
+    bits = 4 if provider == 'triton-int4' else 8
+    q, scales = triton.ops.quantize(w, bits=bits, group_size=group_size)
+    # effective bandwidth, counting fp16 weights: higher means fewer bytes actually moved
+    gbps = lambda ms: 2. * K * N / ms * 1e-6
+    if provider in ['triton-int4', 'triton-int8']:
+        fn = lambda: triton.ops.quant_matmul(a, q, scales, bits=bits)
+    if provider == 'triton-fp16':
+        fn = lambda: triton.ops.matmul(a, w)
+    if provider == 'torch-dequant-int8':
+        fn = lambda: torch.matmul(a, q.half() * scales.repeat_interleave(group_size, dim=0))
+    if provider == 'cublas-fp16':
+        fn = lambda: torch.matmul(a, w)
+    mean_ms, min_ms, max_ms = triton.testing.do_bench(fn)
+    return gbps(mean_ms), gbps(max_ms), gbps(min_ms)
+
+
+if __name__ == '__main__':
+    bench_op.run(print_data=True)
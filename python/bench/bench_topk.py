@@ -0,0 +1,34 @@
+import torch
+import triton
+
+confs = [
+    triton.testing.Benchmark(
+              x_names = ['N'],
+              x_vals  = [32, 64, 128, 256, 512, 1024, 2048, 4096],
+              line_arg  = 'provider',
+              line_vals  = ['triton', 'torch'],
+              line_names = ['Triton', 'Torch'],
+              ylabel  = 'GBPS',
+              plot_name = f'topk-{K}-{M}',
+              args = {'M': M, 'K': K, 'dtype': torch.float16}
+    )\
+    for M, K in [(4096, 8), (4096, 32)]
+]
+
+
+@triton.testing.perf_report(confs)
+def bench_op(M, N, K, dtype, provider):
+    K = min(K, N)
+    # create inputs
+    x = torch.randn(M, N, dtype=dtype, device='cuda')
+    # x is read once; values and indices are written once
+    num_gb = (x.numel() * x.element_size() + M * K * (x.element_size() + 8)) * 1e-9
+    gbps = lambda ms: num_gb / ms * 1e3
+    op = {'torch': lambda: torch.topk(x, K, dim=-1), \
+         'triton': lambda: triton.ops.topk(x, K)}[provider]
+    mean_ms, min_ms, max_ms = triton.testing.do_bench(op)
+    return gbps(mean_ms), gbps(min_ms), gbps(max_ms)
+
+
+if __name__ == '__main__':
+    bench_op.run(print_data=True)
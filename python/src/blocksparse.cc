@@ -0,0 +1,347 @@
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Look-up tables for block-sparse matrix multiplication and softmax.
+// Layouts are passed as the big-endian bit representation of a (H, M, N)
+// tensor of 0s and 1s (i.e., numpy.packbits). Tables are built in parallel
+// over heads, and cached by layout across operator instances.
+
+// row-major 3d layout of 0s and 1s
+class layout_t {
+public:
+  layout_t(const uint8_t *bits, int H, int M, int N) : H(H), M(M), N(N), data_((size_t)H * M * N) {
+    for (size_t i = 0; i < data_.size(); i++)
+      data_[i] = (bits[i >> 3] >> (7 - (i & 7))) & 1;
+  }
+
+  int operator()(int h, int m, int n) const {
+    return data_[((size_t)h * M + m) * N + n];
+  }
+
+  const int H, M, N;
+
+private:
+  std::vector<uint8_t> data_;
+};
+
+// number of non-zero blocks of each head, and of all the heads before it
+std::vector<int> head_offsets(const layout_t &layout) {
+  std::vector<int> ret(layout.H + 1, 0);
+#pragma omp parallel for
+  for (int h = 0; h < layout.H; h++)
+    for (int m = 0; m < layout.M; m++)
+      for (int n = 0; n < layout.N; n++)
+        ret[h + 1] += layout(h, m, n);
+  for (int h = 0; h < layout.H; h++)
+    ret[h + 1] += ret[h];
+  return ret;
+}
+
+// -----------------------------
+// Sparse = Dense x Dense (SDD)
+// -----------------------------
+
+// greedily packs blocks of one head into super-blocks of max_width x max_width
+// blocks. packed blocks are removed from the layout, and their (head, row, column,
+// index) is appended to lut
+void segment_blocks(std::vector<int> &layout, std::vector<int> &tmp, const std::vector<int> &idx,
+                    std::vector<int> &ii_left, std::vector<int> &ii_top,
+                    int h, int max_width, int M, int N, std::vector<int> &lut) {
+  std::fill(tmp.begin(), tmp.end(), 0);
+  // surrounding indices, as ring buffers of size max_width
+  std::fill(ii_left.begin(), ii_left.begin() + max_width, -1);
+  std::fill(ii_top.begin(), ii_top.begin() + max_width * N, -1);
+  auto top_at = [&](int k, int n) -> int & { return ii_top[k * N + n]; };
+  // start the dynamic programming algorithm
+  for (int m = 0; m < M; m++) {
+    for (int n = 0; n < N; n++) {
+      int v = layout[m * N + n];
+      if (v == 0)
+        continue;
+      int n_left = ii_left[max_width - 1];
+      int m_top = top_at(max_width - 1, n);
+      int top = (m_top >= 0) ? tmp[m_top * N + n] : 0;
+      int left = (n_left >= 0) ? tmp[m * N + n_left] : 0;
+      int topleft = (m_top >= 0 && n_left >= 0) ? tmp[m_top * N + n_left] : 0;
+      int width = std::min(left, std::min(top, topleft)) + 1;
+      // reset width if blocks cannot be
+      // packed together (i.e., there's a 1 "in the middle")
+      for (int nn = n_left + 1; nn < n; nn++)
+        if (top_at(max_width - 1, nn) > top_at(max_width - 1, n))
+          width = 1;
+      tmp[m * N + n] = width;
+      // update n_left ring buffer
+      for (int k = 0; k < max_width - 1; k++)
+        ii_left[k] = ii_left[k + 1];
+      ii_left[max_width - 1] = n;
+      // update ii_top ring buffer
+      for (int k = 0; k < max_width - 1; k++)
+        top_at(k, n) = top_at(k + 1, n);
+      top_at(max_width - 1, n) = m;
+      // block is too small -- skip
+      if (width != max_width)
+        continue;
+      // retained blocks are set to zeros
+      for (int km = 0; km < max_width; km++)
+        for (int kn = 0; kn < max_width; kn++) {
+          int mm = top_at(km, n);
+          int nn = ii_left[kn];
+          if (mm < 0 || nn < 0)
+            continue;
+          layout[mm * N + nn] = 0;
+          tmp[mm * N + nn] = 0;
+          lut.push_back(h);
+          lut.push_back(mm);
+          lut.push_back(nn);
+          lut.push_back(idx[mm * N + nn]);
+        }
+    }
+  }
+}
+
+typedef std::vector<std::pair<int, std::vector<int>>> luts_t;
+
+luts_t sdd_lut(const layout_t &layout, int start_width) {
+  int H = layout.H, M = layout.M, N = layout.N;
+  std::vector<int> widths;
+  for (int max_width = start_width; max_width > 0; max_width /= 2)
+    widths.push_back(max_width);
+  std::vector<int> offsets = head_offsets(layout);
+  // luts of each head, for each width
+  std::vector<std::vector<std::vector<int>>> partial(widths.size(), std::vector<std::vector<int>>(H));
+#pragma omp parallel
+  {
+    // per-thread work buffers, re-used across heads
+    std::vector<int> layout_h(M * N), idx(M * N), tmp(M * N);
+    std::vector<int> ii_left(start_width), ii_top(start_width * N);
+#pragma omp for schedule(dynamic)
+    for (int h = 0; h < H; h++) {
+      int current = offsets[h];
+      for (int m = 0; m < M; m++)
+        for (int n = 0; n < N; n++) {
+          layout_h[m * N + n] = layout(h, m, n);
+          idx[m * N + n] = layout_h[m * N + n] ? current++ : 0;
+        }
+      for (size_t w = 0; w < widths.size(); w++)
+        segment_blocks(layout_h, tmp, idx, ii_left, ii_top, h, widths[w], M, N, partial[w][h]);
+    }
+  }
+  // concatenate heads
+  luts_t ret;
+  for (size_t w = 0; w < widths.size(); w++) {
+    std::vector<int> lut;
+    for (int h = 0; h < H; h++)
+      lut.insert(lut.end(), partial[w][h].begin(), partial[w][h].end());
+    if (!lut.empty())
+      ret.push_back({widths[w], std::move(lut)});
+  }
+  return ret;
+}
+
+// -----------------------------
+// Dense = Sparse x Dense (DSD)
+// -----------------------------
+
+// one segment per (head, row) of the layout if trans, else per (head, column).
+// header: (offset of the increments, reduction size, row/column, head)
+// increments: pairs of (dense, sparse) pointer increments, for each step
+std::pair<std::vector<int>, int> dsd_lut(const layout_t &layout, int block, int step, bool trans) {
+  int H = layout.H;
+  int X = trans ? layout.M : layout.N;
+  int Y = trans ? layout.N : layout.M;
+  auto at = [&](int h, int x, int y) { return trans ? layout(h, x, y) : layout(h, y, x); };
+  int div = block / step;
+  int width = H * X;
+  std::vector<int> offsets = head_offsets(layout);
+  int num_blocks = offsets[H];
+  std::vector<int> lut(4 * width + 2 * num_blocks * div + 2, 0);
+  int *header = lut.data();
+  int *incs = lut.data() + 4 * width;
+#pragma omp parallel
+  {
+    std::vector<int> idx(layout.M * layout.N);
+#pragma omp for schedule(dynamic)
+    for (int h = 0; h < H; h++) {
+      // index of each block in the sparse (row-major) memory layout
+      int current = offsets[h];
+      for (int m = 0; m < layout.M; m++)
+        for (int n = 0; n < layout.N; n++)
+          idx[m * layout.N + n] = layout(h, m, n) ? current++ : 0;
+      int i = offsets[h];
+      // the sparse operand moves along rows if trans, else along columns
+      int a_step = trans ? step : step * block;
+      for (int x = 0; x < X; x++) {
+        int start = i;
+        int prev_a_idx = 0, prev_b_idx = 0;
+        for (int y = 0; y < Y; y++) {
+          if (!at(h, x, y))
+            continue;
+          int a_idx = trans ? idx[x * layout.N + y] : idx[y * layout.N + x];
+          int b_idx = y * block;
+          int *inc = incs + 2 * i * div;
+          if (i == start) {
+            // first increment of each reduction is actually the offset
+            inc[0] = b_idx;
+            inc[1] = a_idx;
+          } else {
+            inc[0] = b_idx - prev_b_idx - (div - 1) * step;
+            inc[1] = (a_idx - prev_a_idx) * block * block - (div - 1) * a_step;
+          }
+          for (int d = 1; d < div; d++) {
+            inc[2 * d] = step;
+            inc[2 * d + 1] = a_step;
+          }
+          prev_a_idx = a_idx;
+          prev_b_idx = b_idx;
+          i++;
+        }
+        int s = h * X + x;
+        int size = i - start;
+        header[4 * s + 0] = std::max(std::min(start, num_blocks - 1), 0) * 2 * div + 4 * width;
+        header[4 * s + 1] = size * step * div;
+        header[4 * s + 2] = x;
+        header[4 * s + 3] = h;
+      }
+    }
+  }
+  return {lut, width};
+}
+
+// -----------------------------
+// Softmax
+// -----------------------------
+
+// header: (number of blocks, offset of the blocks) for each (head, row)
+// blocks: (index, column, row, head) of each non-zero block
+std::pair<std::vector<int>, int> softmax_lut(const layout_t &layout) {
+  int H = layout.H, M = layout.M, N = layout.N;
+  std::vector<int> offsets = head_offsets(layout);
+  std::vector<int> lut(2 * H * M + 4 * offsets[H]);
+  int maxlut = 0;
+#pragma omp parallel for reduction(max : maxlut)
+  for (int h = 0; h < H; h++) {
+    int i = offsets[h];
+    for (int m = 0; m < M; m++) {
+      int start = i;
+      for (int n = 0; n < N; n++) {
+        if (!layout(h, m, n))
+          continue;
+        int *core = lut.data() + 2 * H * M + 4 * i;
+        core[0] = i;
+        core[1] = n;
+        core[2] = m;
+        core[3] = h;
+        i++;
+      }
+      lut[2 * (h * M + m) + 0] = i - start;
+      lut[2 * (h * M + m) + 1] = start * 4 + 2 * H * M;
+      maxlut = std::max(maxlut, i - start);
+    }
+  }
+  return {lut, maxlut};
+}
+
+// -----------------------------
+// Cache
+// -----------------------------
+
+// least-recently used look-up tables, keyed by
+// builder, arguments and layout bits
+class lut_cache {
+public:
+  struct entry {
+    luts_t luts;
+    int value;
+  };
+
+  template <class Fn>
+  const entry &get(const std::string &key, Fn &&build) {
+    auto it = map_.find(key);
+    if (it != map_.end()) {
+      order_.splice(order_.begin(), order_, it->second);
+      return it->second->second;
+    }
+    order_.push_front({key, build()});
+    map_[key] = order_.begin();
+    if (map_.size() > capacity_) {
+      map_.erase(order_.back().first);
+      order_.pop_back();
+    }
+    return order_.front().second;
+  }
+
+  void clear() {
+    map_.clear();
+    order_.clear();
+  }
+
+private:
+  const size_t capacity_ = 256;
+  std::list<std::pair<std::string, entry>> order_;
+  std::unordered_map<std::string, std::list<std::pair<std::string, entry>>::iterator> map_;
+};
+
+static lut_cache cache;
+
+typedef pybind11::array_t<uint8_t, pybind11::array::c_style> bits_t;
+
+std::string make_key(const std::string &name, const bits_t &bits, std::vector<int> args) {
+  std::string key = name;
+  for (int x : args)
+    key.append((const char *)&x, sizeof(x));
+  key.append((const char *)bits.data(), bits.size());
+  return key;
+}
+
+layout_t make_layout(const bits_t &bits, int H, int M, int N) {
+  if ((size_t)bits.size() * 8 < (size_t)H * M * N)
+    throw std::runtime_error("layout bits are smaller than H * M * N");
+  return layout_t(bits.data(), H, M, N);
+}
+
+pybind11::array_t<int> to_array(const std::vector<int> &lut) {
+  return pybind11::array_t<int>(lut.size(), lut.data());
+}
+
+void init_blocksparse(pybind11::module &m) {
+  pybind11::module subm = m.def_submodule("blocksparse");
+  subm.def("sdd_lut", [](const bits_t &bits, int H, int M, int N, int start_width) {
+    std::string key = make_key("sdd", bits, {H, M, N, start_width});
+    const lut_cache::entry &e = cache.get(key, [&]() {
+      return lut_cache::entry{sdd_lut(make_layout(bits, H, M, N), start_width), 0};
+    });
+    std::vector<std::pair<int, pybind11::array_t<int>>> ret;
+    for (const auto &x : e.luts)
+      ret.push_back({x.first, to_array(x.second)});
+    return ret;
+  }, "super-blocking for block-sparse matrix multiplication");
+  subm.def("dsd_lut", [](const bits_t &bits, int H, int M, int N, int block, int step, bool trans) {
+    std::string key = make_key("dsd", bits, {H, M, N, block, step, trans});
+    const lut_cache::entry &e = cache.get(key, [&]() {
+      auto lut = dsd_lut(make_layout(bits, H, M, N), block, step, trans);
+      return lut_cache::entry{{{0, std::move(lut.first)}}, lut.second};
+    });
+    return std::make_pair(to_array(e.luts[0].second), e.value);
+  }, "pointer increments for dense = sparse x dense matrix multiplication");
+  subm.def("softmax_lut", [](const bits_t &bits, int H, int M, int N) {
+    std::string key = make_key("softmax", bits, {H, M, N});
+    const lut_cache::entry &e = cache.get(key, [&]() {
+      auto lut = softmax_lut(make_layout(bits, H, M, N));
+      return lut_cache::entry{{{0, std::move(lut.first)}}, lut.second};
+    });
+    return std::make_pair(to_array(e.luts[0].second), e.value);
+  }, "rows of non-zero blocks for block-sparse softmax");
+  subm.def("clear_cache", []() { cache.clear(); }, "clears cached look-up tables");
+}
@@ -128,6 +128,28 @@ void init_triton_runtime(py::module &&m) {
       return -1;
   });
 
+  // query the number of threads that can be resident on a multiprocessor
+  m.def("max_threads_per_multiprocessor", [](backend_t backend, uint64_t device) {
+      if (backend == HOST)
+        return 0;
+      if(backend == CUDA)
+        return cuGetInfo<CU_DEVICE_ATTRIBUTE_MAX_THREADS_PER_MULTIPROCESSOR>(device);
+      if(backend == ROCM)
+        return hipGetInfo<hipDeviceAttributeMaxThreadsPerMultiProcessor>(device);
+      return -1;
+  });
+
+  // query the number of 32-bit registers of a multiprocessor
+  m.def("regs_per_multiprocessor", [](backend_t backend, uint64_t device) {
+      if (backend == HOST)
+        return 0;
+      if(backend == CUDA)
+        return cuGetInfo<CU_DEVICE_ATTRIBUTE_MAX_REGISTERS_PER_MULTIPROCESSOR>(device);
+      if(backend == ROCM)
+        return hipGetInfo<hipDeviceAttributeMaxRegistersPerBlock>(device);
+      return -1;
+  });
+
   // enqueue
   m.def("enqueue", [](backend_t backend, uint64_t stream, uint64_t kernel,
                       uint64_t grid_0, uint64_t grid_1, uint64_t grid_2,
@@ -201,9 +223,45 @@ std::tuple<uint64_t, uint64_t> hip_load_binary(const std::string& name, asm_map_
 // Compile Triton-IR to assembly
 // --------------------------------------- 
 
+// python representation of the static analyses run during compilation
+py::list report_bank_conflicts(const triton::codegen::compile_report& report){
+  py::list ret;
+  for(const triton::codegen::analysis::bank_access& acc: report.bank_conflicts){
+    py::dict x;
+    x["inst"] = acc.inst->repr();
+    x["name"] = acc.inst->get_name();
+    x["is_write"] = acc.is_write;
+    x["wavefronts"] = acc.wavefronts;
+    x["phases"] = acc.phases;
+    x["max_ways"] = acc.max_ways;
+    ret.append(x);
+  }
+  return ret;
+}
+
+py::list report_memory_accesses(const triton::codegen::compile_report& report){
+  py::list ret;
+  for(const triton::codegen::analysis::memory_access& acc: report.memory_accesses){
+    py::dict x;
+    x["inst"] = acc.inst->repr();
+    x["name"] = acc.inst->get_name();
+    x["is_masked"] = acc.is_masked;
+    x["contiguous"] = acc.contiguous;
+    x["alignment"] = acc.alignment;
+    x["nts"] = acc.nts;
+    x["vec"] = acc.vec;
+    x["bits"] = acc.bits;
+    x["instructions"] = acc.instructions;
+    x["transactions"] = acc.transactions;
+    x["limit"] = acc.limit;
+    ret.append(x);
+  }
+  return ret;
+}
+
 // CUDA
-std::tuple<std::string, asm_map_t, int> cu_compile_ttir(const std::string& name, ir::module &ir, 
-                                                               uint64_t device, int num_warps, int num_stages,
+std::tuple<std::string, asm_map_t, int, int> cu_compile_ttir(const std::string& name, ir::module &ir, 
+                                                               uint64_t device, int num_warps, int num_stages, int num_unroll,
                                                                asm_map_t &asm_map){
   llvm::LLVMContext ctx;
   // device properties
@@ -216,7 +274,12 @@ std::tuple<std::string, asm_map_t, int> cu_compile_ttir(const std::string& name,
   // Triton-IR -> NVPTX LLVM-IR
   triton::codegen::nvidia_cu_target target(cc);
   int n_shared_bytes;
-  auto llvm = triton::codegen::add_passes_to_emit_bin(ir, ctx, &target, cc, num_warps, num_stages, n_shared_bytes);
+  int n_regs;
+  triton::codegen::compile_report report;
+  auto llvm = triton::codegen::add_passes_to_emit_bin(ir, ctx, &target, cc, num_warps, num_stages, num_unroll, n_shared_bytes, n_regs,
+                                                      false, &report);
+  asm_map["bank_conflicts"] = report_bank_conflicts(report);
+  asm_map["memory_accesses"] = report_memory_accesses(report);
   std::string tmp;
   llvm::raw_string_ostream llir(tmp);
   llir << *llvm;
@@ -231,18 +294,19 @@ std::tuple<std::string, asm_map_t, int> cu_compile_ttir(const std::string& name,
     py::bytes bytes(cubin);
     asm_map["cubin"] = bytes;
   }
-  return std::make_tuple(name, asm_map, n_shared_bytes);
+  return std::make_tuple(name, asm_map, n_shared_bytes, n_regs);
 }
 
 // HIP
-std::tuple<std::string, asm_map_t, int> hip_compile_ttir(const std::string& name, ir::module &ir, 
-                                                                uint64_t device, int num_warps, int num_stages, 
+std::tuple<std::string, asm_map_t, int, int> hip_compile_ttir(const std::string& name, ir::module &ir, 
+                                                                uint64_t device, int num_warps, int num_stages, int num_unroll,
                                                                 asm_map_t &asm_map){
   llvm::LLVMContext ctx;
   // Triton-IR -> NVPTX LLVM-IR
   triton::codegen::amd_cl_target target;
   int n_shared_bytes;
-  auto llvm = triton::codegen::add_passes_to_emit_bin(ir, ctx, &target, 70, num_warps, num_stages, n_shared_bytes);
+  int n_regs;
+  auto llvm = triton::codegen::add_passes_to_emit_bin(ir, ctx, &target, 70, num_warps, num_stages, num_unroll, n_shared_bytes, n_regs);
   std::string tmp;
   llvm::raw_string_ostream llir(tmp);
   llir << *llvm;
@@ -251,12 +315,54 @@ std::tuple<std::string, asm_map_t, int> hip_compile_ttir(const std::string& name
   // LLVM-IR -> HSA-CO
   std::string path = drv::llir_to_amdgpu(llvm.get(), "gfx908");
   asm_map["hsaco"] = py::cast(path);
-  return std::make_tuple(name, asm_map, n_shared_bytes);
+  return std::make_tuple(name, asm_map, n_shared_bytes, n_regs);
+}
+
+// Estimate resource usage without emitting any code
+std::tuple<int, int> estimate_ttir(backend_t backend, ir::module &ir, uint64_t device,
+                                   int num_warps, int num_stages, int num_unroll){
+  llvm::LLVMContext ctx;
+  int n_shared_bytes;
+  int n_regs;
+  if(backend == CUDA){
+    CUdevice dev = (CUdevice)device;
+    size_t major = cuGetInfo<CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MAJOR>(dev);
+    size_t minor = cuGetInfo<CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MINOR>(dev);
+    size_t cc = major*10 + minor;
+    triton::codegen::nvidia_cu_target target(cc);
+    triton::codegen::add_passes_to_emit_bin(ir, ctx, &target, cc, num_warps, num_stages, num_unroll, n_shared_bytes, n_regs, true);
+  }
+  else{
+    triton::codegen::amd_cl_target target;
+    triton::codegen::add_passes_to_emit_bin(ir, ctx, &target, 70, num_warps, num_stages, num_unroll, n_shared_bytes, n_regs, true);
+  }
+  return std::make_tuple(n_regs, n_shared_bytes);
+}
+
+// Run the static analyses for a given compute capability
+// without generating code. This does not require a device
+py::dict analyze_ttir(ir::module &ir, int cc, int num_warps, int num_stages, int num_unroll){
+  llvm::LLVMContext ctx;
+  int n_shared_bytes;
+  int n_regs;
+  triton::codegen::compile_report report;
+  triton::codegen::nvidia_cu_target target(cc);
+  triton::codegen::add_passes_to_emit_bin(ir, ctx, &target, cc, num_warps, num_stages, num_unroll, n_shared_bytes, n_regs, true, &report);
+  py::dict ret;
+  ret["num_regs"] = n_regs;
+  ret["shared_mem"] = n_shared_bytes;
+  ret["bank_conflicts"] = report_bank_conflicts(report);
+  ret["memory_accesses"] = report_memory_accesses(report);
+  std::ostringstream ttir;
+  ir::print(ir, ttir);
+  ret["ttir"] = ttir.str();
+  return ret;
 }
 
 void init_triton_codegen(py::module &&m) {
   m.def(
-      "compile_ttir", [](backend_t backend, ir::module &ir, uint64_t device, int num_warps, int num_stages) {
+      "compile_ttir", [](backend_t backend, ir::module &ir, uint64_t device, int num_warps, int num_stages,
+                         int num_unroll) {
         std::string name = ir.get_function_list()[0]->get_name();
         // record asm as we generate
         asm_map_t asm_map;
@@ -265,10 +371,12 @@ void init_triton_codegen(py::module &&m) {
         asm_map["ttir"] = py::cast(ttir.str());
         llvm::LLVMContext ctx;
         if(backend == CUDA)
-          return cu_compile_ttir(name, ir, device, num_warps, num_stages, asm_map);
+          return cu_compile_ttir(name, ir, device, num_warps, num_stages, num_unroll, asm_map);
         if(backend == ROCM)
-          return hip_compile_ttir(name, ir, device, num_warps, num_stages, asm_map);
+          return hip_compile_ttir(name, ir, device, num_warps, num_stages, num_unroll, asm_map);
       }, py::return_value_policy::take_ownership);
+  m.def("estimate_ttir", &estimate_ttir);
+  m.def("analyze_ttir", &analyze_ttir);
   m.def("load_binary", [](backend_t backend, const std::string& name, asm_map_t &asm_map, size_t n_shared_bytes, uint64_t dev){
         if(backend == CUDA)
           return cu_load_binary(name, asm_map, n_shared_bytes, dev);
@@ -341,6 +449,16 @@ void init_triton_frontend(py::module &&m) {
   m.def("min", &ir::dispatch::min, ret::reference);
   m.def("max", &ir::dispatch::max, ret::reference);
   m.def("sum", &ir::dispatch::sum, ret::reference);
+  m.def("argmin", &ir::dispatch::argmin, ret::reference);
+  m.def("argmax", &ir::dispatch::argmax, ret::reference);
+  m.def("min_with_index", &ir::dispatch::min_with_index, ret::reference);
+  m.def("max_with_index", &ir::dispatch::max_with_index, ret::reference);
+  // scans
+  m.def("cumsum", &ir::dispatch::cumsum, ret::reference);
+  m.def("cumprod", &ir::dispatch::cumprod, ret::reference);
+  // sorting
+  m.def("sort", &ir::dispatch::sort, ret::reference);
+  m.def("topk", &ir::dispatch::topk, ret::reference);
   // math
   m.def("umulhi", &ir::dispatch::umulhi, ret::reference);
   m.def("exp", &ir::dispatch::exp, ret::reference);
@@ -378,7 +496,8 @@ void init_triton_ir(py::module &&m) {
 
   py::class_<ir::constant_int, ir::constant>(m, "constant_int")
       .def_property_readonly("value", &ir::constant_int::get_value)
-      .def("__int__", [](ir::constant_int *self) { return self->get_value(); });
+      .def("__int__", [](ir::constant_int *self) { return self->get_value(); })
+      .def("__bool__", [](ir::constant_int *self) { return self->get_value() != 0; });
 
   py::class_<ir::constant_fp, ir::constant>(m, "constant_float")
       .def_property_readonly("value", &ir::constant_fp::get_value);
@@ -391,9 +510,11 @@ void init_triton_ir(py::module &&m) {
       .def("is_int", static_cast<bool (ir::type::*)() const>(&ir::type::is_integer_ty))
       .def("is_floating", &ir::type::is_floating_point_ty)
       .def("is_block", &ir::type::is_block_ty)
+      .def("is_struct", &ir::type::is_struct_ty)
       .def("make_ptr", &ir::pointer_type::get, ret::reference)
       .def("make_function", &ir::function_type::get, ret::reference)
       .def("make_block", &ir::block_type::get, ret::reference)
+      .def("make_struct", &ir::struct_type::get, ret::reference)
       .def("get_void", &ir::type::get_void_ty, ret::reference)
       .def("get_fp8", &ir::type::get_fp8_ty, ret::reference)
       .def("get_fp16", &ir::type::get_fp16_ty, ret::reference)
@@ -420,7 +541,8 @@ void init_triton_ir(py::module &&m) {
 
       .def_property_readonly("fp_mantissa_width", &ir::type::get_fp_mantissa_width)
       .def_property_readonly("scalar", &ir::type::get_scalar_ty)
-      .def_property_readonly("context", &ir::type::get_context, ret::reference);
+      .def_property_readonly("context", &ir::type::get_context, ret::reference)
+      .def("__repr__", &ir::type::repr);
 
   py::class_<ir::pointer_type, ir::type>(m, "pointer_type")
       .def_property_readonly("element", &ir::pointer_type::get_element_ty, ret::reference);
@@ -449,6 +571,8 @@ void init_triton_ir(py::module &&m) {
       .value("noalias", eattr::noalias)
       .value("aligned", eattr::aligned)
       .value("multiple_of", eattr::multiple_of)
+      .value("equal_to_one", eattr::equal_to_one)
+      .value("num_programs", eattr::num_programs)
       .value("retune", eattr::retune)
       .value("not_implemented", eattr::not_implemented);
 
@@ -458,12 +582,15 @@ void init_triton_ir(py::module &&m) {
   py::class_<ir::function>(m, "function")
       .def_property_readonly("args", &ir::function::args)
       .def_property_readonly("attrs", &ir::function::attrs)
-      .def("add_attr", &ir::function::add_attr);
+      .def("add_attr", &ir::function::add_attr)
+      .def("set_internal", [](ir::function *self) { self->set_linkage(ir::function::internal); })
+      .def("reset_type", &ir::function::reset_type);
 
   py::class_<ir::argument, ir::value>(m, "argument");
 
   py::class_<ir::basic_block, ir::value>(m, "basic_block")
-      .def("create", &ir::basic_block::create, ret::reference)
+      .def_static("create", &ir::basic_block::create, ret::reference,
+           py::arg("context"), py::arg("name"), py::arg("parent"), py::arg("next") = nullptr)
       .def_property_readonly("parent", &ir::basic_block::get_parent, ret::reference);
 
   py::class_<ir::builder>(m, "builder", py::dynamic_attr())
@@ -474,6 +601,10 @@ void init_triton_ir(py::module &&m) {
       .def("br", &ir::builder::create_br, ret::reference)
       .def("cond_br", &ir::builder::create_cond_br, ret::reference)
       .def("ret_void", &ir::builder::create_ret_void, ret::reference)
+      .def("ret", &ir::builder::create_ret, ret::reference)
+      .def("call", &ir::builder::create_call, ret::reference)
+      .def("extract_value", &ir::builder::create_extract_value, ret::reference)
+      .def("insert_value", &ir::builder::create_insert_value, ret::reference)
       .def("get_insert_block", &ir::builder::get_insert_block, ret::reference)
       .def("set_insert_block", (void (ir::builder::*)(ir::basic_block *)) & ir::builder::set_insert_point)
       // constants
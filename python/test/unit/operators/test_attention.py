@@ -0,0 +1,42 @@
+import torch
+import triton
+import pytest
+
+
+@pytest.mark.parametrize("Z, H, N_CTX, D, causal, dtype",
+    [
+    (Z, H, N_CTX, D, causal, dtype) for Z, H in [(2, 3)]
+                                    for N_CTX in [128, 197, 1024]
+                                    for D in [32, 64]
+                                    for causal in [False, True]
+                                    for dtype in ['float16', 'bfloat16']
+    ]
+                         )
+def test_op(Z, H, N_CTX, D, causal, dtype):
+    torch.manual_seed(0)
+    dtype = {'float16': torch.float16, 'bfloat16': torch.bfloat16}[dtype]
+    # create inputs
+    q, k, v = [(.5 * torch.randn((Z, H, N_CTX, D), dtype=dtype, device='cuda')).requires_grad_()
+               for _ in range(3)]
+    sm_scale = 0.3
+    do = torch.randn_like(q)
+    # torch reference, in fp32
+    p = torch.matmul(q.float(), k.float().transpose(-1, -2)) * sm_scale
+    if causal:
+        mask = torch.tril(torch.ones((N_CTX, N_CTX), device='cuda', dtype=torch.bool))
+        p = p.masked_fill(~mask, float('-inf'))
+    th_o = torch.matmul(torch.softmax(p, dim=-1), v.float())
+    th_o.backward(do.float())
+    th_dq, th_dk, th_dv = [x.grad.clone() for x in [q, k, v]]
+    for x in [q, k, v]:
+        x.grad = None
+    # triton
+    tt_o = triton.ops.attention(q, k, v, causal, sm_scale)
+    tt_o.backward(do)
+    tt_dq, tt_dk, tt_dv = [x.grad.clone() for x in [q, k, v]]
+    # compare; numpy has no bf16
+    decimal = 2 if dtype == torch.float16 else 1
+    triton.testing.assert_almost_equal(th_o, tt_o.float(), decimal=decimal)
+    triton.testing.assert_almost_equal(th_dq, tt_dq.float(), decimal=decimal)
+    triton.testing.assert_almost_equal(th_dk, tt_dk.float(), decimal=decimal)
+    triton.testing.assert_almost_equal(th_dv, tt_dv.float(), decimal=decimal)
@@ -162,3 +162,215 @@ def triton_attention(
     w = sparse_softmax(w, scale=scale, attn_mask=attn_mask, attn_mask_mode="mul")
     a = sparse_dot_dsd_nn(w, value)
     return a
+
+
+# ---------------
+# look-up tables
+# ---------------
+
+def _sdd_lut_ref(layout, start_width):
+    # previous implementation of sdd_lut (superblock.cc), in python
+    H, M, N = layout.shape
+    layout = layout.tolist()
+    idx = [[[0] * N for _ in range(M)] for _ in range(H)]
+    current = 0
+    for h in range(H):
+        for m in range(M):
+            for n in range(N):
+                if layout[h][m][n]:
+                    idx[h][m][n] = current
+                    current += 1
+    ret = []
+    max_width = start_width
+    while max_width > 0:
+        lut = []
+        tmp = [[[0] * N for _ in range(M)] for _ in range(H)]
+        for h in range(H):
+            ii_left = [-1] * max_width
+            ii_top = [[-1] * N for _ in range(max_width)]
+            for m in range(M):
+                for n in range(N):
+                    if layout[h][m][n] == 0:
+                        continue
+                    n_left = ii_left[-1]
+                    m_top = ii_top[-1][n]
+                    top = tmp[h][m_top][n] if m_top >= 0 else 0
+                    left = tmp[h][m][n_left] if n_left >= 0 else 0
+                    topleft = tmp[h][m_top][n_left] if m_top >= 0 and n_left >= 0 else 0
+                    width = min(left, top, topleft) + 1
+                    for nn in range(n_left + 1, n):
+                        if ii_top[-1][nn] > ii_top[-1][n]:
+                            width = 1
+                    tmp[h][m][n] = width
+                    ii_left = ii_left[1:] + [n]
+                    for k in range(max_width - 1):
+                        ii_top[k][n] = ii_top[k + 1][n]
+                    ii_top[-1][n] = m
+                    if width != max_width:
+                        continue
+                    for km in range(max_width):
+                        for kn in range(max_width):
+                            mm, nn = ii_top[km][n], ii_left[kn]
+                            if mm < 0 or nn < 0:
+                                continue
+                            layout[h][mm][nn] = 0
+                            tmp[h][mm][nn] = 0
+                            lut += [h, mm, nn, idx[h][mm][nn]]
+        if lut:
+            ret.append((max_width, lut))
+        max_width //= 2
+    return ret
+
+
+def _dsd_lut_ref(layout, block, step, trans):
+    # previous implementation of dsd_lut, in torch
+    sizes = torch.sum(layout, 2 if trans else 1)
+    head_id, col_id = sizes.nonzero(as_tuple=True)
+    sizes = sizes.flatten()
+    segments = sizes*step
+    # pointer increments
+    if trans:
+        nnz = layout.nonzero(as_tuple=False)
+    else:
+        nnz = layout.transpose(1, 2).nonzero(as_tuple=False)
+    num_blocks = nnz.size(0)
+    offsets = torch.zeros_like(sizes)
+    offsets[1:] = torch.cumsum(sizes[:-1], dim=0)
+    offsets = torch.min(offsets, (num_blocks - 1) * torch.ones_like(offsets))
+    # -------------------------------
+    # dense input pointer increments
+    # -------------------------------
+    # given a list of the indices for the first element of each non-zero block.
+    # For example, for the indices
+    # [32, 80, 128, 256, 288]
+    # we would generate the increments
+    # [32, 48, 48, 128, 32]
+    #        ^
+    #   index of first element
+    # Note that the inner loop matmul kernel may have a fixed step size (e.g., TILE_K)
+    # that is smaller than the block size, so we need to do a bit of extra work
+    # to handle this case
+    B_idx = nnz[:, 2] * block
+    B_incs = B_idx.clone()
+    B_incs[1:] -= B_idx[:-1]
+    div = block // step
+    B_incs = B_incs.view(-1, 1).repeat(1, div)
+    B_incs[:, 1:] = step
+    B_incs[:, 0] -= (div - 1) * step
+    # first increment for each reduction is actually the offset
+    B_incs[offsets[segments > 0], 0] = B_idx[offsets[segments > 0]]
+    B_incs = B_incs.view(-1)
+    # -------------------------------
+    # sparse input pointer increments
+    # -------------------------------
+    # same as above, except that the increments are in the sparse memory layout
+    if trans:
+        A_idx = torch.arange(num_blocks)
+    else:
+        A_idx = torch.tensor([], dtype=torch.int64, device=layout.device)
+        current_offset = 0
+        for z in range(layout.size(0)):
+            layoutw = layout[z, :, :].clone()
+            msum = layoutw.sum()
+            layoutw[layoutw > 0] = 1 + torch.arange(msum)
+            A_idx = torch.cat((A_idx, current_offset + layoutw.T[layoutw.T > 0] - 1))
+            current_offset += msum
+    A_incs = A_idx * block * block
+    A_incs[1:] -= A_idx[:-1] * block * block
+    A_incs = A_incs.view(-1, 1).repeat(1, div)
+    if trans:
+        A_incs[:, 1:] = step
+        A_incs[:, 0] -= (div - 1) * step
+    else:
+        A_incs[:, 1:] = step * block
+        A_incs[:, 0] -= (div - 1) * step * block
+    A_incs[offsets[segments > 0], 0] = A_idx[offsets[segments > 0]]
+    A_incs = A_incs.view(-1)
+    # create header
+    width    = col_id.size(0)
+    offsets  = offsets*2*div + 4*width
+    segments = segments*div
+    header   = torch.stack((offsets, segments, col_id, head_id), dim=1).view(-1).contiguous()
+    # create increments
+    incs     = torch.stack((B_incs, A_incs), dim=1).view(-1).contiguous()
+    incs     = torch.cat((incs, torch.zeros(2, device=incs.device, dtype=incs.dtype)))
+    # create lut
+    lut = torch.cat((header, incs))
+    return lut.type(torch.int32), width
+
+
+def _softmax_lut_ref(layout):
+    # previous implementation of _softmax.make_lut, in torch
+    _empty = torch.tensor([], dtype=torch.int64, device=layout.device)
+    sizes = _empty.clone()
+    # sizes along rows
+    for h in range(layout.shape[0]):
+        sizes = torch.cat((sizes, layout[h, :, :].sum(-1)))
+    # offsets in block format
+    offsets = torch.zeros_like(sizes)
+    offsets[1:] = torch.cumsum(sizes[:-1], dim=0)
+    # block indices
+    idx = torch.arange(layout.sum())
+    head = layout.nonzero(as_tuple=False)[:, 0]
+    rows = layout.nonzero(as_tuple=False)[:, 1]
+    columns = layout.nonzero(as_tuple=False)[:, 2]
+    core = torch.stack((idx, columns, rows, head), dim=1).view(-1)
+    # construct look-up table
+    offsets = offsets * 4 + 2 * sizes.numel()
+    header = torch.stack((sizes, offsets), dim=1).view(-1)
+    lut = torch.cat((header, core)).type(torch.int32)
+    return lut, int(sizes.max())
+
+
+def _random_layout(H, M, N, density, full):
+    layout = (torch.rand(H, M, N) < density).long()
+    # the previous dsd_lut required every row and column to hold a block
+    if full:
+        layout[:, torch.arange(M), torch.arange(M) % N] = 1
+        layout[:, torch.arange(N) % M, torch.arange(N)] = 1
+    return layout
+
+
+@pytest.mark.parametrize("H, M, N", [(1, 4, 4), (3, 16, 8), (2, 24, 40)])
+@pytest.mark.parametrize("density", [0.1, 0.5, 0.9])
+@pytest.mark.parametrize("BLOCK", [16, 32, 64])
+def test_make_lut(H, M, N, density, BLOCK):
+    from triton.ops.blocksparse.matmul import sdd_lut, dsd_lut
+    from triton.ops.blocksparse.softmax import _softmax
+    torch.manual_seed(0)
+    layout = _random_layout(H, M, N, density, full=True)
+    # sdd
+    luts, _, widths, packs = sdd_lut(layout, BLOCK, 'cpu')
+    ref = _sdd_lut_ref(layout, 128 // BLOCK)
+    assert packs == [size for size, _ in ref]
+    for lut, width, (size, ref_lut) in zip(luts, widths, ref):
+        assert lut.view(-1).tolist() == ref_lut
+        assert width == len(ref_lut) // (4 * size * size)
+    # dsd / dds
+    step = min(BLOCK, 32)
+    for trans in [False, True]:
+        lut, _, width, _ = dsd_lut(layout, BLOCK, step, trans, 'cpu')
+        ref_lut, ref_width = _dsd_lut_ref(layout, BLOCK, step, trans)
+        assert width == ref_width
+        assert torch.equal(lut, ref_lut)
+    # softmax, which also supports empty rows
+    layout = _random_layout(H, M, N, density, full=False)
+    lut, maxlut = _softmax.make_lut(layout, BLOCK, 'cpu')
+    ref_lut, ref_maxlut = _softmax_lut_ref(layout)
+    assert maxlut == ref_maxlut
+    assert torch.equal(lut, ref_lut)
+
+
+def test_make_lut_empty_rows():
+    from triton.ops.blocksparse.matmul import dsd_lut
+    layout = torch.zeros(2, 4, 6, dtype=torch.long)
+    layout[0, 1, 2] = layout[0, 1, 5] = layout[1, 3, 0] = 1
+    for trans, X in [(True, 4), (False, 6)]:
+        lut, _, width, _ = dsd_lut(layout, 16, 16, trans, 'cpu')
+        # one header per row (trans) or column of each head
+        assert width == 2 * X
+        header = lut[:4 * width].view(-1, 4)
+        sizes = layout.sum(2 if trans else 1).view(-1)
+        assert torch.equal(header[:, 1], sizes.int() * 16)
+        assert header[:, 2].tolist() == list(range(X)) * 2
+        assert header[:, 3].tolist() == [0] * X + [1] * X
@@ -0,0 +1,63 @@
+import pytest
+import triton
+import torch
+
+
+@pytest.mark.parametrize("N, H, W, C, K, R, S, STRIDE, PAD, DIL, DTYPE",
+    [
+    # 1x1 and 3x3 convolutions of a ResNet
+    (8, 56, 56, 64, 64, 1, 1, 1, 0, 1, 'float16'),
+    (8, 56, 56, 64, 64, 3, 3, 1, 1, 1, 'float16'),
+    (8, 28, 28, 128, 256, 3, 3, 2, 1, 1, 'float16'),
+    (4, 14, 14, 256, 256, 3, 3, 1, 2, 2, 'float16'),
+    # stem: channels are padded
+    (4, 64, 64, 3, 32, 7, 7, 2, 3, 1, 'float16'),
+    # odd shapes
+    (3, 17, 31, 48, 40, 3, 5, (2, 1), (1, 2), (1, 2), 'float16'),
+    (2, 9, 9, 32, 16, 3, 3, 1, 0, 1, 'float32'),
+    ]
+)
+def test_op(N, H, W, C, K, R, S, STRIDE, PAD, DIL, DTYPE):
+    torch.manual_seed(0)
+    dtype = {'float16': torch.float16, 'float32': torch.float32}[DTYPE]
+    x = torch.randn((N, H, W, C), device='cuda', dtype=dtype)
+    w = torch.randn((K, R, S, C), device='cuda', dtype=dtype)
+    bias = torch.randn((K, ), device='cuda', dtype=dtype)
+    # torch reference, in NCHW
+    th_y = torch.nn.functional.conv2d(x.permute(0, 3, 1, 2), w.permute(0, 3, 1, 2), bias,
+                                      stride=STRIDE, padding=PAD, dilation=DIL)
+    th_y = torch.relu(th_y).permute(0, 2, 3, 1)
+    tt_y = triton.ops.conv2d(x, w, bias, stride=STRIDE, padding=PAD, dilation=DIL, activation='relu')
+    triton.testing.assert_almost_equal(th_y, tt_y)
+
+
+
+@pytest.mark.parametrize("num_stages", [1, 2, 4])
+def test_pipeline(num_stages):
+    # static analysis only: tensors can live on the host
+    N, H, W, C, K, R, S = 2, 9, 9, 32, 64, 3, 3
+    x = torch.empty((N, H, W, C), dtype=torch.float16)
+    w = torch.empty((K, R, S, C), dtype=torch.float16)
+    y = torch.empty((N, H, W, K), dtype=torch.float16)
+    kernel = triton.ops._conv.kernel._init_kernel().kernel
+    ttir = kernel.analyze(x, w, y, y, N * H * W, K, C, H, W, H, W, R, S,
+                          x.stride(0), x.stride(1), x.stride(2), 1, 1, 1, 1, 1, 1,
+                          BLOCK_M=64, BLOCK_N=64, BLOCK_K=32, GROUP_M=8,
+                          HAS_BIAS=False, ACTIVATION=None, HAS_RESIDUAL=False,
+                          compute_capability=(8, 0), num_stages=num_stages)['ttir']
+    # loads of the kernel, in and out of its loop; device functions follow the kernel
+    loop_loads, other_loads = [], []
+    block = None
+    for line in ttir.split('\n'):
+        if line.startswith('def '):
+            if block is not None:
+                break
+        elif line and not line[0].isspace() and ':' in line:
+            block = line.split(':')[0]
+        elif 'load' in line:
+            (loop_loads if block == 'loop' else other_loads).append(line.strip())
+    # the first num_stages - 1 blocks of both operands are prefetched before the loop,
+    # which loads the next ones; on sm80 they are asynchronous copies to shared memory
+    assert len(loop_loads) == 2
+    assert all('load_async' in i for i in loop_loads)
+    assert len(other_loads) == 2 * (num_stages - 1)
@@ -30,4 +30,36 @@ def test_op(M, N, dtype, mode):
         x.grad.zero_()
         th_y.backward(dy)
         th_dx = x.grad.clone()
-        triton.testing.assert_almost_equal(th_dx, tt_dx)
\ No newline at end of file
+        triton.testing.assert_almost_equal(th_dx, tt_dx)
+
+@pytest.mark.parametrize("M, N, label_smoothing, ignore_index, mode",
+    [
+    (M, N, label_smoothing, ignore_index, mode) for M in [128, 67]
+                                                for N in [857, 8573, 50257, 131072]
+                                                for label_smoothing in [0., 0.1]
+                                                for ignore_index in [None, 4]
+                                                for mode in ['forward', 'backward']
+    ]
+                         )
+def test_op_chunked(M, N, label_smoothing, ignore_index, mode):
+    torch.manual_seed(0)
+    # create inputs
+    x = torch.randn(M, N, dtype=torch.float16, device='cuda', requires_grad=True)
+    idx = torch.randint(0, N, (M, ), dtype=torch.int64, device='cuda')
+    idx[::3] = 4
+    # reference, in fp32
+    logprobs = torch.log_softmax(x.float(), dim=-1)
+    th_y = -(1 - label_smoothing) * logprobs.gather(1, idx[:, None])[:, 0] - label_smoothing * logprobs.mean(-1)
+    if ignore_index is not None:
+        th_y = th_y.masked_fill(idx == ignore_index, 0.)
+    tt_y = triton.ops.cross_entropy(x, idx, label_smoothing=label_smoothing, ignore_index=ignore_index)
+    if mode == 'forward':
+        triton.testing.assert_almost_equal(th_y, tt_y.float())
+    elif mode == 'backward':
+        dy = torch.randn_like(tt_y)
+        tt_y.backward(dy)
+        tt_dx = x.grad.clone()
+        x.grad.zero_()
+        th_y.backward(dy.float())
+        th_dx = x.grad.clone()
+        triton.testing.assert_almost_equal(th_dx, tt_dx)
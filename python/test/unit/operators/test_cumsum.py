@@ -0,0 +1,29 @@
+import torch
+import triton
+import pytest
+
+@pytest.mark.parametrize("M, N, dtype, block",
+    [
+    (M, N, dtype, block) for M, N in [(1, 1), (128, 100), (16, 2048), (4, 65536), (3, 1000003), (70000, 3)]
+                         for dtype in ['float16', 'float32', 'int32']
+                         for block in [None, 256]
+    ]
+                         )
+def test_op(M, N, dtype, block):
+    torch.manual_seed(0)
+    dtype = {'float16': torch.float16, 'float32': torch.float32, 'int32': torch.int32}[dtype]
+    # create inputs
+    if dtype == torch.int32:
+        x = torch.randint(-16, 16, (M, N), dtype=dtype, device='cuda')
+    else:
+        x = torch.randn(M, N, dtype=dtype, device='cuda')
+    # triton result
+    tt_y = triton.ops.cumsum(x, block=block)
+    # torch result
+    th_y = torch.cumsum(x if dtype == torch.int32 else x.double(), dim=-1)
+    th_y = th_y.int() if dtype == torch.int32 else th_y
+    # compare; partial sums of long rows are large
+    if dtype == torch.int32:
+        assert torch.equal(tt_y, th_y)
+    else:
+        assert torch.allclose(tt_y.double(), th_y, rtol=1e-2, atol=1e-1)
@@ -0,0 +1,45 @@
+import torch
+import triton
+import pytest
+
+@pytest.mark.parametrize("M, N, p, dtype, has_bias, has_residual",
+    [
+    (M, N, p, dtype, has_bias, has_residual) for M, N in [(1024, 1024), (821, 857)]
+                                             for p in [0.1, 0.5, 1.]
+                                             for dtype in ['float16', 'float32']
+                                             for has_bias in [False, True]
+                                             for has_residual in [False, True]
+    ]
+                         )
+def test_op(M, N, p, dtype, has_bias, has_residual):
+    torch.manual_seed(0)
+    dtype = {'float16': torch.float16, 'float32': torch.float32}[dtype]
+    # create inputs
+    x = torch.randn(M, N, dtype=dtype, device='cuda', requires_grad=True)
+    bias = torch.randn(N, dtype=dtype, device='cuda', requires_grad=True) if has_bias else None
+    residual = torch.randn(M, N, dtype=dtype, device='cuda', requires_grad=True) if has_residual else None
+    # forward pass
+    tt_y = triton.ops.dropout(x, p, bias=bias, residual=residual, seed=123)
+    # the mask is a function of the seed only
+    triton.testing.assert_almost_equal(tt_y, triton.ops.dropout(x, p, bias=bias, residual=residual, seed=123))
+    # recover the mask from the output; zeros of x + bias are kept
+    th_y = (x if bias is None else x + bias).float()
+    out = tt_y.float() - (0. if residual is None else residual.float())
+    keep = out != 0
+    keep |= th_y == 0
+    th_y = torch.where(keep, th_y / (1 - p) if p < 1 else torch.zeros_like(th_y), torch.zeros_like(th_y))
+    if residual is not None:
+        th_y = th_y + residual.float()
+    triton.testing.assert_almost_equal(th_y, tt_y.float())
+    # fraction of dropped elements
+    if p < 1:
+        assert abs(1 - keep.float().mean().item() - p) < 0.01
+    # backward pass uses the same mask
+    dy = torch.randn_like(tt_y)
+    tt_y.backward(dy)
+    th_dx = torch.where(keep, dy.float() / (1 - p) if p < 1 else torch.zeros_like(th_y), torch.zeros_like(th_y))
+    triton.testing.assert_almost_equal(th_dx, x.grad.float())
+    if has_bias:
+        triton.testing.assert_almost_equal(th_dx.sum(0), bias.grad.float())
+    if has_residual:
+        triton.testing.assert_almost_equal(dy, residual.grad)
@@ -0,0 +1,46 @@
+import pytest
+import triton
+import torch
+
+
+@pytest.mark.parametrize("SIZES, DTYPE, ACTIVATION",
+    [
+    (SIZES, DTYPE, ACTIVATION) for SIZES in [
+                                   [(256, 256, 256)],
+                                   [(128, 512, 256), (64, 512, 256), (0, 512, 256), (301, 512, 256)],
+                                   [(17, 33, 65), (512, 128, 1024), (129, 255, 31), (1, 1, 1)],
+                               ]
+                               for DTYPE in ['float16', 'float32']
+                               for ACTIVATION in [None, 'relu']
+    ]
+)
+def test_grouped(SIZES, DTYPE, ACTIVATION):
+    torch.manual_seed(0)
+    dtype = {'float16': torch.float16, 'float32': torch.float32}[DTYPE]
+    a = [torch.randn((M, K), device='cuda', dtype=dtype) for M, N, K in SIZES]
+    b = [torch.randn((K, N), device='cuda', dtype=dtype) for M, N, K in SIZES]
+    # transposed operand
+    b[0] = b[0].t().contiguous().t()
+    tt_c = triton.ops.grouped_matmul(a, b, activation=ACTIVATION)
+    for x, y, c in zip(a, b, tt_c):
+        th_c = torch.matmul(x, y)
+        if ACTIVATION == 'relu':
+            th_c = torch.relu(th_c)
+        triton.testing.assert_almost_equal(th_c, c)
+
+
+@pytest.mark.parametrize("Z, M, N, K, DTYPE",
+    [
+    (Z, M, N, K, DTYPE) for Z, M, N, K in [(1, 256, 256, 256), (48, 128, 64, 64), (7, 129, 255, 33)]
+                        for DTYPE in ['float16', 'float32']
+    ]
+)
+def test_batched(Z, M, N, K, DTYPE):
+    torch.manual_seed(0)
+    dtype = {'float16': torch.float16, 'float32': torch.float32}[DTYPE]
+    # attention-like layout: heads are strided views of a larger tensor
+    a = torch.randn((M, Z, K), device='cuda', dtype=dtype).transpose(0, 1)
+    b = torch.randn((Z, N, K), device='cuda', dtype=dtype).transpose(1, 2)
+    th_c = torch.matmul(a, b)
+    tt_c = triton.ops.batched_matmul(a, b)
+    triton.testing.assert_almost_equal(th_c, tt_c)
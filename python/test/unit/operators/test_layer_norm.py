@@ -0,0 +1,71 @@
+import torch
+import triton
+import pytest
+
+@pytest.mark.parametrize("M, N, dtype, norm, mode",
+    [
+    (M, N, dtype, norm, mode) for M in [1024, 821]
+                              for N in [512, 857, 1871, 4096, 8573]
+                              for dtype in ['float16', 'float32']
+                              for norm in ['layer', 'layer-no-bias', 'rms']
+                              for mode in ['forward', 'backward']
+    ]
+                         )
+def test_op(M, N, dtype, norm, mode):
+    torch.manual_seed(0)
+    dtype = {'float16': torch.float16, 'float32': torch.float32}[dtype]
+    # create inputs
+    x = torch.randn(M, N, dtype=dtype, device='cuda', requires_grad=True)
+    w = torch.rand(N, dtype=dtype, device='cuda', requires_grad=True)
+    b = torch.rand(N, dtype=dtype, device='cuda', requires_grad=True) if norm == 'layer' else None
+    inputs = [x, w] if b is None else [x, w, b]
+    # reference, in fp32
+    def ref(x, w, b):
+        x, w = x.float(), w.float()
+        if norm == 'rms':
+            return x * torch.rsqrt(x.pow(2).mean(-1, keepdim=True) + 1e-6) * w
+        return torch.nn.functional.layer_norm(x, (N, ), w, None if b is None else b.float(), eps=1e-5)
+    if norm == 'rms':
+        tt_y = triton.ops.rms_norm(x, w)
+    else:
+        tt_y = triton.ops.layer_norm(x, w, b)
+    th_y = ref(x, w, b)
+    if mode == 'forward':
+        triton.testing.assert_almost_equal(th_y, tt_y.float())
+    elif mode == 'backward':
+        dy = torch.randn_like(tt_y)
+        # triton backward
+        tt_y.backward(dy)
+        tt_grads = [t.grad.clone() for t in inputs]
+        # torch backward
+        for t in inputs:
+            t.grad = None
+        th_y.backward(dy.float())
+        th_grads = [t.grad.clone() for t in inputs]
+        for th_g, tt_g in zip(th_grads, tt_grads):
+            triton.testing.assert_almost_equal(th_g.float(), tt_g.float())
+
+
+@pytest.mark.parametrize("N, offset, dtype",
+    [(N, offset, dtype) for N in [512, 8573] for offset in [1e3, -1e4] for dtype in ['float16', 'float32']]
+                         )
+def test_large_mean(N, offset, dtype):
+    # E[x^2] - E[x]^2 cancels catastrophically for such inputs
+    torch.manual_seed(0)
+    dtype = {'float16': torch.float16, 'float32': torch.float32}[dtype]
+    x = (offset + torch.randn(64, N, device='cuda')).to(dtype)
+    w = torch.ones(N, dtype=dtype, device='cuda')
+    b = torch.zeros(N, dtype=dtype, device='cuda')
+    tt_y = triton.ops.layer_norm(x, w, b)
+    th_y = torch.nn.functional.layer_norm(x.float(), (N, ), w.float(), b.float(), eps=1e-5)
+    assert not torch.isnan(tt_y).any()
+    triton.testing.assert_almost_equal(th_y, tt_y.float(), decimal=1)
+
+
+def test_empty():
+    x = torch.randn(0, 512, dtype=torch.float16, device='cuda', requires_grad=True)
+    w = torch.rand(512, dtype=torch.float16, device='cuda', requires_grad=True)
+    y = triton.ops.layer_norm(x, w)
+    assert y.shape == (0, 512)
+    y.backward(torch.empty_like(y))
+    assert torch.equal(w.grad, torch.zeros_like(w))
@@ -5,68 +5,78 @@ import torch
 
 
 @pytest.mark.parametrize(
-    "BLOCK_M, BLOCK_N, BLOCK_K, SPLIT_K, NWARP, NSTAGE, M, N, K, AT, BT, DTYPE",
+    "BLOCK_M, BLOCK_N, BLOCK_K, SPLIT_K, STREAM_K, NWARP, NSTAGE, M, N, K, AT, BT, DTYPE",
     itertools.chain(
         *[
             [
                 # 1 warp
-                (16, 16, 16, 1, 1, 2, None, None, None, AT, BT, DTYPE),
-                (32, 16, 16, 1, 1, 2, None, None, None, AT, BT, DTYPE),
-                (16, 32, 16, 1, 1, 2, None, None, None, AT, BT, DTYPE),
-                (16, 16, 32, 1, 1, 2, None, None, None, AT, BT, DTYPE),
-                (32, 16, 32, 1, 1, 2, None, None, None, AT, BT, DTYPE),
-                (16, 32, 32, 1, 1, 2, None, None, None, AT, BT, DTYPE),
-                (16, 16, 64, 1, 1, 2, None, None, None, AT, BT, DTYPE),
-                (64, 16, 64, 1, 1, 2, None, None, None, AT, BT, DTYPE),
-                (16, 64, 64, 1, 1, 2, None, None, None, AT, BT, DTYPE),
+                (16, 16, 16, 1, 0, 1, 2, None, None, None, AT, BT, DTYPE),
+                (32, 16, 16, 1, 0, 1, 2, None, None, None, AT, BT, DTYPE),
+                (16, 32, 16, 1, 0, 1, 2, None, None, None, AT, BT, DTYPE),
+                (16, 16, 32, 1, 0, 1, 2, None, None, None, AT, BT, DTYPE),
+                (32, 16, 32, 1, 0, 1, 2, None, None, None, AT, BT, DTYPE),
+                (16, 32, 32, 1, 0, 1, 2, None, None, None, AT, BT, DTYPE),
+                (16, 16, 64, 1, 0, 1, 2, None, None, None, AT, BT, DTYPE),
+                (64, 16, 64, 1, 0, 1, 2, None, None, None, AT, BT, DTYPE),
+                (16, 64, 64, 1, 0, 1, 2, None, None, None, AT, BT, DTYPE),
                 # 2 warp
-                (64, 32, 64, 1, 2, 2, None, None, None, AT, BT, DTYPE),
-                (32, 64, 64, 1, 2, 2, None, None, None, AT, BT, DTYPE),
-                (64, 32, 16, 1, 2, 2, None, None, None, AT, BT, DTYPE),
-                (32, 64, 16, 1, 2, 2, None, None, None, AT, BT, DTYPE),
-                (128, 32, 32, 1, 2, 2, None, None, None, AT, BT, DTYPE),
-                (32, 128, 32, 1, 2, 2, None, None, None, AT, BT, DTYPE),
+                (64, 32, 64, 1, 0, 2, 2, None, None, None, AT, BT, DTYPE),
+                (32, 64, 64, 1, 0, 2, 2, None, None, None, AT, BT, DTYPE),
+                (64, 32, 16, 1, 0, 2, 2, None, None, None, AT, BT, DTYPE),
+                (32, 64, 16, 1, 0, 2, 2, None, None, None, AT, BT, DTYPE),
+                (128, 32, 32, 1, 0, 2, 2, None, None, None, AT, BT, DTYPE),
+                (32, 128, 32, 1, 0, 2, 2, None, None, None, AT, BT, DTYPE),
                 # 4 warp
-                (128, 64, 16, 1, 4, 2, None, None, None, AT, BT, DTYPE),
-                (64, 128, 16, 1, 4, 2, None, None, None, AT, BT, DTYPE),
-                (128, 32, 32, 1, 4, 2, None, None, None, AT, BT, DTYPE),
-                (32, 128, 32, 1, 4, 2, None, None, None, AT, BT, DTYPE),
-                (128, 32, 64, 1, 4, 2, None, None, None, AT, BT, DTYPE),
-                (32, 128, 64, 1, 4, 2, None, None, None, AT, BT, DTYPE),
+                (128, 64, 16, 1, 0, 4, 2, None, None, None, AT, BT, DTYPE),
+                (64, 128, 16, 1, 0, 4, 2, None, None, None, AT, BT, DTYPE),
+                (128, 32, 32, 1, 0, 4, 2, None, None, None, AT, BT, DTYPE),
+                (32, 128, 32, 1, 0, 4, 2, None, None, None, AT, BT, DTYPE),
+                (128, 32, 64, 1, 0, 4, 2, None, None, None, AT, BT, DTYPE),
+                (32, 128, 64, 1, 0, 4, 2, None, None, None, AT, BT, DTYPE),
                 # 8 warp
-                (128, 256, 16, 1, 8, 2, None, None, None, AT, BT, DTYPE),
-                (256, 128, 16, 1, 8, 2, None, None, None, AT, BT, DTYPE),
-                (256, 128, 32, 1, 8, 2, None, None, None, AT, BT, DTYPE),
+                (128, 256, 16, 1, 0, 8, 2, None, None, None, AT, BT, DTYPE),
+                (256, 128, 16, 1, 0, 8, 2, None, None, None, AT, BT, DTYPE),
+                (256, 128, 32, 1, 0, 8, 2, None, None, None, AT, BT, DTYPE),
                 # split-k
-                (64, 64, 16, 2, 4, 2, None, None, None, AT, BT, DTYPE),
-                (64, 64, 16, 4, 4, 2, None, None, None, AT, BT, DTYPE),
-                (64, 64, 16, 8, 4, 2, None, None, None, AT, BT, DTYPE),
+                (64, 64, 16, 2, 0, 4, 2, None, None, None, AT, BT, DTYPE),
+                (64, 64, 16, 4, 0, 4, 2, None, None, None, AT, BT, DTYPE),
+                (64, 64, 16, 8, 0, 4, 2, None, None, None, AT, BT, DTYPE),
+                # skinny split-k
+                (32, 64, 64, 4, 0, 2, 2, 16, 4096, 4096, AT, BT, DTYPE),
+                (64, 64, 32, 8, 0, 4, 2, 107, 233, 4096, AT, BT, DTYPE),
+                # stream-k
+                (64, 64, 32, 1, 1, 4, 2, None, None, None, AT, BT, DTYPE),
+                (32, 64, 64, 1, 1, 2, 2, 16, 4096, 4096, AT, BT, DTYPE),
+                (64, 64, 32, 1, 1, 4, 2, 107, 233, 311, AT, BT, DTYPE),
+                (64, 64, 32, 1, 1, 4, 2, 1024, 1024, 1024, AT, BT, DTYPE),
                 # variable input
-                (128, 128, 32, 1, 4, 2, 1024, 1024, 1024, AT, BT, DTYPE),
-                (128, 128, 32, 1, 4, 2, 384, 128, 640, AT, BT, DTYPE),
-                (128, 128, 32, 1, 4, 2, 107, 233, 256, AT, BT, DTYPE),
-                (128, 128, 32, 1, 4, 2, 107, 233, 311, AT, BT, DTYPE),
+                (128, 128, 32, 1, 0, 4, 2, 1024, 1024, 1024, AT, BT, DTYPE),
+                (128, 128, 32, 1, 0, 4, 2, 384, 128, 640, AT, BT, DTYPE),
+                (128, 128, 32, 1, 0, 4, 2, 107, 233, 256, AT, BT, DTYPE),
+                (128, 128, 32, 1, 0, 4, 2, 107, 233, 311, AT, BT, DTYPE),
             ] for DTYPE in ["float16", "float32"] for AT in [False, True] for BT in [False, True]
         ],
         # n-stage
         *[
             [
-                (16, 16, 16, 1, 1, STAGES, 1024, 1024, 1024, AT, BT, DTYPE),
-                (64, 32, 64, 1, 2, STAGES, 1024, 1024, 1024, AT, BT, DTYPE),
-                (128, 64, 16, 1, 4, STAGES, 1024, 1024, 1024, AT, BT, DTYPE),
-                (256, 128, 32, 1, 8, STAGES, 1024, 1024, 1024, AT, BT, DTYPE),
-                (128, 128, 32, 1, 4, STAGES, 384, 128, 640, AT, BT, DTYPE),
+                (16, 16, 16, 1, 0, 1, STAGES, 1024, 1024, 1024, AT, BT, DTYPE),
+                (64, 32, 64, 1, 0, 2, STAGES, 1024, 1024, 1024, AT, BT, DTYPE),
+                (128, 64, 16, 1, 0, 4, STAGES, 1024, 1024, 1024, AT, BT, DTYPE),
+                (256, 128, 32, 1, 0, 8, STAGES, 1024, 1024, 1024, AT, BT, DTYPE),
+                (128, 128, 32, 1, 0, 4, STAGES, 384, 128, 640, AT, BT, DTYPE),
                 # split-k
-                (64, 64, 16, 8, 4, STAGES, 1024, 1024, 1024, AT, BT, DTYPE),
-                (64, 64, 16, 8, 4, STAGES, 1024, 1024, 32, AT, BT, DTYPE),
+                (64, 64, 16, 8, 0, 4, STAGES, 1024, 1024, 1024, AT, BT, DTYPE),
+                (64, 64, 16, 8, 0, 4, STAGES, 1024, 1024, 32, AT, BT, DTYPE),
+                # stream-k
+                (64, 64, 32, 1, 1, 4, STAGES, 64, 1024, 8192, AT, BT, DTYPE),
             ] for DTYPE in ["float16", "float32"] for AT in [False, True] for BT in [False, True] for STAGES in [2, 3, 4]
         ]
     ),
 )
-def test_op(BLOCK_M, BLOCK_N, BLOCK_K, SPLIT_K, NWARP, NSTAGE, M, N, K, AT, BT, DTYPE):
+def test_op(BLOCK_M, BLOCK_N, BLOCK_K, SPLIT_K, STREAM_K, NWARP, NSTAGE, M, N, K, AT, BT, DTYPE):
     torch.manual_seed(0)
     # nuke kernel decorators -- will set meta-parameters manually
-    META = {'BLOCK_M': BLOCK_M, 'BLOCK_N': BLOCK_N, 'BLOCK_K': BLOCK_K, 'SPLIT_K': SPLIT_K}
+    META = {'BLOCK_M': BLOCK_M, 'BLOCK_N': BLOCK_N, 'BLOCK_K': BLOCK_K, 'SPLIT_K': SPLIT_K, 'STREAM_K': STREAM_K}
     configs = [triton.Config(meta=META, num_warps=NWARP, num_stages=NSTAGE)]
     kernel = triton.ops._matmul.kernel
     decorators = kernel.kernel_decorators
@@ -87,3 +97,41 @@ def test_op(BLOCK_M, BLOCK_N, BLOCK_K, SPLIT_K, NWARP, NSTAGE, M, N, K, AT, BT,
     th_c = torch.matmul(a, b)
     tt_c = triton.testing.catch_oor(lambda : triton.ops.matmul(a, b), pytest)
     triton.testing.assert_almost_equal(th_c, tt_c)
+    # partial sums must be reduced in a deterministic order
+    if SPLIT_K > 1 or STREAM_K:
+        assert torch.equal(tt_c, triton.ops.matmul(a, b))
+
+
+@pytest.mark.parametrize(
+    "M, N, K, HAS_BIAS, ACTIVATION, HAS_RESIDUAL, DTYPE",
+    [
+        (M, N, K, HAS_BIAS, ACTIVATION, HAS_RESIDUAL, DTYPE)
+        for M, N, K in [(256, 256, 256), (107, 233, 311), (16, 4096, 4096)]
+        for HAS_BIAS in [False, True]
+        for ACTIVATION in [None, "relu", "gelu"]
+        for HAS_RESIDUAL in [False, True]
+        for DTYPE in ["float16", "float32"]
+    ],
+)
+def test_epilogue(M, N, K, HAS_BIAS, ACTIVATION, HAS_RESIDUAL, DTYPE):
+    torch.manual_seed(0)
+    a = .1*torch.randn((M, K), device="cuda", dtype=torch.float16)
+    b = .1*torch.randn((K, N), device="cuda", dtype=torch.float16)
+    bias = torch.randn((N, ), device="cuda", dtype=torch.float16) if HAS_BIAS else None
+    residual = torch.randn((M, N), device="cuda", dtype=torch.float16) if HAS_RESIDUAL else None
+    DTYPE = {"float16": torch.float16, "float32": torch.float32}[DTYPE]
+    # reference
+    th_c = torch.matmul(a.float(), b.float())
+    if HAS_BIAS:
+        th_c += bias.float()[None, :]
+    if ACTIVATION == "relu":
+        th_c = torch.relu(th_c)
+    if ACTIVATION == "gelu":
+        th_c = 0.5 * th_c * (1 + torch.tanh(0.7978845608028654 * (th_c + 0.044715 * th_c**3)))
+    if HAS_RESIDUAL:
+        th_c += residual.float()
+    th_c = th_c.to(DTYPE)
+    # triton
+    tt_c = triton.ops.matmul(a, b, bias=bias, activation=ACTIVATION, residual=residual, dtype=DTYPE)
+    assert tt_c.dtype == DTYPE
+    triton.testing.assert_almost_equal(th_c, tt_c)
@@ -0,0 +1,39 @@
+import pytest
+import triton
+import torch
+
+
+def dequantize(q, scales, bits, K):
+    # reference dequantization, in fp32
+    if bits == 4:
+        u = q.view(torch.uint8).to(torch.int32)
+        q = torch.cat([(u & 15) - 8, (u >> 4) - 8], dim=0)
+    group_size = K // scales.shape[0]
+    return q.float() * scales.float().repeat_interleave(group_size, dim=0)
+
+
+@pytest.mark.parametrize("M, N, K, BITS, GROUP_SIZE, ACTIVATION",
+    [
+    (M, N, K, BITS, GROUP_SIZE, ACTIVATION) for M, N, K in [(1, 4096, 4096), (16, 1024, 512), (333, 257, 1024), (512, 512, 128)]
+                                            for BITS in [8, 4]
+                                            for GROUP_SIZE in [None, 64, 128]
+                                            for ACTIVATION in [None, 'gelu']
+    ]
+)
+def test_op(M, N, K, BITS, GROUP_SIZE, ACTIVATION):
+    torch.manual_seed(0)
+    a = torch.randn((M, K), device='cuda', dtype=torch.float16)
+    w = torch.randn((K, N), device='cuda', dtype=torch.float16)
+    bias = torch.randn((N, ), device='cuda', dtype=torch.float16)
+    q, scales = triton.ops.quantize(w, bits=BITS, group_size=GROUP_SIZE)
+    assert q.shape == (K * BITS // 8, N)
+    # quantization error is bounded by half a step
+    w_hat = dequantize(q, scales, BITS, K)
+    step = scales.float().repeat_interleave(K // scales.shape[0], dim=0)
+    assert ((w_hat - w.float()).abs() <= 0.5 * step + 1e-3).all()
+    # matmul against dequantized weights
+    th_c = a.float() @ w_hat + bias.float()
+    if ACTIVATION == 'gelu':
+        th_c = torch.nn.functional.gelu(th_c)
+    tt_c = triton.ops.quant_matmul(a, q, scales, bits=BITS, bias=bias, activation=ACTIVATION)
+    assert triton.testing.allclose(th_c, tt_c.float())
@@ -0,0 +1,30 @@
+import torch
+import triton
+import pytest
+
+@pytest.mark.parametrize("M, N, K, dtype, largest",
+    [
+    (M, N, K, dtype, largest) for M, N, K in [(1024, 32, 4), (512, 1000, 8), (64, 4096, 64), (33, 17, 17)]
+                              for dtype in ['float16', 'float32', 'int32']
+                              for largest in [True, False]
+    ]
+                         )
+def test_op(M, N, K, dtype, largest):
+    torch.manual_seed(0)
+    dtype = {'float16': torch.float16, 'float32': torch.float32, 'int32': torch.int32}[dtype]
+    # create inputs; integers have many ties
+    if dtype == torch.int32:
+        x = torch.randint(-16, 16, (M, N), dtype=dtype, device='cuda')
+    else:
+        x = torch.randn(M, N, dtype=dtype, device='cuda')
+    # triton result
+    tt_v, tt_i = triton.ops.topk(x, K, largest=largest)
+    # torch result; ties are broken in favor of the lowest index
+    th_v, th_i = torch.sort(x, dim=-1, descending=largest, stable=True)
+    th_v, th_i = th_v[:, :K], th_i[:, :K]
+    # compare
+    assert torch.equal(tt_v, th_v)
+    assert torch.equal(tt_i, th_i)
+    # determinism
+    tt_v2, tt_i2 = triton.ops.topk(x, K, largest=largest)
+    assert torch.equal(tt_i, tt_i2)
@@ -10,6 +10,7 @@ import os
 import pickle
 import subprocess
 import os
+import warnings
 from .tools.disasm import extract
 import torch
 import triton
@@ -55,16 +56,18 @@ class CodeGenerator(ast.NodeVisitor):
                 break
         return stmts and isinstance(stmt, ast.Return)
 
-    def __init__(self, context, prototype, gscope, attributes, constants, kwargs):
+    def __init__(self, context, prototype, gscope, attributes, kwargs, arg_attributes=None):
         self.builder = _triton.ir.builder(context)
         self.module = _triton.ir.module('', self.builder)
         self.prototype = prototype
         self.gscope = gscope
         self.lscope = dict()
         self.attributes = attributes
-        self.constants = constants
+        self.arg_attributes = dict() if arg_attributes is None else arg_attributes
         self.kwargs = kwargs
         self.last_node = None
+        # device functions generated for each (JITFunction, argument types)
+        self.device_functions = dict()
         self.builtins = {
             'range': range,
             'min': triton.language.minimum,
@@ -102,18 +105,21 @@ class CodeGenerator(ast.NodeVisitor):
             fn = self.module.get_or_insert_function(node.name, self.prototype)
             arg_values = []
             for i, arg_name in enumerate(arg_names):
-                if i in self.constants:
-                    cst = triton.language.core._to_ir(self.constants[i], self.builder)
-                    arg_values.append(cst)
-                else:
-                    if i in self.attributes:
-                        is_ptr = fn.args[i].type.is_ptr()
-                        attr = 'aligned' if is_ptr else 'multiple_of'
-                        attr = getattr(_triton.ir.attribute_kind, attr)
-                        attr = _triton.ir.attribute(attr, self.attributes[i])
-                        fn.add_attr(i + 1, attr)
-                    fn.args[i].name = arg_name
-                    arg_values.append(fn.args[i])
+                if i in self.attributes:
+                    is_ptr = fn.args[i].type.is_ptr()
+                    attr = 'aligned' if is_ptr else 'multiple_of'
+                    attr = getattr(_triton.ir.attribute_kind, attr)
+                    attr = _triton.ir.attribute(attr, self.attributes[i])
+                    fn.add_attr(i + 1, attr)
+                for kind in self.arg_attributes.get(i, []):
+                    attr = getattr(_triton.ir.attribute_kind, kind)
+                    fn.add_attr(i + 1, _triton.ir.attribute(attr, 0))
+                fn.args[i].name = arg_name
+                arg_values.append(fn.args[i])
+            # trailing arguments of persistent kernels hold the size of the virtual grid
+            for axis, arg in enumerate(fn.args[len(arg_names):]):
+                arg.name = f'num_programs_{axis}'
+                fn.add_attr(len(arg_names) + axis + 1, _triton.ir.attribute(_triton.ir.attribute_kind.num_programs, axis))
         for arg_name, arg_value in zip(arg_names, arg_values):
             self.set_value(arg_name, arg_value)
         if inline:
@@ -421,12 +427,13 @@ class CodeGenerator(ast.NodeVisitor):
 
 
 class Binary:
-    def __init__(self, backend, name, asm, shared_mem, num_warps):
+    def __init__(self, backend, name, asm, shared_mem, num_warps, num_regs=None):
         self.backend = backend
         self.name = name
         self.asm = asm
         self.shared_mem = shared_mem
         self.num_warps = num_warps
+        self.num_regs = num_regs
 
 class LoadedBinary:
     def __init__(self, device: int, bin: Binary):
@@ -532,6 +539,10 @@ class Kernel:
 
     @staticmethod
     def pow2_divisor(N):
+        if N % 256 == 0: return 256
+        if N % 128 == 0: return 128
+        if N % 64 == 0: return 64
+        if N % 32 == 0: return 32
         if N % 16 == 0: return 16
         if N % 8 == 0: return 8
         if N % 4 == 0: return 4
@@ -541,17 +552,35 @@ class Kernel:
     def __init__(self, fn):
         self.fn = fn
 
-    def _compile(self, *wargs, device, attributes, constants, num_warps, num_stages, **meta):
+    @staticmethod
+    def _num_resident_programs(binary, device):
+        # programs that fit on the device at the same time
+        num_threads = binary.num_warps * 32
+        props = torch.cuda.get_device_properties(device)
+        max_threads = _triton.runtime.max_threads_per_multiprocessor(binary.backend, device)
+        per_sm = builtins.min(32, max_threads // num_threads)
+        if binary.shared_mem:
+            max_shared_memory = _triton.runtime.max_shared_memory(binary.backend, device)
+            per_sm = builtins.min(per_sm, max_shared_memory // binary.shared_mem)
+        if binary.num_regs:
+            max_regs = _triton.runtime.regs_per_multiprocessor(binary.backend, device)
+            per_sm = builtins.min(per_sm, max_regs // (binary.num_regs * num_threads))
+        return props.multi_processor_count * builtins.max(per_sm, 1)
+
+    def _make_ir(self, *wargs, attributes, arg_attributes, **meta):
         # create IR module
         context = _triton.ir.context()
         # get just-in-time proto-type of kernel
         arg_types = [Kernel._to_triton_ir(context, arg) for arg in wargs]
+        if self.fn.persistent:
+            arg_types += [_triton.ir.type.get_int32(context)] * 3
         ret_type = _triton.ir.type.get_void(context)
         prototype = _triton.ir.type.make_function(ret_type, arg_types)
         # generate Triton-IR
         # export symbols visible from self.fn into code-generator object
         gscope = sys.modules[self.fn.module].__dict__
-        generator = CodeGenerator(context, prototype, gscope=gscope, attributes=attributes, constants=constants, kwargs=meta)
+        generator = CodeGenerator(context, prototype, gscope=gscope, attributes=attributes, kwargs=meta,
+                                  arg_attributes=arg_attributes)
         try:
             generator.visit(self.fn.parse())
         except Exception as e:
@@ -559,18 +588,72 @@ class Kernel:
             if node is None or isinstance(e, (NotImplementedError, CompilationError)):
                 raise e
             raise CompilationError(self.fn.src, node, e)
-        # Compile to machine code
+        return context, generator.module
+
+    @staticmethod
+    def _backend():
         if torch.version.hip is None:
-            backend = _triton.runtime.backend.CUDA
-        else:
-            backend = _triton.runtime.backend.ROCM
-        name, asm, shared_mem = _triton.code_gen.compile_ttir(backend, generator.module, device, num_warps, num_stages)
+            return _triton.runtime.backend.CUDA
+        return _triton.runtime.backend.ROCM
+
+    def _compile(self, *wargs, device, attributes, arg_attributes, num_warps, num_stages, num_unroll, **meta):
+        context, module = self._make_ir(*wargs, attributes=attributes, arg_attributes=arg_attributes, **meta)
+        # Compile to machine code
+        backend = Kernel._backend()
+        name, asm, shared_mem, num_regs = _triton.code_gen.compile_ttir(backend, module, device, num_warps, num_stages, num_unroll)
         max_shared_memory = _triton.runtime.max_shared_memory(backend, device)
         if shared_mem > max_shared_memory:
             raise OutOfResources(shared_mem, max_shared_memory, "shared memory")
-        return Binary(backend, name, asm, shared_mem, num_warps)
+        return Binary(backend, name, asm, shared_mem, num_warps, num_regs)
+
+    def _specialization(self, wargs, tensor_idxs):
+        args = [arg.data_ptr() if i in tensor_idxs else arg for i, arg in enumerate(wargs)]
+        attributes = {i: Kernel.pow2_divisor(a) for i, a in enumerate(args) \
+                      if isinstance(a, int) and i not in self.fn.do_not_specialize}
+        # aliasing information declared in `triton.jit`
+        arg_attributes = dict()
+        for i in tensor_idxs:
+            kinds = [kind for kind in ('noalias', 'readonly') if i in getattr(self.fn, kind)]
+            if kinds:
+                arg_attributes[i] = kinds
+        # ints whose value is one (e.g., unit strides) are specialized on
+        # but kept as arguments; the compiler uses them as contiguity hints
+        for i, arg in enumerate(wargs):
+            if isinstance(arg, int) and arg == 1 and i not in self.fn.do_not_specialize:
+                arg_attributes[i] = ['equal_to_one']
+        return args, attributes, arg_attributes
+
+    def estimate(self, *wargs, num_warps=4, num_stages=2, num_unroll=1, **meta):
+        """
+        Estimates the resources used by this kernel for the given arguments
+        without generating any machine code.
+
+        :return: a tuple (registers per thread, static shared memory in bytes)
+        """
+        tensor_idxs = [i for i, arg in enumerate(wargs) if hasattr(arg, 'data_ptr')]
+        _, attributes, arg_attributes = self._specialization(wargs, tensor_idxs)
+        context, module = self._make_ir(*wargs, attributes=attributes, arg_attributes=arg_attributes, **meta)
+        device = torch.cuda.current_device()
+        return _triton.code_gen.estimate_ttir(Kernel._backend(), module, device, num_warps, num_stages, num_unroll)
+
+    def analyze(self, *wargs, compute_capability=(8, 0), num_warps=4, num_stages=2, num_unroll=1, **meta):
+        """
+        Runs the static analyses of the compiler for the given arguments and
+        target compute capability. This does not require a GPU.
+
+        :return: a dictionary with the estimated registers per thread (`num_regs`),
+                 static shared memory (`shared_mem`), simulated shared memory
+                 bank conflicts of each access (`bank_conflicts`), the vector width
+                 and predicted transactions of each global memory access (`memory_accesses`)
+                 and the optimized Triton-IR (`ttir`)
+        """
+        tensor_idxs = [i for i, arg in enumerate(wargs) if hasattr(arg, 'data_ptr')]
+        _, attributes, arg_attributes = self._specialization(wargs, tensor_idxs)
+        context, module = self._make_ir(*wargs, attributes=attributes, arg_attributes=arg_attributes, **meta)
+        cc = compute_capability[0]*10 + compute_capability[1]
+        return _triton.code_gen.analyze_ttir(module, cc, num_warps, num_stages, num_unroll)
 
-    def __call__(self, *wargs, grid, num_warps=4, num_stages=2, **meta):
+    def __call__(self, *wargs, grid, num_warps=4, num_stages=2, num_unroll=1, **meta):
         # device inference
         tensor_idxs = [i for i, arg in enumerate(wargs) if hasattr(arg, 'data_ptr')]
         if len(tensor_idxs) == 0:
@@ -602,21 +685,16 @@ class Kernel:
         # enqueue kernel on the current device
         torch.cuda.set_device(device_idx)
         # attributes
-        args = [arg.data_ptr() if i in tensor_idxs else arg for i, arg in enumerate(wargs)]
-        attributes = {i: Kernel.pow2_divisor(a) for i, a in enumerate(args) \
-                      if isinstance(a, int) and i not in self.fn.do_not_specialize}
-        # transforms ints whose value is one into constants for just-in-time compilation
-        constants = {i: arg for i, arg in enumerate(wargs) if isinstance(arg, int) and arg == 1}
+        args, attributes, arg_attributes = self._specialization(wargs, tensor_idxs)
         # compute hash for caching this kernel
         types_key = Kernel._types_key(*wargs, tensor_idxs=tensor_idxs)
-        attr_key = tuple(attributes.items())
+        attr_key = (tuple(attributes.items()), tuple((i, tuple(k)) for i, k in arg_attributes.items()))
         meta_key = tuple(sorted(meta.items()))
-        const_key = tuple(constants.items())
         compute_capability = torch.cuda.get_device_capability(device)
 
         key = (
             self.fn.cache_key, version_key(), compute_capability,
-            types_key, attr_key, num_warps, num_stages, meta_key, const_key
+            types_key, attr_key, num_warps, num_stages, num_unroll, meta_key, self.fn.persistent
         )
         key = repr(key)
 
@@ -646,9 +724,8 @@ class Kernel:
                         binary = pickle.load(f)["binary"]
             if binary is None:
                 binary = self._compile(
-                    *wargs, device=device_idx, attributes=attributes,
-                    num_warps=num_warps, num_stages=num_stages, 
-                    constants=constants, **meta
+                    *wargs, device=device_idx, attributes=attributes, arg_attributes=arg_attributes,
+                    num_warps=num_warps, num_stages=num_stages, num_unroll=num_unroll, **meta
                 )
                 if bin_cache_path:
                     assert bin_lock_path is not None
@@ -662,11 +739,18 @@ class Kernel:
             drv_cache[key] = LoadedBinary(device_idx, binary)
         # pack arguments
         fmt = ''.join(['P' if i in tensor_idxs else Kernel._type_name(arg) for i, arg in enumerate(wargs)])
+        callable = drv_cache[key]
+        grid = grid(meta) if hasattr(grid, '__call__') else grid
+        if self.fn.persistent:
+            # the virtual grid is passed to the kernel, which only
+            # launches as many programs as can be resident at once
+            grid = tuple(grid) + (1, ) * (3 - len(grid))
+            fmt += 'III'
+            args = list(args) + list(grid)
+            grid = (builtins.min(grid[0] * grid[1] * grid[2], Kernel._num_resident_programs(callable.bin, device_idx)), )
         params = struct.pack(fmt, *args)
         # enqueue cached function into stream
-        callable = drv_cache[key]
         stream = torch.cuda.current_stream(device_idx).cuda_stream
-        grid = grid(meta) if hasattr(grid, '__call__') else grid
         callable(stream, params, *grid)
         return callable
 
@@ -681,12 +765,14 @@ class Launcher:
 
 
 class Autotuner:
-    def __init__(self, kernel, arg_names, configs, key, reset_to_zero):
+    def __init__(self, kernel, arg_names, configs, key, reset_to_zero, prune_configs_by=None):
         if not configs:
             self.configs = [Config(dict(), num_warps=4, num_stages=2)]
         else:
             self.configs = configs
         self.key_idx = [arg_names.index(k) for k in key]
+        self.arg_names = arg_names
+        self.early_config_prune = prune_configs_by
         self.cache = dict()
         self.kernel = kernel
         # hook to reset all required tensor to zeros before relaunching a kernel
@@ -711,21 +797,69 @@ class Autotuner:
         current = dict(meta, **config.meta)
         def kernel_call():
             self.hook(args)
-            self.kernel(*args, num_warps=config.num_warps, num_stages=config.num_stages, **current)
+            self.kernel(*args, num_warps=config.num_warps, num_stages=config.num_stages,
+                        num_unroll=config.num_unroll, **current)
         return triton.testing.do_bench(kernel_call)
 
+    @staticmethod
+    def _hashable(value):
+        try:
+            hash(value)
+            return value
+        except TypeError:
+            return repr(value)
+
+    def _prune(self, *args, **meta):
+        configs = self.configs
+        # drop configs that the user knows not to apply to these arguments
+        if self.early_config_prune is not None:
+            configs = self.early_config_prune(configs, dict(zip(self.arg_names, args))) or configs
+        # drop configs that are statically known to spill registers
+        # or to exceed the amount of available shared memory
+        if not isinstance(self.kernel, Kernel):
+            return configs
+        backend = Kernel._backend()
+        device = torch.cuda.current_device()
+        max_shared_memory = _triton.runtime.max_shared_memory(backend, device)
+        regs_per_sm = _triton.runtime.regs_per_multiprocessor(backend, device)
+        pruned = []
+        for config in configs:
+            current = dict(meta, **config.meta)
+            try:
+                num_regs, shared_mem = self.kernel.estimate(*args, num_warps=config.num_warps,
+                                                            num_stages=config.num_stages,
+                                                            num_unroll=config.num_unroll, **current)
+            except (CompilationError, RuntimeError) as e:
+                # keep the config: benchmarking it reports the error
+                warnings.warn(f"could not estimate the resources of config {config.meta} "
+                              f"(num_warps={config.num_warps}, num_stages={config.num_stages}): {e}")
+                pruned.append(config)
+                continue
+            max_regs = builtins.min(255, regs_per_sm // (32 * config.num_warps))
+            if num_regs <= max_regs and shared_mem <= max_shared_memory:
+                pruned.append(config)
+        return pruned if pruned else configs
+
     def __call__(self, *args, **meta):
         if len(self.configs) > 1:
-            key = tuple([args[i] for i in self.key_idx])
+            # meta-parameters given at the call site select different
+            # binaries, which are tuned independently. The launch grid and
+            # other callables do not select a binary and are often fresh
+            # closures, so they are left out of the key
+            key = tuple([args[i] for i in self.key_idx]) + \
+                  tuple((name, Autotuner._hashable(value)) for name, value in sorted(meta.items())
+                        if name != 'grid' and not callable(value))
             if key not in self.cache:
+                configs = self._prune(*args, **meta)
                 timings = {config: self._bench(*args, config=config, **meta) \
-                        for config in self.configs}
+                        for config in configs}
                 self.cache[key] = builtins.min(timings, key=timings.get)
                 self.hook(args)
             config = self.cache[key]
         else:
             config = self.configs[0]
-        return self.kernel(*args, num_warps=config.num_warps, num_stages=config.num_stages, **meta, **config.meta)
+        return self.kernel(*args, num_warps=config.num_warps, num_stages=config.num_stages,
+                           num_unroll=config.num_unroll, **meta, **config.meta)
 
 
 @functools.lru_cache()
@@ -756,7 +890,7 @@ class JITFunction:
     def _set_cache_key(self):
         self.cache_key = (hashlib.md5(self.src.encode("utf-8")).hexdigest(), self.version)
 
-    def __init__(self, fn, version=None, do_not_specialize=None):
+    def __init__(self, fn, version=None, do_not_specialize=None, noalias=None, readonly=None, persistent=False):
         # information of wrapped function
         self.fn = fn
         self.module = fn.__module__
@@ -765,6 +899,11 @@ class JITFunction:
         self.src = textwrap.dedent(inspect.getsource(fn))
         self.do_not_specialize = [] if do_not_specialize is None else\
                                  [self.arg_names.index(arg) for arg in do_not_specialize]
+        # pointer arguments that do not overlap with any other / that are never written
+        self.noalias = [] if noalias is None else [self.arg_names.index(arg) for arg in noalias]
+        self.readonly = [] if readonly is None else [self.arg_names.index(arg) for arg in readonly]
+        # programs loop over the tiles of the grid
+        self.persistent = persistent
         # cache for callable driver objects (e.g. CUkernel)
         self.drv_cache = dict()
         # cache for binaries (on-disk)
@@ -787,17 +926,93 @@ class JITFunction:
         assert isinstance(tree.body[0], ast.FunctionDef)
         return tree
 
+    def _inline(self, args, generator):
+        gscope = generator.gscope.copy()
+        lscope = generator.lscope.copy()
+        values = generator.module.get_values().copy()
+        generator.gscope = sys.modules[self.fn.__module__].__dict__
+        ret = generator.visit_FunctionDef(self.parse().body[0], inline=True, arg_values=args)
+        generator.gscope = gscope
+        generator.lscope = lscope
+        generator.module.set_values(values)
+        return ret
+
+    # generates the body of `self` once per specialization as a device function.
+    # Python arguments are baked into the body, and the results must be
+    # a block or a tuple of blocks; returns None otherwise
+    def _make_device_function(self, args, generator):
+        node = self.parse().body[0]
+        arg_names, kwarg_names = generator.visit(node.args)
+        builder = generator.builder
+        arg_types = [arg.handle.type for arg in args if isinstance(arg, triton.language.block)]
+        void_ty = _triton.ir.type.get_void(builder.context)
+        name = f'{self.fn.__name__}_{len(generator.device_functions)}'
+        fn = generator.module.get_or_insert_function(name, _triton.ir.type.make_function(void_ty, arg_types))
+        fn.set_internal()
+        # save state of the caller
+        insert_block = builder.get_insert_block()
+        gscope, lscope = generator.gscope, generator.lscope
+        values = generator.module.get_values().copy()
+        generator.gscope = sys.modules[self.fn.__module__].__dict__
+        generator.lscope = dict()
+        generator.lscope[kwarg_names] = generator.kwargs
+        entry = _triton.ir.basic_block.create(builder.context, "entry", fn)
+        generator.module.seal_block(entry)
+        builder.set_insert_block(entry)
+        fn_args = iter(fn.args)
+        for arg_name, arg in zip(arg_names, args):
+            if isinstance(arg, triton.language.block):
+                arg = next(fn_args)
+                arg.name = arg_name
+            generator.set_value(arg_name, arg)
+        has_ret = generator.visit_compound_statement(node.body)
+        ret = generator.last_ret if has_ret else None
+        rets = ret if isinstance(ret, tuple) else (ret, )
+        if all(isinstance(x, triton.language.block) for x in rets):
+            if isinstance(ret, tuple):
+                ret_ty = _triton.ir.type.make_struct([x.handle.type for x in rets])
+                agg = _triton.ir.undef.get(ret_ty)
+                for i, x in enumerate(rets):
+                    agg = builder.insert_value(agg, x.handle, i)
+                builder.ret(agg)
+            else:
+                ret_ty = ret.handle.type
+                builder.ret(ret.handle)
+            fn.reset_type(_triton.ir.type.make_function(ret_ty, arg_types))
+            result = (fn, len(rets) if isinstance(ret, tuple) else None)
+        else:
+            if not isinstance(ret, _triton.ir.instruction):
+                builder.ret_void()
+            # other results are inlined, and the orphan function is removed by the inliner
+            result = (fn, 0) if ret is None or isinstance(ret, _triton.ir.instruction) else None
+        # restore state of the caller
+        builder.set_insert_block(insert_block)
+        generator.gscope, generator.lscope = gscope, lscope
+        generator.module.set_values(values)
+        return result
+
     def __call__(self, *args, generator: CodeGenerator, **meta):
         try:
-            gscope = generator.gscope.copy()
-            lscope = generator.lscope.copy()
-            values = generator.module.get_values().copy()
-            generator.gscope = sys.modules[self.fn.__module__].__dict__
-            ret = generator.visit_FunctionDef(self.parse().body[0], inline=True, arg_values=args)
-            generator.gscope = gscope
-            generator.lscope = lscope
-            generator.module.set_values(values)
-            return ret
+            if not any(isinstance(arg, triton.language.block) for arg in args):
+                return self._inline(args, generator)
+            key = (self, ) + tuple(repr(arg.handle.type) if isinstance(arg, triton.language.block)
+                                   else (type(arg), arg) for arg in args)
+            try:
+                hash(key)
+            except TypeError:
+                return self._inline(args, generator)
+            if key not in generator.device_functions:
+                generator.device_functions[key] = self._make_device_function(args, generator)
+            device_function = generator.device_functions[key]
+            if device_function is None:
+                return self._inline(args, generator)
+            fn, num_rets = device_function
+            call = generator.builder.call(fn, [arg.handle for arg in args if isinstance(arg, triton.language.block)])
+            if num_rets == 0:
+                return None
+            if num_rets is None:
+                return triton.language.block(call)
+            return tuple(triton.language.block(generator.builder.extract_value(call, i)) for i in range(num_rets))
         except Exception as e:
             node = generator.last_node
             if node is None or isinstance(e, (NotImplementedError, CompilationError)):
@@ -842,14 +1057,17 @@ class Config:
     :ivar num_stages: the number of stages that the compiler should use when software-pipelining loops.
                        Mostly useful for matrix multiplication workloads on SM80+ GPUs.
     :type num_stages: int
+    :ivar num_unroll: the factor by which the compiler unrolls loops whose bounds are known at compile-time.
+    :type num_unroll: int
     """
-    def __init__(self, meta, num_warps=4, num_stages=2):
+    def __init__(self, meta, num_warps=4, num_stages=2, num_unroll=1):
         self.meta = meta
         self.num_warps = num_warps
         self.num_stages = num_stages
+        self.num_unroll = num_unroll
 
 
-def autotune(configs, key, reset_to_zero=None):
+def autotune(configs, key, reset_to_zero=None, prune_configs_by=None):
     """
     Decorator for auto-tuning a :code:`triton.jit`'d function.
 
@@ -875,13 +1093,17 @@ def autotune(configs, key, reset_to_zero=None):
     :param configs: a list of :code:`triton.Config` objects
     :type configs: list[triton.Config]
     :param key: a list of argument names whose change in value will trigger the evaluation of all provided configs.
+                Meta-parameters passed as keyword arguments at the call site are always part of the key.
     :type key: list[str]
     :param reset_to_zero: a list of argument names whose value will be reset to zero before evaluating any configs.
     :type reset_to_zero: list[str]
+    :param prune_configs_by: a function that takes the list of configs and a dictionary mapping argument names
+                             to their values, and returns the configs worth evaluating for these arguments.
+    :type prune_configs_by: Callable[[list[triton.Config], dict[str, Any]], list[triton.Config]]
     """
     def decorator(fn):
         def wrapper(kernel):
-            return Autotuner(kernel, fn.arg_names, configs, key, reset_to_zero)
+            return Autotuner(kernel, fn.arg_names, configs, key, reset_to_zero, prune_configs_by)
 
         fn.kernel_decorators.append(wrapper)
         return fn
@@ -938,6 +1160,14 @@ def jit(*args, **kwargs):
 
     :param fn: the function to be jit-compiled
     :type fn: Callable
+    :param noalias: names of pointer arguments whose memory is not accessed through any other argument
+    :type noalias: list[str]
+    :param readonly: names of pointer arguments whose memory is not written while the kernel runs
+    :type readonly: list[str]
+    :param persistent: launch only as many programs as can be resident on the device at once,
+                       each of which loops over the tiles of the grid. :code:`program_id` and
+                       :code:`num_programs` still refer to the grid given at launch
+    :type persistent: bool
     """
     if args:
         assert len(args) == 1
@@ -617,6 +617,105 @@ def sum(input, axis, _builder=None):
     return frontend.sum(input, axis, _builder)
 
 
+@builtin
+@_add_reduction_docstr("index of the maximum")
+def argmax(input, axis, _builder=None):
+    return frontend.argmax(input, axis, _builder)
+
+
+@builtin
+@_add_reduction_docstr("index of the minimum")
+def argmin(input, axis, _builder=None):
+    return frontend.argmin(input, axis, _builder)
+
+
+@builtin
+def max_with_index(input, axis, _builder=None):
+    """
+    Returns the maximum of all elements in the :code:`input` block along the provided :code:`axis`,
+    and its index along :code:`axis`. Ties are broken in favor of the lowest index.
+
+    :param input: the input values
+    :param axis: the dimension along which the reduction should be done
+    """
+    return tuple(frontend.max_with_index(input, axis, _builder))
+
+
+@builtin
+def min_with_index(input, axis, _builder=None):
+    """
+    Returns the minimum of all elements in the :code:`input` block along the provided :code:`axis`,
+    and its index along :code:`axis`. Ties are broken in favor of the lowest index.
+
+    :param input: the input values
+    :param axis: the dimension along which the reduction should be done
+    """
+    return tuple(frontend.min_with_index(input, axis, _builder))
+
+
+# -----------------------
+# Scans
+# -----------------------
+
+def _add_scan_docstr(name):
+
+    def _decorator(func):
+        docstr = """
+    Returns the cumulative {name} of the elements in the :code:`input` block along the provided :code:`axis`,
+    whose size must be a power of two. Integers are accumulated in 32 bits or more, as for reductions.
+
+    :param input: the input values
+    :param axis: the dimension along which the scan should be done
+    """
+        func.__doc__ = docstr.format(name=name)
+        return func
+
+    return _decorator
+
+
+@builtin
+@_add_scan_docstr("sum")
+def cumsum(input, axis, _builder=None):
+    return frontend.cumsum(input, axis, _builder)
+
+
+@builtin
+@_add_scan_docstr("product")
+def cumprod(input, axis, _builder=None):
+    return frontend.cumprod(input, axis, _builder)
+
+
+# -----------------------
+# Sorting
+# -----------------------
+
+@builtin
+def sort(input, descending=False, _builder=None):
+    """
+    Sorts the :code:`input` block along its last dimension, whose size must be a power of two.
+    Returns the sorted values and, for each of them, its index along the last dimension of :code:`input`.
+    Equal values are ordered by increasing index, so that the result is deterministic.
+
+    :param input: the input values
+    :param descending: sort in decreasing rather than increasing order
+    """
+    return tuple(frontend.sort(input, descending, _builder))
+
+
+@builtin
+def topk(input, k, largest=True, _builder=None):
+    """
+    Returns the :code:`k` largest (or smallest) values of the :code:`input` block along its last dimension,
+    in sorted order, as well as their indices along that dimension. The last dimension of the result has
+    size :code:`k`, which must be a power of two. Ties are broken as in :code:`sort`.
+
+    :param input: the input values
+    :param k: the number of values to keep
+    :param largest: keep the smallest values instead if :code:`False`
+    """
+    return tuple(frontend.topk(input, k, largest, _builder))
+
+
 # -----------------------
 # Internal for debugging
 # -----------------------
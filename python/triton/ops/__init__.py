@@ -1,4 +1,11 @@
-#from .conv import _conv, conv
+from .conv import _conv, conv2d
 from .matmul import _matmul, matmul
+from .grouped_matmul import grouped_matmul, batched_matmul
+from .quant_matmul import _quant_matmul, quant_matmul, quantize
 from .cross_entropy import _cross_entropy, cross_entropy
+from .attention import _attention, attention
+from .layer_norm import _layer_norm, layer_norm, rms_norm
+from .dropout import _dropout_op, dropout
+from .topk import topk
+from .cumsum import cumsum
 from . import blocksparse
\ No newline at end of file
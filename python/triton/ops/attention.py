@@ -0,0 +1,295 @@
+import torch
+import triton
+import triton.language as tl
+
+# ********************************************************
+# --------------------------------------------------------
+# Fused attention: softmax(Q K^T * sm_scale) V
+# --------------------------------------------------------
+# The N_CTX x N_CTX matrix of scores is never written to
+# memory: K and V are streamed block by block while the
+# softmax is computed online, by keeping track of the running
+# maximum and sum of each row. The backward pass re-computes
+# the scores from the log-sum-exp saved by the forward pass.
+# ********************************************************
+
+_configs = [
+    triton.Config({'BLOCK_M': 128, 'BLOCK_N': 64}, num_warps=4, num_stages=2),
+    triton.Config({'BLOCK_M': 128, 'BLOCK_N': 32}, num_warps=4, num_stages=2),
+    triton.Config({'BLOCK_M': 64, 'BLOCK_N': 64}, num_warps=4, num_stages=2),
+    triton.Config({'BLOCK_M': 64, 'BLOCK_N': 32}, num_warps=2, num_stages=2),
+    triton.Config({'BLOCK_M': 128, 'BLOCK_N': 128}, num_warps=8, num_stages=2),
+]
+
+
+@triton.autotune(configs=_configs, key=['N_CTX'])
+@triton.jit
+def _fwd_kernel(Q, K, V, Out, L, sm_scale,
+                stride_qz, stride_qh, stride_qm, stride_qk,
+                stride_kz, stride_kh, stride_kn, stride_kk,
+                stride_vz, stride_vh, stride_vn, stride_vk,
+                stride_oz, stride_oh, stride_om, stride_ok,
+                H, N_CTX, **META):
+    BLOCK_M = META['BLOCK_M']
+    BLOCK_N = META['BLOCK_N']
+    BLOCK_DMODEL = META['BLOCK_DMODEL']
+    start_m = tl.program_id(0)
+    off_hz = tl.program_id(1)
+    off_z = off_hz // H
+    off_h = off_hz % H
+    offs_m = start_m * BLOCK_M + tl.arange(0, BLOCK_M)
+    offs_n = tl.arange(0, BLOCK_N)
+    offs_d = tl.arange(0, BLOCK_DMODEL)
+    # pointers; K is read transposed
+    Q = Q + off_z * stride_qz + off_h * stride_qh + (offs_m[:, None] * stride_qm + offs_d[None, :] * stride_qk)
+    K = K + off_z * stride_kz + off_h * stride_kh + (offs_n[None, :] * stride_kn + offs_d[:, None] * stride_kk)
+    V = V + off_z * stride_vz + off_h * stride_vh + (offs_n[:, None] * stride_vn + offs_d[None, :] * stride_vk)
+    # running maximum, sum and output of each row
+    m_i = tl.zeros((BLOCK_M, ), dtype=tl.float32) - float('inf')
+    l_i = tl.zeros((BLOCK_M, ), dtype=tl.float32)
+    acc = tl.zeros((BLOCK_M, BLOCK_DMODEL), dtype=tl.float32)
+    q = tl.load(Q, mask=offs_m[:, None] < N_CTX, other=0.)
+    if META['UPCAST']:
+        q = q.to(tl.float32)
+    # blocks above the diagonal do not contribute
+    end_n = N_CTX
+    if META['IS_CAUSAL']:
+        end_n = min((start_m + 1) * BLOCK_M, N_CTX)
+    for start_n in range(0, end_n, BLOCK_N):
+        cols = start_n + offs_n
+        k = tl.load(K + start_n * stride_kn, mask=cols[None, :] < N_CTX, other=0.)
+        if META['UPCAST']:
+            k = k.to(tl.float32)
+        qk = tl.dot(q, k) * sm_scale
+        qk = tl.where(cols[None, :] < N_CTX, qk, float('-inf'))
+        if META['IS_CAUSAL']:
+            qk = tl.where(offs_m[:, None] >= cols[None, :], qk, float('-inf'))
+        # rescale what was accumulated so far to the new maximum
+        m_new = tl.maximum(m_i, tl.max(qk, 1))
+        alpha = tl.exp(m_i - m_new)
+        p = tl.exp(qk - m_new[:, None])
+        l_i = l_i * alpha + tl.sum(p, 1)
+        acc = acc * alpha[:, None]
+        v = tl.load(V + start_n * stride_vn, mask=cols[:, None] < N_CTX, other=0.)
+        if META['UPCAST']:
+            acc += tl.dot(p, v.to(tl.float32))
+        else:
+            acc += tl.dot(p.to(tl.float16), v)
+        m_i = m_new
+    acc = acc / l_i[:, None]
+    # log-sum-exp of each row, for the backward pass
+    tl.store(L + off_hz * N_CTX + offs_m, m_i + tl.log(l_i), mask=offs_m < N_CTX)
+    Out = Out + off_z * stride_oz + off_h * stride_oh + (offs_m[:, None] * stride_om + offs_d[None, :] * stride_ok)
+    tl.store(Out, acc, mask=offs_m[:, None] < N_CTX)
+
+
+@triton.jit
+def _bwd_preprocess(Out, DO, Delta, NUM_ROWS, **META):
+    # delta_i = sum_j dO_ij O_ij, for contiguous Out and DO
+    BLOCK_M = META['BLOCK_M']
+    BLOCK_DMODEL = META['BLOCK_DMODEL']
+    rows = tl.program_id(0) * BLOCK_M + tl.arange(0, BLOCK_M)
+    offs = rows[:, None] * BLOCK_DMODEL + tl.arange(0, BLOCK_DMODEL)[None, :]
+    o = tl.load(Out + offs, mask=rows[:, None] < NUM_ROWS, other=0.).to(tl.float32)
+    do = tl.load(DO + offs, mask=rows[:, None] < NUM_ROWS, other=0.).to(tl.float32)
+    tl.store(Delta + rows, tl.sum(o * do, 1), mask=rows < NUM_ROWS)
+
+
+@triton.autotune(configs=_configs, key=['N_CTX'])
+@triton.jit
+def _bwd_kv_kernel(Q, K, V, DO, DK, DV, L, Delta, sm_scale,
+                   stride_qz, stride_qh, stride_qm, stride_qk,
+                   stride_kz, stride_kh, stride_kn, stride_kk,
+                   stride_vz, stride_vh, stride_vn, stride_vk,
+                   H, N_CTX, **META):
+    # dK and dV of one block of keys; scores are computed transposed,
+    # so that rows of the block are keys and columns are queries
+    BLOCK_M = META['BLOCK_M']
+    BLOCK_N = META['BLOCK_N']
+    BLOCK_DMODEL = META['BLOCK_DMODEL']
+    start_n = tl.program_id(0)
+    off_hz = tl.program_id(1)
+    off_z = off_hz // H
+    off_h = off_hz % H
+    offs_n = start_n * BLOCK_N + tl.arange(0, BLOCK_N)
+    offs_m = tl.arange(0, BLOCK_M)
+    offs_d = tl.arange(0, BLOCK_DMODEL)
+    # DO and the gradients have the strides of Q, K and V respectively
+    off_q = off_z * stride_qz + off_h * stride_qh
+    off_k = off_z * stride_kz + off_h * stride_kh
+    off_v = off_z * stride_vz + off_h * stride_vh
+    QT = Q + off_q + (offs_m[None, :] * stride_qm + offs_d[:, None] * stride_qk)
+    Q = Q + off_q + (offs_m[:, None] * stride_qm + offs_d[None, :] * stride_qk)
+    DOT = DO + off_q + (offs_m[None, :] * stride_qm + offs_d[:, None] * stride_qk)
+    DO = DO + off_q + (offs_m[:, None] * stride_qm + offs_d[None, :] * stride_qk)
+    L = L + off_hz * N_CTX
+    Delta = Delta + off_hz * N_CTX
+    k = tl.load(K + off_k + (offs_n[:, None] * stride_kn + offs_d[None, :] * stride_kk),
+                mask=offs_n[:, None] < N_CTX, other=0.)
+    v = tl.load(V + off_v + (offs_n[:, None] * stride_vn + offs_d[None, :] * stride_vk),
+                mask=offs_n[:, None] < N_CTX, other=0.)
+    if META['UPCAST']:
+        k = k.to(tl.float32)
+        v = v.to(tl.float32)
+    dk = tl.zeros((BLOCK_N, BLOCK_DMODEL), dtype=tl.float32)
+    dv = tl.zeros((BLOCK_N, BLOCK_DMODEL), dtype=tl.float32)
+    # queries before the diagonal do not attend to this block
+    start_m = 0
+    if META['IS_CAUSAL']:
+        start_m = (start_n * BLOCK_N) // BLOCK_M * BLOCK_M
+    for m in range(start_m, N_CTX, BLOCK_M):
+        rows = m + offs_m
+        qt = tl.load(QT + m * stride_qm, mask=rows[None, :] < N_CTX, other=0.)
+        dot = tl.load(DOT + m * stride_qm, mask=rows[None, :] < N_CTX, other=0.)
+        q = tl.load(Q + m * stride_qm, mask=rows[:, None] < N_CTX, other=0.)
+        do = tl.load(DO + m * stride_qm, mask=rows[:, None] < N_CTX, other=0.)
+        if META['UPCAST']:
+            qt = qt.to(tl.float32)
+            dot = dot.to(tl.float32)
+            q = q.to(tl.float32)
+            do = do.to(tl.float32)
+        # padding queries have an infinite log-sum-exp, i.e. zero probability
+        lse = tl.load(L + rows, mask=rows < N_CTX, other=float('inf'))
+        delta = tl.load(Delta + rows, mask=rows < N_CTX, other=0.)
+        pt = tl.exp(tl.dot(k, qt) * sm_scale - lse[None, :])
+        if META['IS_CAUSAL']:
+            pt = tl.where(rows[None, :] >= offs_n[:, None], pt, 0.)
+        dpt = tl.dot(v, dot)
+        dst = pt * (dpt - delta[None, :]) * sm_scale
+        if META['UPCAST']:
+            dv += tl.dot(pt, do)
+            dk += tl.dot(dst, q)
+        else:
+            dv += tl.dot(pt.to(tl.float16), do)
+            dk += tl.dot(dst.to(tl.float16), q)
+    DK = DK + off_k + (offs_n[:, None] * stride_kn + offs_d[None, :] * stride_kk)
+    DV = DV + off_v + (offs_n[:, None] * stride_vn + offs_d[None, :] * stride_vk)
+    tl.store(DK, dk, mask=offs_n[:, None] < N_CTX)
+    tl.store(DV, dv, mask=offs_n[:, None] < N_CTX)
+
+
+@triton.autotune(configs=_configs, key=['N_CTX'])
+@triton.jit
+def _bwd_q_kernel(Q, K, V, DO, DQ, L, Delta, sm_scale,
+                  stride_qz, stride_qh, stride_qm, stride_qk,
+                  stride_kz, stride_kh, stride_kn, stride_kk,
+                  stride_vz, stride_vh, stride_vn, stride_vk,
+                  H, N_CTX, **META):
+    # dQ of one block of queries; kept separate from dK and dV
+    # so that no gradient has to be accumulated atomically
+    BLOCK_M = META['BLOCK_M']
+    BLOCK_N = META['BLOCK_N']
+    BLOCK_DMODEL = META['BLOCK_DMODEL']
+    start_m = tl.program_id(0)
+    off_hz = tl.program_id(1)
+    off_z = off_hz // H
+    off_h = off_hz % H
+    offs_m = start_m * BLOCK_M + tl.arange(0, BLOCK_M)
+    offs_n = tl.arange(0, BLOCK_N)
+    offs_d = tl.arange(0, BLOCK_DMODEL)
+    off_q = off_z * stride_qz + off_h * stride_qh
+    off_k = off_z * stride_kz + off_h * stride_kh
+    off_v = off_z * stride_vz + off_h * stride_vh
+    q = tl.load(Q + off_q + (offs_m[:, None] * stride_qm + offs_d[None, :] * stride_qk),
+                mask=offs_m[:, None] < N_CTX, other=0.)
+    do = tl.load(DO + off_q + (offs_m[:, None] * stride_qm + offs_d[None, :] * stride_qk),
+                 mask=offs_m[:, None] < N_CTX, other=0.)
+    if META['UPCAST']:
+        q = q.to(tl.float32)
+        do = do.to(tl.float32)
+    lse = tl.load(L + off_hz * N_CTX + offs_m, mask=offs_m < N_CTX, other=float('inf'))
+    delta = tl.load(Delta + off_hz * N_CTX + offs_m, mask=offs_m < N_CTX, other=0.)
+    KT = K + off_k + (offs_n[None, :] * stride_kn + offs_d[:, None] * stride_kk)
+    K = K + off_k + (offs_n[:, None] * stride_kn + offs_d[None, :] * stride_kk)
+    VT = V + off_v + (offs_n[None, :] * stride_vn + offs_d[:, None] * stride_vk)
+    dq = tl.zeros((BLOCK_M, BLOCK_DMODEL), dtype=tl.float32)
+    end_n = N_CTX
+    if META['IS_CAUSAL']:
+        end_n = min((start_m + 1) * BLOCK_M, N_CTX)
+    for start_n in range(0, end_n, BLOCK_N):
+        cols = start_n + offs_n
+        kt = tl.load(KT + start_n * stride_kn, mask=cols[None, :] < N_CTX, other=0.)
+        vt = tl.load(VT + start_n * stride_vn, mask=cols[None, :] < N_CTX, other=0.)
+        k = tl.load(K + start_n * stride_kn, mask=cols[:, None] < N_CTX, other=0.)
+        if META['UPCAST']:
+            kt = kt.to(tl.float32)
+            vt = vt.to(tl.float32)
+            k = k.to(tl.float32)
+        p = tl.exp(tl.dot(q, kt) * sm_scale - lse[:, None])
+        p = tl.where(cols[None, :] < N_CTX, p, 0.)
+        if META['IS_CAUSAL']:
+            p = tl.where(offs_m[:, None] >= cols[None, :], p, 0.)
+        dp = tl.dot(do, vt)
+        ds = p * (dp - delta[:, None]) * sm_scale
+        if META['UPCAST']:
+            dq += tl.dot(ds, k)
+        else:
+            dq += tl.dot(ds.to(tl.float16), k)
+    DQ = DQ + off_q + (offs_m[:, None] * stride_qm + offs_d[None, :] * stride_qk)
+    tl.store(DQ, dq, mask=offs_m[:, None] < N_CTX)
+
+
+class _attention(torch.autograd.Function):
+    @staticmethod
+    def forward(ctx, q, k, v, causal, sm_scale):
+        # checks constraints
+        assert q.dtype in [torch.float16, torch.bfloat16], "only fp16 and bf16 inputs are supported"
+        assert q.dtype == k.dtype == v.dtype, "q, k and v must have the same data-type"
+        assert q.dim() == 4 and q.shape == k.shape == v.shape, "q, k and v must be of shape (Z, H, N_CTX, D)"
+        Z, H, N_CTX, D = q.shape
+        assert D in [16, 32, 64, 128], "head dimension must be a power of two between 16 and 128"
+        if sm_scale is None:
+            sm_scale = D ** -0.5
+        o = torch.empty_like(q)
+        lse = torch.empty((Z * H, N_CTX), device=q.device, dtype=torch.float32)
+        grid = lambda META: (triton.cdiv(N_CTX, META['BLOCK_M']), Z * H)
+        # tensor cores are only used for fp16; bf16 is accumulated in fp32
+        upcast = q.dtype == torch.bfloat16
+        _fwd_kernel[grid](q, k, v, o, lse, float(sm_scale),
+                          q.stride(0), q.stride(1), q.stride(2), q.stride(3),
+                          k.stride(0), k.stride(1), k.stride(2), k.stride(3),
+                          v.stride(0), v.stride(1), v.stride(2), v.stride(3),
+                          o.stride(0), o.stride(1), o.stride(2), o.stride(3),
+                          H, N_CTX,
+                          BLOCK_DMODEL=D, IS_CAUSAL=causal, UPCAST=upcast)
+        ctx.save_for_backward(q, k, v, o, lse)
+        ctx.causal = causal
+        ctx.sm_scale = sm_scale
+        return o
+
+    @staticmethod
+    def backward(ctx, do):
+        q, k, v, o, lse = ctx.saved_tensors
+        Z, H, N_CTX, D = q.shape
+        upcast = q.dtype == torch.bfloat16
+        # dO is read with the strides of q
+        do = do.contiguous()
+        if q.stride() != do.stride():
+            q = q.contiguous()
+        dq = torch.empty_like(q)
+        dk = torch.empty_like(k)
+        dv = torch.empty_like(v)
+        delta = torch.empty_like(lse)
+        _bwd_preprocess[(triton.cdiv(Z * H * N_CTX, 128), )](o.contiguous(), do, delta, Z * H * N_CTX,
+                                                             BLOCK_M=128, BLOCK_DMODEL=D)
+        args = (q.stride(0), q.stride(1), q.stride(2), q.stride(3),
+                k.stride(0), k.stride(1), k.stride(2), k.stride(3),
+                v.stride(0), v.stride(1), v.stride(2), v.stride(3),
+                H, N_CTX)
+        meta = dict(BLOCK_DMODEL=D, IS_CAUSAL=ctx.causal, UPCAST=upcast)
+        grid = lambda META: (triton.cdiv(N_CTX, META['BLOCK_N']), Z * H)
+        _bwd_kv_kernel[grid](q, k, v, do, dk, dv, lse, delta, float(ctx.sm_scale), *args, **meta)
+        grid = lambda META: (triton.cdiv(N_CTX, META['BLOCK_M']), Z * H)
+        _bwd_q_kernel[grid](q, k, v, do, dq, lse, delta, float(ctx.sm_scale), *args, **meta)
+        return dq, dk, dv, None, None
+
+
+def attention(q, k, v, causal=False, sm_scale=None):
+    """
+    Computes :code:`softmax(q @ k.transpose(-1, -2) * sm_scale) @ v` without materializing the scores.
+
+    :param q, k, v: fp16 or bf16 tensors of shape (Z, H, N_CTX, D), with D a power of two in [16, 128].
+    :param causal: if True, queries only attend to keys at the same or earlier positions.
+    :param sm_scale: scale of the scores; defaults to :code:`1 / sqrt(D)`.
+    """
+    return _attention.apply(q, k, v, causal, sm_scale)
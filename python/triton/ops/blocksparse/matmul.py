@@ -1,8 +1,19 @@
 import triton
 import triton.language as tl
 import triton._C.libtriton as libtriton
+import numpy as np
 import torch
 
+
+def packbits(layout):
+    """
+    Returns the bits of a (H, M, N) layout of 0s and 1s, packed as bytes.
+    Look-up tables are built, and cached, from this representation.
+    """
+    layout = layout.cpu().to(torch.bool).contiguous().numpy()
+    return np.packbits(layout.reshape(-1))
+
+
 # ********************************************************
 # --------------------------------------------------------
 # Sparse = Dense x Dense (SDD)
@@ -132,8 +143,8 @@ def sdd_matmul(a, b, trans_a, trans_b, trans_c, spdims, block, luts, num_locks,
 
 def sdd_lut(layout, block, device):
     start_width = 128 // block
-    layout = layout.type(torch.int32)
-    superblocks = libtriton.superblock(layout.data_ptr(), layout.shape[0], layout.shape[1], layout.shape[2], start_width)
+    H, M, N = layout.shape
+    superblocks = libtriton.blocksparse.sdd_lut(packbits(layout), H, M, N, start_width)
     luts, widths, packs = [], [], []
     for size, nnz in superblocks:
         nnz = nnz.reshape(-1, 4)
@@ -248,81 +259,12 @@ def dsd_matmul(a, b, trans_a, trans_b, trans_c, spdims, block, lut, num_locks, w
     # exit()
     return c
 
-def dsd_lut(layout, block, step, trans, device):  
-    sizes = torch.sum(layout, 2 if trans else 1)
-    head_id, col_id = sizes.nonzero(as_tuple=True)
-    sizes = sizes.flatten()
-    segments = sizes*step
-    # pointer increments
-    if trans:
-        nnz = layout.nonzero(as_tuple=False)
-    else:
-        nnz = layout.transpose(1, 2).nonzero(as_tuple=False)
-    num_blocks = nnz.size(0)
-    offsets = torch.zeros_like(sizes)
-    offsets[1:] = torch.cumsum(sizes[:-1], dim=0)
-    offsets = torch.min(offsets, (num_blocks - 1) * torch.ones_like(offsets))
-    # -------------------------------
-    # dense input pointer increments
-    # -------------------------------
-    # given a list of the indices for the first element of each non-zero block.
-    # For example, for the indices
-    # [32, 80, 128, 256, 288]
-    # we would generate the increments
-    # [32, 48, 48, 128, 32]
-    #        ^
-    #   index of first element
-    # Note that the inner loop matmul kernel may have a fixed step size (e.g., TILE_K)
-    # that is smaller than the block size, so we need to do a bit of extra work
-    # to handle this case
-    B_idx = nnz[:, 2] * block
-    B_incs = B_idx.clone()
-    B_incs[1:] -= B_idx[:-1]
-    div = block // step
-    B_incs = B_incs.view(-1, 1).repeat(1, div)
-    B_incs[:, 1:] = step
-    B_incs[:, 0] -= (div - 1) * step
-    # first increment for each reduction is actually the offset
-    B_incs[offsets[segments > 0], 0] = B_idx[offsets[segments > 0]]
-    B_incs = B_incs.view(-1)
-    # -------------------------------
-    # sparse input pointer increments
-    # -------------------------------
-    # same as above, except that the increments are in the sparse memory layout
-    if trans:
-        A_idx = torch.arange(num_blocks)
-    else:
-        A_idx = torch.tensor([], dtype=torch.int64, device=layout.device)
-        current_offset = 0
-        for z in range(layout.size(0)):
-            layoutw = layout[z, :, :].clone()
-            msum = layoutw.sum()
-            layoutw[layoutw > 0] = 1 + torch.arange(msum)
-            A_idx = torch.cat((A_idx, current_offset + layoutw.T[layoutw.T > 0] - 1))
-            current_offset += msum
-    A_incs = A_idx * block * block
-    A_incs[1:] -= A_idx[:-1] * block * block
-    A_incs = A_incs.view(-1, 1).repeat(1, div)
-    if trans:
-        A_incs[:, 1:] = step
-        A_incs[:, 0] -= (div - 1) * step
-    else:
-        A_incs[:, 1:] = step * block
-        A_incs[:, 0] -= (div - 1) * step * block
-    A_incs[offsets[segments > 0], 0] = A_idx[offsets[segments > 0]]
-    A_incs = A_incs.view(-1)
-    # create header
-    width    = col_id.size(0)
-    offsets  = offsets*2*div + 4*width
-    segments = segments*div
-    header   = torch.stack((offsets, segments, col_id, head_id), dim=1).view(-1).contiguous()
-    # create increments
-    incs     = torch.stack((B_incs, A_incs), dim=1).view(-1).contiguous()
-    incs     = torch.cat((incs, torch.zeros(2, device=incs.device, dtype=incs.dtype)))
-    # create lut
-    lut = torch.cat((header, incs))
-    lut = lut.type(torch.int32).to(device)
-    # create locks
+def dsd_lut(layout, block, step, trans, device):
+    # one reduction per row (trans) or column of each head, including empty
+    # ones, so that every block of the dense output gets written
+    H, M, N = layout.shape
+    lut, width = libtriton.blocksparse.dsd_lut(packbits(layout), H, M, N, block, step, trans)
+    lut = torch.from_numpy(lut).type(torch.int32).to(device)
     return lut, None, width, None
 
 # -----------------------------
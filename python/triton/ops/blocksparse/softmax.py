@@ -1,6 +1,8 @@
 import triton.language as tl
 import triton
+import triton._C.libtriton as libtriton
 import torch
+from .matmul import packbits
 
 
 def num_warps(n):
@@ -108,25 +110,10 @@ def _backward(X, scale, DX, LUT, sizemax, stride_zx, stride_zdx, **meta):
 class _softmax(torch.autograd.Function):
     @staticmethod
     def make_lut(layout, block, device):
-        _empty = torch.tensor([], dtype=torch.int64, device=layout.device)
-        sizes = _empty.clone()
-        # sizes along rows
-        for h in range(layout.shape[0]):
-            sizes = torch.cat((sizes, layout[h, :, :].sum(-1)))
-        # offsets in block format
-        offsets = torch.zeros_like(sizes)
-        offsets[1:] = torch.cumsum(sizes[:-1], dim=0)
-        # block indices
-        idx = torch.arange(layout.sum())
-        head = layout.nonzero(as_tuple=False)[:, 0]
-        rows = layout.nonzero(as_tuple=False)[:, 1]
-        columns = layout.nonzero(as_tuple=False)[:, 2]
-        core = torch.stack((idx, columns, rows, head), dim=1).view(-1)
-        # construct look-up table
-        offsets = offsets * 4 + 2 * sizes.numel()
-        header = torch.stack((sizes, offsets), dim=1).view(-1)
-        lut = torch.cat((header, core)).type(torch.int32).to(device)
-        return lut, int(sizes.max())
+        H, M, N = layout.shape
+        lut, maxlut = libtriton.blocksparse.softmax_lut(packbits(layout), H, M, N)
+        lut = torch.from_numpy(lut).type(torch.int32).to(device)
+        return lut, maxlut
 
     @staticmethod
     def forward(
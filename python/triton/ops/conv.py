@@ -0,0 +1,147 @@
+import torch
+import triton
+import triton.language as tl
+from .matmul import _tile_coords, _epilogue
+
+# ********************************************************
+# --------------------------------------------------------
+# 2D convolution of NHWC inputs with KRSC filters, as an
+# implicit GEMM: rows of the im2col matrix are output
+# pixels (n, p, q) and its columns are filter taps
+# (r, s, c); it is never materialized in memory. Input
+# pointers are loop-carried, so that the inner loop is
+# pipelined like the one of `matmul`.
+# --------------------------------------------------------
+# ********************************************************
+
+
+def _prune_configs(configs, named_args):
+    # a block of the reduction must not straddle two filter taps
+    return [c for c in configs if named_args['C'] % c.meta['BLOCK_K'] == 0]
+
+
+@triton.autotune(
+    configs=[
+        triton.Config({'BLOCK_M': 128, 'BLOCK_N': 128, 'BLOCK_K': 32}, num_stages=3, num_warps=8),
+        triton.Config({'BLOCK_M': 256, 'BLOCK_N': 64 , 'BLOCK_K': 32}, num_stages=3, num_warps=8),
+        triton.Config({'BLOCK_M': 128, 'BLOCK_N': 64 , 'BLOCK_K': 32}, num_stages=4, num_warps=4),
+        triton.Config({'BLOCK_M': 64 , 'BLOCK_N': 128, 'BLOCK_K': 32}, num_stages=4, num_warps=4),
+        triton.Config({'BLOCK_M': 64 , 'BLOCK_N': 64 , 'BLOCK_K': 32}, num_stages=4, num_warps=4),
+        triton.Config({'BLOCK_M': 128, 'BLOCK_N': 64 , 'BLOCK_K': 16}, num_stages=4, num_warps=4),
+        triton.Config({'BLOCK_M': 64 , 'BLOCK_N': 64 , 'BLOCK_K': 16}, num_stages=4, num_warps=4),
+        triton.Config({'BLOCK_M': 64 , 'BLOCK_N': 32 , 'BLOCK_K': 16}, num_stages=5, num_warps=2),
+    ],
+    key=['M', 'K', 'C', 'R', 'S'],
+    prune_configs_by=_prune_configs,
+)
+@triton.jit
+def _kernel(X, W, Y, BIAS, M, K, C, H, W_, P, Q, R, S,
+            stride_xn, stride_xh, stride_xw,
+            stride_h, stride_w, pad_h, pad_w, dil_h, dil_w, **META):
+    BLOCK_M = META['BLOCK_M']
+    BLOCK_N = META['BLOCK_N']
+    BLOCK_K = META['BLOCK_K']
+    pid_m, pid_n = _tile_coords(tl.program_id(0), M, K)
+    rm = pid_m * BLOCK_M + tl.arange(0, BLOCK_M)
+    rn = pid_n * BLOCK_N + tl.arange(0, BLOCK_N)
+    rk = tl.arange(0, BLOCK_K)
+    # output pixels of this tile, and the top-left corner of their receptive field
+    ram = rm % M
+    n = ram // (P * Q)
+    pq = ram % (P * Q)
+    ih0 = (pq // Q) * stride_h - pad_h
+    iw0 = (pq % Q) * stride_w - pad_w
+    off_x = n * stride_xn + ih0 * stride_xh + iw0 * stride_xw
+    # filters are stored as a (K, R * S * C) row-major matrix
+    rbn = tl.max_contiguous(tl.multiple_of(rn % K, BLOCK_N), BLOCK_N)
+    B = W + (rbn[None, :] * (R * S * C) + rk[:, None])
+    # first tap
+    A = X + (off_x[:, None] + rk[None, :])
+    mask_a = ((ih0 >= 0) & (ih0 < H) & (iw0 >= 0) & (iw0 < W_))[:, None]
+    acc = tl.zeros((BLOCK_M, BLOCK_N), dtype=tl.float32)
+    blocks_per_tap = C // BLOCK_K
+    for i in range(0, R * S * blocks_per_tap):
+        a = tl.load(A, mask=mask_a, other=0.)
+        b = tl.load(B)
+        acc += tl.dot(a, b)
+        # pointers for the next iteration; B walks the reduction
+        # contiguously, A jumps whenever the filter tap changes
+        rs = (i + 1) // blocks_per_tap
+        c = ((i + 1) % blocks_per_tap) * BLOCK_K
+        ih = ih0 + (rs // S) * dil_h
+        iw = iw0 + (rs % S) * dil_w
+        A = X + (off_x[:, None] + ((rs // S) * dil_h * stride_xh + (rs % S) * dil_w * stride_xw + c + rk)[None, :])
+        mask_a = ((ih >= 0) & (ih < H) & (iw >= 0) & (iw < W_))[:, None]
+        B += BLOCK_K
+    # write-back; the output is a (N * P * Q, K) row-major matrix
+    mask = (rm < M)[:, None] & (rn < K)[None, :]
+    acc = _epilogue(acc, rm, rn, mask, BIAS, Y, K, 1, K)
+    tl.store(Y + (rm[:, None] * K + rn[None, :]), acc, mask=mask)
+
+
+def _pair(x):
+    return (x, x) if isinstance(x, int) else tuple(x)
+
+
+class _conv(torch.autograd.Function):
+    kernel = _kernel
+
+    _activations = [None, 'relu', 'gelu']
+
+    @staticmethod
+    def _call(x, w, bias, stride, padding, dilation, activation):
+        # checks constraints
+        assert x.dim() == 4 and w.dim() == 4, "x must be NHWC and w must be KRSC"
+        assert x.shape[3] == w.shape[3], "incompatible number of channels"
+        assert activation in _conv._activations, f"unsupported activation {activation}"
+        N, H, W, C = x.shape
+        K, R, S, _ = w.shape
+        assert bias is None or bias.shape == (K, ), "bias must be a vector of size K"
+        stride_h, stride_w = _pair(stride)
+        pad_h, pad_w = _pair(padding)
+        dil_h, dil_w = _pair(dilation)
+        P = (H + 2 * pad_h - dil_h * (R - 1) - 1) // stride_h + 1
+        Q = (W + 2 * pad_w - dil_w * (S - 1) - 1) // stride_w + 1
+        # channels are padded with zeros to a multiple of the smallest BLOCK_K
+        if C % 16 != 0:
+            pad = 16 - C % 16
+            x = torch.nn.functional.pad(x, (0, pad))
+            w = torch.nn.functional.pad(w, (0, pad))
+            C += pad
+        # channels and filters must be contiguous
+        if x.stride(3) != 1:
+            x = x.contiguous()
+        w = w.contiguous()
+        # allocates output
+        y = torch.empty((N, P, Q, K), device=x.device, dtype=x.dtype)
+        M = N * P * Q
+        if M == 0 or K == 0:
+            return y
+        # launch kernel
+        grid = lambda META: (triton.cdiv(M, META['BLOCK_M']) * triton.cdiv(K, META['BLOCK_N']), )
+        _kernel[grid](x, w, y, y if bias is None else bias,
+                      M, K, C, H, W, P, Q, R, S,
+                      x.stride(0), x.stride(1), x.stride(2),
+                      stride_h, stride_w, pad_h, pad_w, dil_h, dil_w,
+                      GROUP_M=8,
+                      HAS_BIAS=bias is not None,
+                      ACTIVATION=activation,
+                      HAS_RESIDUAL=False)
+        return y
+
+    @staticmethod
+    def forward(ctx, x, w, bias, stride, padding, dilation, activation):
+        return _conv._call(x, w, bias, stride, padding, dilation, activation)
+
+
+def conv2d(x, w, bias=None, stride=1, padding=0, dilation=1, activation=None):
+    """
+    Computes :code:`activation(conv2d(x, w) + bias)`, where :code:`x` is an NHWC tensor of shape (N, H, W, C)
+    and :code:`w` a tensor of K filters of shape (K, R, S, C). The output is an NHWC tensor of shape (N, P, Q, K).
+
+    :param stride: stride of the convolution, as an int or a pair of ints.
+    :param padding: zero-padding added to the spatial dimensions of the input, as an int or a pair of ints.
+    :param dilation: spacing between filter taps, as an int or a pair of ints.
+    :param activation: one of :code:`None`, :code:`'relu'` or :code:`'gelu'` (tanh approximation).
+    """
+    return _conv.apply(x, w, bias, stride, padding, dilation, activation)
@@ -70,14 +70,84 @@ def _backward(PROBS, IDX, DPROBS, N, **meta):
     tl.store(PROBS, din.to(tl.float16), mask=cols < N)
 
 
+# rows larger than this are processed in chunks, so that
+# resource usage does not grow with the size of the vocabulary
+MAX_BLOCK = 4096
+
+
+@triton.heuristics({'num_warps': lambda *args, **meta: num_warps(meta['BLOCK'])})
+@triton.heuristics({'BLOCK': lambda *args, **meta: min(next_power_of_2(args[4]), MAX_BLOCK)})
+@triton.heuristics({'HAS_SMOOTHING': lambda *args, **meta: args[5] > 0})
+@triton.jit
+def _forward_chunked(LOGITS, LSE, IDX, LOSS, N, label_smoothing, ignore_index, **meta):
+    BLOCK = meta['BLOCK']
+    row = tl.program_id(0)
+    cols = tl.arange(0, BLOCK)
+    LOGITS = LOGITS + row * N
+    # running max, sum of exponentials and sum of logits
+    m = float('-inf')
+    s = 0.
+    total = 0.
+    for start in range(0, N, BLOCK):
+        logits = tl.load(LOGITS + start + cols, mask=start + cols < N, other=-float('inf'))
+        logits = logits.to(tl.float32)
+        m_new = tl.maximum(m, tl.max(logits, 0))
+        s = s * tl.exp(m - m_new) + tl.sum(tl.exp(logits - m_new), 0)
+        m = m_new
+        if meta['HAS_SMOOTHING']:
+            total += tl.sum(tl.where(start + cols < N, logits, 0.), 0)
+    lse = m + tl.log(s)
+    tl.store(LSE + row, lse)
+    # write-back loss; label smoothing mixes the one-hot
+    # target with a uniform distribution over the N classes
+    idx = tl.load(IDX + row)
+    loss = 0.
+    if idx != ignore_index:
+        logit = tl.load(LOGITS + idx).to(tl.float32)
+        if meta['HAS_SMOOTHING']:
+            loss = lse - (1 - label_smoothing) * logit - label_smoothing * (total / N)
+        else:
+            loss = lse - logit
+    tl.store(LOSS + row, loss)
+
+
+@triton.heuristics({'num_warps': lambda *args, **meta: num_warps(meta['BLOCK'])})
+@triton.heuristics({'BLOCK': lambda *args, **meta: min(next_power_of_2(args[5]), MAX_BLOCK)})
+@triton.heuristics({'HAS_SMOOTHING': lambda *args, **meta: args[6] > 0})
+@triton.jit
+def _backward_chunked(LOGITS, DLOGITS, LSE, IDX, DLOSS, N, label_smoothing, ignore_index, **meta):
+    BLOCK = meta['BLOCK']
+    row = tl.program_id(0)
+    cols = tl.arange(0, BLOCK)
+    LOGITS = LOGITS + row * N
+    DLOGITS = DLOGITS + row * N
+    idx = tl.load(IDX + row)
+    lse = tl.load(LSE + row)
+    # ignored rows have zero gradient
+    dout = 0.
+    if idx != ignore_index:
+        dout = tl.load(DLOSS + row).to(tl.float32)
+    # d(loss)/dlogit[k] = p[k] - (1 - label_smoothing) * id_mat[idx, k] - label_smoothing / N
+    for start in range(0, N, BLOCK):
+        logits = tl.load(LOGITS + start + cols, mask=start + cols < N, other=0.)
+        probs = tl.exp(logits.to(tl.float32) - lse)
+        if meta['HAS_SMOOTHING']:
+            probs = probs - label_smoothing / N
+        probs = tl.where(start + cols == idx, probs - (1 - label_smoothing), probs)
+        tl.store(DLOGITS + start + cols, probs * dout, mask=start + cols < N)
+
+
 class _cross_entropy(torch.autograd.Function):
     @classmethod
-    def forward(cls, ctx, logits, indices):
+    def forward(cls, ctx, logits, indices, label_smoothing, ignore_index):
         # make sure we can use triton
         assert (indices.dtype == torch.int64), "Indices are expected to be of type long."
         # make kernel
         device, dtype = logits.device, logits.dtype
         n_cols = logits.shape[-1]
+        ctx.chunked = n_cols > MAX_BLOCK or label_smoothing > 0 or ignore_index is not None
+        if ctx.chunked:
+            return cls._forward_chunked(ctx, logits, indices, label_smoothing, ignore_index)
         # run the kernel
         result = torch.empty_like(indices, dtype=dtype, device=device)
         neg_logprobs = torch.empty_like(logits, dtype=dtype, device=device)
@@ -94,6 +164,8 @@ class _cross_entropy(torch.autograd.Function):
         to get p[k], which is most of what we need...  neg_logprobs will be
         modified in place to become the gradient we want
         """
+        if ctx.chunked:
+            return cls._backward_chunked(ctx, dneg_logprobs)
         # load saved tensors
         neg_logprobs, indices = ctx.saved_tensors
         # make kernel
@@ -103,7 +175,44 @@ class _cross_entropy(torch.autograd.Function):
         # neg_logprobs will be modified in place to become our gradient:
         grid = lambda opt: (neg_logprobs.numel() // n_cols, )
         _backward[grid](neg_logprobs, indices, dneg_logprobs, n_cols)
-        return neg_logprobs, None
+        return neg_logprobs, None, None, None
+
+    @classmethod
+    def _forward_chunked(cls, ctx, logits, indices, label_smoothing, ignore_index):
+        # negative indices are never valid
+        ignore_index = -1 if ignore_index is None else ignore_index
+        device, dtype = logits.device, logits.dtype
+        n_cols = logits.shape[-1]
+        n_rows = logits.numel() // n_cols
+        result = torch.empty_like(indices, dtype=dtype, device=device)
+        lse = torch.empty(n_rows, dtype=torch.float32, device=device)
+        grid = lambda opt: (n_rows, )
+        _forward_chunked[grid](logits, lse, indices, result, n_cols, float(label_smoothing), ignore_index)
+        # only the log-sum-exp of each row is saved; probabilities are re-computed
+        ctx.save_for_backward(logits, lse, indices)
+        ctx.label_smoothing = float(label_smoothing)
+        ctx.ignore_index = ignore_index
+        return result
+
+    @classmethod
+    def _backward_chunked(cls, ctx, dloss):
+        logits, lse, indices = ctx.saved_tensors
+        n_cols = logits.shape[-1]
+        dlogits = torch.empty_like(logits)
+        grid = lambda opt: (logits.numel() // n_cols, )
+        _backward_chunked[grid](logits, dlogits, lse, indices, dloss.contiguous(), n_cols,
+                                ctx.label_smoothing, ctx.ignore_index)
+        return dlogits, None, None, None
+
+
+def cross_entropy(logits, indices, label_smoothing=0., ignore_index=None):
+    """
+    Computes the cross-entropy loss between :code:`logits` and the target :code:`indices`, without reduction.
 
+    Rows of more than :code:`MAX_BLOCK` logits, or any use of the options below, are processed
+    in chunks of at most :code:`MAX_BLOCK` elements with an online softmax.
 
-cross_entropy = _cross_entropy.apply
\ No newline at end of file
+    :param label_smoothing: amount of probability mass taken from the target and spread uniformly over all classes.
+    :param ignore_index: target index whose rows have a loss and gradient of zero.
+    """
+    return _cross_entropy.apply(logits, indices, label_smoothing, ignore_index)
\ No newline at end of file
@@ -0,0 +1,113 @@
+import torch
+import triton
+import triton.language as tl
+
+# ********************************************************
+# --------------------------------------------------------
+# Cumulative sum along the last dimension, in a single pass
+# over rows of any size. Rows longer than a tile are split
+# across programs, which find the prefix of their tile with
+# a decoupled look-back: every program publishes the sum of
+# its tile as soon as it is known, then the inclusive prefix
+# of its tile, and sums the states of its predecessors until
+# it reaches a published prefix.
+# --------------------------------------------------------
+# ********************************************************
+
+# states are 64-bit words: a flag in the high 32 bits and
+# the bits of a 32-bit value in the low 32 bits
+_AGGREGATE = 1 << 32
+_PREFIX = 2 << 32
+
+
+def next_power_of_2(n):
+    return 1 << (n - 1).bit_length()
+
+
+@triton.jit
+def _pack(value, flag, **META):
+    if META['IS_FLOAT']:
+        value = value.to(tl.int32, bitcast=True)
+    return (value.to(tl.int64) & 0xffffffff) | flag
+
+
+@triton.jit
+def _unpack(state, **META):
+    value = state.to(tl.int32)
+    if META['IS_FLOAT']:
+        value = value.to(tl.float32, bitcast=True)
+    return value, state >> 32
+
+
+@triton.jit
+def _kernel(X, Y, STATE, COUNTER, N, stride_xm, stride_ym, num_tiles, **META):
+    BLOCK = META['BLOCK']
+    row = tl.program_id(0)
+    if META['LOOK_BACK']:
+        # tiles are numbered in the order in which programs start, so
+        # that the predecessors of a tile never wait for it
+        tile = tl.atomic_add(COUNTER + row, 1)
+    else:
+        tile = tl.program_id(1)
+    cols = tile * BLOCK + tl.arange(0, BLOCK)
+    mask = cols < N
+    x = tl.load(X + row * stride_xm + cols, mask=mask, other=0)
+    if META['IS_FLOAT']:
+        x = x.to(tl.float32)
+        zero = 0.
+    else:
+        x = x.to(tl.int32)
+        zero = 0
+    exclusive = zero
+    if META['LOOK_BACK']:
+        STATE = STATE + row * num_tiles
+        aggregate = tl.sum(x, 0)
+        tl.atomic_xchg(STATE + tile, _pack(aggregate, _AGGREGATE))
+        j = tile - 1
+        while j >= 0:
+            value, flag = _unpack(tl.atomic_add(STATE + j, 0))
+            exclusive += tl.where(flag > 0, value, zero)
+            # predecessors that have not published anything are polled again
+            j = tl.where(flag == 2, -1, tl.where(flag == 1, j - 1, j))
+        tl.atomic_xchg(STATE + tile, _pack(exclusive + aggregate, _PREFIX))
+    y = tl.cumsum(x, 0) + exclusive
+    tl.store(Y + row * stride_ym + cols, y, mask=mask)
+
+
+_float_dtypes = [torch.float16, torch.bfloat16, torch.float32]
+_int_dtypes = [torch.int8, torch.int16, torch.int32]
+
+
+def cumsum(x, block=None):
+    """
+    Computes the cumulative sum of :code:`x` along its last dimension, in a single pass.
+    Floating-point values are accumulated in fp32. Integers are accumulated in int32, and
+    the result of integer inputs is int32 (unlike :code:`torch.cumsum`); partial sums
+    must fit in this range.
+
+    :param block: number of elements of a row processed by each program; a power of two.
+    """
+    # checks constraints
+    assert x.dtype in _float_dtypes + _int_dtypes, f"unsupported data-type {x.dtype}"
+    N = x.shape[-1]
+    shape = x.shape
+    x = x.reshape(-1, N)
+    if x.stride(-1) != 1:
+        x = x.contiguous()
+    M = x.shape[0]
+    # allocates output
+    is_float = x.dtype in _float_dtypes
+    y = torch.empty((M, N), device=x.device, dtype=x.dtype if is_float else torch.int32)
+    if M == 0 or N == 0:
+        return y.reshape(shape)
+    BLOCK = min(max(next_power_of_2(N), 128), 2048) if block is None else block
+    num_tiles = triton.cdiv(N, BLOCK)
+    # look-back states and tile counters
+    look_back = num_tiles > 1
+    state = torch.zeros((M, num_tiles) if look_back else (1, ), device=x.device, dtype=torch.int64)
+    counter = torch.zeros((M if look_back else 1, ), device=x.device, dtype=torch.int32)
+    # rows go on the first axis of the grid, which is not limited to 65535 programs
+    grid = (M, num_tiles)
+    _kernel[grid](x, y, state, counter, N, x.stride(0), y.stride(0), num_tiles,
+                  BLOCK=BLOCK, IS_FLOAT=is_float, LOOK_BACK=look_back, num_warps=4)
+    return y.reshape(shape)
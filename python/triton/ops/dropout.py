@@ -0,0 +1,105 @@
+import torch
+import triton
+import triton.language as tl
+
+# ********************************************************
+# --------------------------------------------------------
+# Dropout whose mask is never materialized: it is drawn
+# from Philox at (seed, offset) in the forward pass and
+# drawn again, identically, in the backward pass.
+# --------------------------------------------------------
+# ********************************************************
+
+# number of elements processed by each program.
+# the mask depends on it, so it must not be tuned
+# independently for the forward and backward passes
+BLOCK = 1024
+
+
+@triton.jit
+def _dropout_chunk(X, Y, BIAS, RESIDUAL, N, numel, p, scale, offs, r, **META):
+    mask = offs < numel
+    x = tl.load(X + offs, mask=mask, other=0.).to(tl.float32)
+    if META['HAS_BIAS']:
+        x += tl.load(BIAS + offs % N, mask=mask, other=0.).to(tl.float32)
+    y = tl.where(r >= p, x * scale, 0.)
+    if META['HAS_RESIDUAL']:
+        y += tl.load(RESIDUAL + offs, mask=mask, other=0.).to(tl.float32)
+    tl.store(Y + offs, y, mask=mask)
+
+
+# the seed changes at every forward pass: specializing on
+# its value would compile a new binary for no benefit
+@triton.jit(do_not_specialize=['seed'])
+def _dropout(X, Y, BIAS, RESIDUAL, N, numel, p, scale, seed, **META):
+    # one Philox evaluation yields four random numbers,
+    # which are used for four quarters of the block
+    QUARTER = META['BLOCK'] // 4
+    pid = tl.program_id(0)
+    counters = pid * QUARTER + tl.arange(0, QUARTER)
+    r0, r1, r2, r3 = tl.rand4x(seed, counters)
+    offs = pid * META['BLOCK'] + tl.arange(0, QUARTER)
+    _dropout_chunk(X, Y, BIAS, RESIDUAL, N, numel, p, scale, offs, r0)
+    _dropout_chunk(X, Y, BIAS, RESIDUAL, N, numel, p, scale, offs + QUARTER, r1)
+    _dropout_chunk(X, Y, BIAS, RESIDUAL, N, numel, p, scale, offs + 2 * QUARTER, r2)
+    _dropout_chunk(X, Y, BIAS, RESIDUAL, N, numel, p, scale, offs + 3 * QUARTER, r3)
+
+
+def _call(x, bias, residual, p, seed):
+    # the bias is indexed as `offs % N`
+    assert bias is None or bias.is_contiguous()
+    y = torch.empty_like(x)
+    numel = x.numel()
+    N = x.shape[-1]
+    scale = 1. / (1. - p) if p < 1. else 0.
+    grid = lambda META: (triton.cdiv(numel, META['BLOCK']), )
+    _dropout[grid](x, y, x if bias is None else bias, x if residual is None else residual,
+                   N, numel, float(p), float(scale), seed, BLOCK=BLOCK, num_warps=4,
+                   HAS_BIAS=bias is not None, HAS_RESIDUAL=residual is not None)
+    return y
+
+
+class _dropout_op(torch.autograd.Function):
+    @staticmethod
+    def forward(ctx, x, p, bias, residual, seed):
+        # checks constraints
+        assert 0. <= p <= 1., "dropout probability must be in [0, 1]"
+        assert bias is None or bias.shape == (x.shape[-1], ), "bias must be a vector of the size of the last dimension"
+        assert residual is None or residual.shape == x.shape, "residual must have the same shape as the input"
+        x = x.contiguous()
+        bias = None if bias is None else bias.contiguous()
+        residual = None if residual is None else residual.contiguous()
+        if seed is None:
+            seed = int(torch.randint(0, 2**31 - 1, (1, )).item())
+        y = _call(x, bias, residual, p, seed)
+        # only the seed is kept for the backward pass
+        ctx.p = p
+        ctx.seed = seed
+        ctx.has_bias = bias is not None
+        ctx.has_residual = residual is not None
+        return y
+
+    @staticmethod
+    def backward(ctx, dy):
+        dy = dy.contiguous()
+        # same seed and offsets: the mask is regenerated
+        dx = _call(dy, None, None, ctx.p, ctx.seed)
+        dbias = dx.reshape(-1, dx.shape[-1]).sum(0) if ctx.has_bias else None
+        dresidual = dy if ctx.has_residual else None
+        return dx, None, dbias, dresidual, None
+
+
+def dropout(x, p, bias=None, residual=None, training=True, seed=None):
+    """
+    Computes :code:`dropout(x + bias, p) + residual`, where :code:`bias` is broadcast along
+    the last dimension and both :code:`bias` and :code:`residual` are optional.
+
+    The dropout mask is a function of :code:`seed` and of the position of each element only;
+    it is not stored for the backward pass, which regenerates it instead.
+
+    :param seed: seed of the random number generator; drawn from torch's default generator if not provided.
+    """
+    if not training or p == 0.:
+        y = x if bias is None else x + bias
+        return y if residual is None else y + residual
+    return _dropout_op.apply(x, p, bias, residual, seed)
@@ -0,0 +1,192 @@
+import functools
+import math
+import torch
+import triton
+import triton.language as tl
+from .matmul import _tile_coords, _mac_loop, _epilogue
+
+# ********************************************************
+# --------------------------------------------------------
+# Lists of independent matrix multiplications, computed by
+# a single launch of a single kernel: tiles of all problems
+# are numbered one problem after the other, and every
+# program looks up the problem that its tile belongs to.
+# --------------------------------------------------------
+# ********************************************************
+
+# M, N, K, offsets of A, B and C, leading strides of A, B and C
+_PROBLEM_SIZE = 9
+
+_configs = [
+    triton.Config({'BLOCK_M': 128, 'BLOCK_N': 256, 'BLOCK_K': 32}, num_stages=3, num_warps=8),
+    triton.Config({'BLOCK_M': 256, 'BLOCK_N': 128, 'BLOCK_K': 32}, num_stages=3, num_warps=8),
+    triton.Config({'BLOCK_M': 128, 'BLOCK_N': 128, 'BLOCK_K': 32}, num_stages=4, num_warps=4),
+    triton.Config({'BLOCK_M': 128, 'BLOCK_N': 64 , 'BLOCK_K': 32}, num_stages=4, num_warps=4),
+    triton.Config({'BLOCK_M': 64 , 'BLOCK_N': 128, 'BLOCK_K': 32}, num_stages=4, num_warps=4),
+    triton.Config({'BLOCK_M': 64 , 'BLOCK_N': 64 , 'BLOCK_K': 32}, num_stages=4, num_warps=4),
+    triton.Config({'BLOCK_M': 64 , 'BLOCK_N': 32 , 'BLOCK_K': 32}, num_stages=5, num_warps=2),
+    triton.Config({'BLOCK_M': 32 , 'BLOCK_N': 64 , 'BLOCK_K': 32}, num_stages=5, num_warps=2),
+]
+
+
+@triton.jit
+def _store_tile(C, acc, pid_m, pid_n, M, N, stride_cm, stride_cn, **META):
+    rm = pid_m * META['BLOCK_M'] + tl.arange(0, META['BLOCK_M'])
+    rn = pid_n * META['BLOCK_N'] + tl.arange(0, META['BLOCK_N'])
+    mask = (rm < M)[:, None] & (rn < N)[None, :]
+    acc = _epilogue(acc, rm, rn, mask, C, C, stride_cm, stride_cn, N)
+    tl.store(C + (rm[:, None] * stride_cm + rn[None, :] * stride_cn), acc, mask=mask)
+
+
+@triton.jit
+def _num_tiles(PROBLEMS, g, **META):
+    M = tl.load(PROBLEMS + g * _PROBLEM_SIZE + 0).to(tl.int32)
+    N = tl.load(PROBLEMS + g * _PROBLEM_SIZE + 1).to(tl.int32)
+    return ((M + META['BLOCK_M'] - 1) // META['BLOCK_M']) * ((N + META['BLOCK_N'] - 1) // META['BLOCK_N'])
+
+
+@triton.heuristics({
+    'EVEN_K': lambda *args, **meta: args[5] % meta['BLOCK_K'] == 0,
+})
+@triton.autotune(configs=_configs, key=['G', 'MAX_M', 'MAX_N', 'MAX_K'])
+@triton.jit
+def _grouped_kernel(A, B, C, PROBLEMS, G, K_ALIGN, MAX_M, MAX_N, MAX_K, **META):
+    # find the problem that this tile belongs to;
+    # problems without tiles are skipped
+    pid = tl.program_id(0)
+    g = 0
+    start = 0
+    tiles = _num_tiles(PROBLEMS, g)
+    while pid >= start + tiles:
+        start += tiles
+        g += 1
+        tiles = _num_tiles(PROBLEMS, g)
+    # unpack the problem
+    P = PROBLEMS + g * _PROBLEM_SIZE
+    M = tl.load(P + 0).to(tl.int32)
+    N = tl.load(P + 1).to(tl.int32)
+    K = tl.load(P + 2).to(tl.int32)
+    A = A + tl.load(P + 3)
+    B = B + tl.load(P + 4)
+    C = C + tl.load(P + 5)
+    stride_am = tl.load(P + 6).to(tl.int32)
+    stride_bk = tl.load(P + 7).to(tl.int32)
+    stride_cm = tl.load(P + 8).to(tl.int32)
+    # matrix multiplication; inner dimensions are contiguous
+    pid_m, pid_n = _tile_coords(pid - start, M, N)
+    acc = _mac_loop(A, B, M, N, K, stride_am, 1, stride_bk, 1, pid_m, pid_n, 0, K, 1)
+    _store_tile(C, acc, pid_m, pid_n, M, N, stride_cm, 1)
+
+
+@triton.heuristics({
+    'EVEN_K': lambda *args, **meta: args[5] % meta['BLOCK_K'] == 0,
+})
+@triton.autotune(configs=_configs, key=['M', 'N', 'K'])
+@triton.jit
+def _batched_kernel(A, B, C, M, N, K,
+                    stride_az, stride_am, stride_ak,
+                    stride_bz, stride_bk, stride_bn,
+                    stride_cz, stride_cm, stride_cn, **META):
+    pid = tl.program_id(0)
+    pid_z = tl.program_id(1)
+    A = A + pid_z * stride_az
+    B = B + pid_z * stride_bz
+    C = C + pid_z * stride_cz
+    pid_m, pid_n = _tile_coords(pid, M, N)
+    acc = _mac_loop(A, B, M, N, K, stride_am, stride_ak, stride_bk, stride_bn, pid_m, pid_n, 0, K, 1)
+    _store_tile(C, acc, pid_m, pid_n, M, N, stride_cm, stride_cn)
+
+
+def _offsets(tensors):
+    # element offsets of every tensor with respect to the
+    # one at the lowest address, which is passed to the kernel.
+    # empty tensors may not be allocated and are never accessed
+    allocated = [t for t in tensors if t.numel() > 0]
+    base = min(allocated, key=lambda t: t.data_ptr()) if allocated else tensors[0]
+    size = base.element_size()
+    offsets = []
+    for t in tensors:
+        assert t.dtype == base.dtype, "all the matrices of an operand must have the same data-type"
+        if t.numel() == 0:
+            offsets.append(0)
+            continue
+        assert (t.data_ptr() - base.data_ptr()) % size == 0, "misaligned operand"
+        offsets.append((t.data_ptr() - base.data_ptr()) // size)
+    return base, offsets
+
+
+def _row_major(x):
+    return x if x.stride(1) == 1 else x.contiguous()
+
+
+def grouped_matmul(a, b, activation=None, dtype=None):
+    """
+    Computes :code:`[activation(a[i] @ b[i]) for i in range(len(a))]` with a single kernel launch.
+    Problems may have different sizes; this is typically used for the experts of a mixture-of-experts layer.
+
+    :param a: list of 2D tensors of shape (M_i, K_i).
+    :param b: list of 2D tensors of shape (K_i, N_i).
+    :param activation: one of :code:`None`, :code:`'relu'` or :code:`'gelu'` (tanh approximation).
+    :param dtype: data-type of the outputs; defaults to that of :code:`a`.
+    """
+    # checks constraints
+    assert len(a) == len(b) and len(a) > 0, "a and b must be non-empty lists of the same size"
+    assert activation in [None, 'relu', 'gelu'], f"unsupported activation {activation}"
+    for x, y in zip(a, b):
+        assert x.dim() == 2 and y.dim() == 2 and x.shape[1] == y.shape[0], "incompatible dimensions"
+    a = [_row_major(x) for x in a]
+    b = [_row_major(y) for y in b]
+    device = a[0].device
+    # allocates outputs
+    c = [torch.empty((x.shape[0], y.shape[1]), device=device, dtype=x.dtype if dtype is None else dtype) for x, y in zip(a, b)]
+    # problem descriptors
+    base_a, off_a = _offsets(a)
+    base_b, off_b = _offsets(b)
+    base_c, off_c = _offsets(c)
+    problems = [[x.shape[0], y.shape[1], x.shape[1], oa, ob, oc, x.stride(0), y.stride(0), z.stride(0)]
+                for x, y, z, oa, ob, oc in zip(a, b, c, off_a, off_b, off_c)]
+    problems = torch.tensor(problems, dtype=torch.int64, device=device)
+    G = len(a)
+    K_align = functools.reduce(math.gcd, [x.shape[1] for x in a])
+    max_m = max(x.shape[0] for x in a)
+    max_n = max(y.shape[1] for y in b)
+    max_k = max(x.shape[1] for x in a)
+    # launch kernel
+    if max_m == 0 or max_n == 0:
+        return c
+    grid = lambda META: (sum(triton.cdiv(x.shape[0], META['BLOCK_M']) * triton.cdiv(y.shape[1], META['BLOCK_N'])
+                             for x, y in zip(a, b)), )
+    _grouped_kernel[grid](base_a, base_b, base_c, problems, G, K_align, max_m, max_n, max_k,
+                          GROUP_M=8, HAS_BIAS=False, ACTIVATION=activation, HAS_RESIDUAL=False)
+    return c
+
+
+def batched_matmul(a, b, activation=None, dtype=None):
+    """
+    Computes :code:`activation(a[z] @ b[z])` for every :code:`z`, where :code:`a` is of shape (Z, M, K)
+    and :code:`b` of shape (Z, K, N). Inputs may be arbitrarily strided, e.g., views of attention heads.
+
+    :param activation: one of :code:`None`, :code:`'relu'` or :code:`'gelu'` (tanh approximation).
+    :param dtype: data-type of the output; defaults to that of :code:`a`.
+    """
+    # checks constraints
+    assert a.dim() == 3 and b.dim() == 3, "a and b must be 3D tensors"
+    assert a.shape[0] == b.shape[0] and a.shape[2] == b.shape[1], "incompatible dimensions"
+    assert activation in [None, 'relu', 'gelu'], f"unsupported activation {activation}"
+    # handle non-contiguous inputs if necessary
+    if a.stride(1) > 1 and a.stride(2) > 1:
+        a = a.contiguous()
+    if b.stride(1) > 1 and b.stride(2) > 1:
+        b = b.contiguous()
+    Z, M, K = a.shape
+    _, _, N = b.shape
+    # allocates output
+    c = torch.empty((Z, M, N), device=a.device, dtype=a.dtype if dtype is None else dtype)
+    # launch kernel
+    grid = lambda META: (triton.cdiv(M, META['BLOCK_M']) * triton.cdiv(N, META['BLOCK_N']), Z)
+    _batched_kernel[grid](a, b, c, M, N, K,
+                          a.stride(0), a.stride(1), a.stride(2),
+                          b.stride(0), b.stride(1), b.stride(2),
+                          c.stride(0), c.stride(1), c.stride(2),
+                          GROUP_M=8, HAS_BIAS=False, ACTIVATION=activation, HAS_RESIDUAL=False)
+    return c
@@ -0,0 +1,252 @@
+import torch
+import triton
+import triton.language as tl
+
+# ********************************************************
+# --------------------------------------------------------
+# Layer normalization and RMS normalization over the last
+# dimension. Rows are walked in chunks of BLOCK elements,
+# so that any row size is supported.
+# --------------------------------------------------------
+# ********************************************************
+
+
+def next_power_of_2(n):
+    return 1 << (n - 1).bit_length()
+
+
+_configs = [
+    triton.Config({'BLOCK': 512}, num_warps=2),
+    triton.Config({'BLOCK': 512}, num_warps=4),
+    triton.Config({'BLOCK': 1024}, num_warps=4),
+    triton.Config({'BLOCK': 1024}, num_warps=8),
+    triton.Config({'BLOCK': 2048}, num_warps=8),
+    triton.Config({'BLOCK': 4096}, num_warps=8),
+    triton.Config({'BLOCK': 4096}, num_warps=16),
+]
+
+
+def _prune_configs(configs, named_args):
+    # blocks larger than the row only add masked-out lanes
+    block = max(next_power_of_2(named_args['N']), min(c.meta['BLOCK'] for c in configs))
+    return [c for c in configs if c.meta['BLOCK'] <= block]
+
+
+@triton.autotune(configs=_configs, key=['N'], prune_configs_by=_prune_configs)
+@triton.jit
+def _fwd_kernel(X, Y, W, B, Mean, Rstd, stride_x, stride_y, N, eps, **META):
+    BLOCK = META['BLOCK']
+    row = tl.program_id(0)
+    X = X + row * stride_x
+    Y = Y + row * stride_y
+    cols = tl.arange(0, BLOCK)
+    # statistics, in a single pass over the row
+    if META['IS_RMS']:
+        _sq = tl.zeros((BLOCK, ), dtype=tl.float32)
+        for off in range(0, N, BLOCK):
+            x = tl.load(X + off + cols, mask=off + cols < N, other=0.).to(tl.float32)
+            _sq += x * x
+        mean = 0.
+        var = tl.sum(_sq, 0) / N
+    else:
+        # E[x^2] - E[x]^2 cancels catastrophically when |mean| >> std:
+        # every lane keeps a running mean and sum of squared deviations
+        # (Welford), and lanes are combined once at the end
+        _count = tl.zeros((BLOCK, ), dtype=tl.float32)
+        _mean = tl.zeros((BLOCK, ), dtype=tl.float32)
+        _m2 = tl.zeros((BLOCK, ), dtype=tl.float32)
+        for off in range(0, N, BLOCK):
+            mask = off + cols < N
+            x = tl.load(X + off + cols, mask=mask, other=0.).to(tl.float32)
+            _count += mask.to(tl.float32)
+            delta = tl.where(mask, x - _mean, 0.)
+            _mean += tl.where(mask, delta / _count, 0.)
+            _m2 += delta * (x - _mean)
+        mean = tl.sum(_count * _mean, 0) / N
+        dev = tl.where(_count > 0, _mean - mean, 0.)
+        var = (tl.sum(_m2, 0) + tl.sum(_count * dev * dev, 0)) / N
+        var = tl.maximum(var, 0.)
+    rstd = 1 / tl.sqrt(var + eps)
+    if META['SAVE_STATS']:
+        tl.store(Mean + row, mean)
+        tl.store(Rstd + row, rstd)
+    # normalize and apply the affine transform
+    for off in range(0, N, BLOCK):
+        mask = off + cols < N
+        x = tl.load(X + off + cols, mask=mask, other=0.).to(tl.float32)
+        w = tl.load(W + off + cols, mask=mask, other=0.).to(tl.float32)
+        y = (x - mean) * rstd * w
+        if META['HAS_BIAS']:
+            y += tl.load(B + off + cols, mask=mask, other=0.).to(tl.float32)
+        tl.store(Y + off + cols, y, mask=mask)
+
+
+@triton.heuristics({'SINGLE_CHUNK': lambda *args, **meta: args[12] <= meta['BLOCK']})
+@triton.autotune(configs=_configs, key=['N'], prune_configs_by=_prune_configs, reset_to_zero=['DW', 'DB'])
+@triton.jit
+def _bwd_dx_kernel(DX, DY, DW, DB, X, W, Mean, Rstd, stride_x, stride_dy, stride_dx, M, N, **META):
+    # first stage of the backward pass: each program computes dX for rows
+    # pid, pid + num_programs, ... and sums their contributions to dW and dB
+    # into its own row of DW and DB, so that no atomics are needed
+    BLOCK = META['BLOCK']
+    pid = tl.program_id(0)
+    num_pids = tl.num_programs(0)
+    cols = tl.arange(0, BLOCK)
+    DW = DW + pid * N
+    DB = DB + pid * N
+    row = pid
+    if META['SINGLE_CHUNK']:
+        # partial sums are kept in registers
+        mask = cols < N
+        w = tl.load(W + cols, mask=mask, other=0.).to(tl.float32)
+        dw = tl.zeros((BLOCK, ), dtype=tl.float32)
+        db = tl.zeros((BLOCK, ), dtype=tl.float32)
+        while row < M:
+            mean = tl.load(Mean + row)
+            rstd = tl.load(Rstd + row)
+            x = tl.load(X + row * stride_x + cols, mask=mask, other=0.).to(tl.float32)
+            dy = tl.load(DY + row * stride_dy + cols, mask=mask, other=0.).to(tl.float32)
+            xhat = tl.where(mask, (x - mean) * rstd, 0.)
+            wdy = w * dy
+            c1 = tl.sum(xhat * wdy, 0) / N
+            if META['IS_RMS']:
+                dx = (wdy - xhat * c1) * rstd
+            else:
+                c2 = tl.sum(wdy, 0) / N
+                dx = (wdy - (xhat * c1 + c2)) * rstd
+            tl.store(DX + row * stride_dx + cols, dx, mask=mask)
+            dw += dy * xhat
+            db += dy
+            row += num_pids
+        tl.store(DW + cols, dw, mask=mask)
+        if META['HAS_BIAS']:
+            tl.store(DB + cols, db, mask=mask)
+    else:
+        while row < M:
+            mean = tl.load(Mean + row)
+            rstd = tl.load(Rstd + row)
+            # row-wise reductions
+            _c1 = tl.zeros((BLOCK, ), dtype=tl.float32)
+            _c2 = tl.zeros((BLOCK, ), dtype=tl.float32)
+            for off in range(0, N, BLOCK):
+                mask = off + cols < N
+                x = tl.load(X + row * stride_x + off + cols, mask=mask, other=0.).to(tl.float32)
+                dy = tl.load(DY + row * stride_dy + off + cols, mask=mask, other=0.).to(tl.float32)
+                w = tl.load(W + off + cols, mask=mask, other=0.).to(tl.float32)
+                wdy = w * dy
+                _c1 += (x - mean) * rstd * wdy
+                _c2 += wdy
+            c1 = tl.sum(_c1, 0) / N
+            c2 = tl.sum(_c2, 0) / N
+            # gradients; partial sums are kept in memory
+            for off in range(0, N, BLOCK):
+                mask = off + cols < N
+                x = tl.load(X + row * stride_x + off + cols, mask=mask, other=0.).to(tl.float32)
+                dy = tl.load(DY + row * stride_dy + off + cols, mask=mask, other=0.).to(tl.float32)
+                w = tl.load(W + off + cols, mask=mask, other=0.).to(tl.float32)
+                xhat = (x - mean) * rstd
+                wdy = w * dy
+                if META['IS_RMS']:
+                    dx = (wdy - xhat * c1) * rstd
+                else:
+                    dx = (wdy - (xhat * c1 + c2)) * rstd
+                tl.store(DX + row * stride_dx + off + cols, dx, mask=mask)
+                dw = tl.load(DW + off + cols, mask=mask, other=0.)
+                tl.store(DW + off + cols, dw + dy * xhat, mask=mask)
+                if META['HAS_BIAS']:
+                    db = tl.load(DB + off + cols, mask=mask, other=0.)
+                    tl.store(DB + off + cols, db + dy, mask=mask)
+            row += num_pids
+
+
+@triton.jit
+def _bwd_dwdb_kernel(DW, DB, FINAL_DW, FINAL_DB, G, N, **META):
+    # second stage of the backward pass: sums the G partial rows of DW and DB
+    BLOCK_M = META['BLOCK_M']
+    BLOCK_N = META['BLOCK_N']
+    cols = tl.program_id(0) * BLOCK_N + tl.arange(0, BLOCK_N)
+    dw = tl.zeros((BLOCK_M, BLOCK_N), dtype=tl.float32)
+    db = tl.zeros((BLOCK_M, BLOCK_N), dtype=tl.float32)
+    for i in range(0, G, BLOCK_M):
+        rows = i + tl.arange(0, BLOCK_M)
+        mask = (rows[:, None] < G) & (cols[None, :] < N)
+        offs = rows[:, None] * N + cols[None, :]
+        dw += tl.load(DW + offs, mask=mask, other=0.)
+        if META['HAS_BIAS']:
+            db += tl.load(DB + offs, mask=mask, other=0.)
+    tl.store(FINAL_DW + cols, tl.sum(dw, 0), mask=cols < N)
+    if META['HAS_BIAS']:
+        tl.store(FINAL_DB + cols, tl.sum(db, 0), mask=cols < N)
+
+
+class _layer_norm(torch.autograd.Function):
+    @staticmethod
+    def forward(ctx, x, weight, bias, eps, dtype, is_rms):
+        # checks constraints
+        N = x.shape[-1]
+        assert weight.shape == (N, ), "weight must be a vector of the size of the last dimension"
+        assert bias is None or bias.shape == (N, ), "bias must be a vector of the size of the last dimension"
+        shape = x.shape
+        x = x.reshape(-1, N)
+        if x.stride(-1) != 1:
+            x = x.contiguous()
+        M = x.shape[0]
+        # allocates output and statistics
+        y = torch.empty((M, N), device=x.device, dtype=x.dtype if dtype is None else dtype)
+        mean = torch.empty((M, ), device=x.device, dtype=torch.float32)
+        rstd = torch.empty((M, ), device=x.device, dtype=torch.float32)
+        save_stats = any(ctx.needs_input_grad[:3])
+        if M > 0:
+            _fwd_kernel[(M, )](x, y, weight, weight if bias is None else bias, mean, rstd,
+                               x.stride(0), y.stride(0), N, float(eps),
+                               IS_RMS=is_rms, HAS_BIAS=bias is not None, SAVE_STATS=save_stats)
+        if save_stats:
+            ctx.save_for_backward(x, weight, mean, rstd)
+        ctx.is_rms = is_rms
+        ctx.has_bias = bias is not None
+        ctx.shape = shape
+        return y.reshape(shape)
+
+    @staticmethod
+    def backward(ctx, dy):
+        x, weight, mean, rstd = ctx.saved_tensors
+        M, N = x.shape
+        dy = dy.reshape(-1, N)
+        if dy.stride(-1) != 1:
+            dy = dy.contiguous()
+        dx = torch.empty((M, N), device=x.device, dtype=x.dtype)
+        if M == 0:
+            dw = torch.zeros((N, ), device=x.device, dtype=weight.dtype)
+            db = torch.zeros((N, ), device=x.device, dtype=weight.dtype) if ctx.has_bias else None
+            return dx.reshape(ctx.shape), dw, db, None, None, None
+        # a few rows per program, so that the partial sums of dW and dB stay small
+        G = min(M, 4 * torch.cuda.get_device_properties(x.device).multi_processor_count)
+        _dw = torch.zeros((G, N), device=x.device, dtype=torch.float32)
+        _db = torch.zeros((G, N), device=x.device, dtype=torch.float32) if ctx.has_bias else _dw
+        _bwd_dx_kernel[(G, )](dx, dy, _dw, _db, x, weight, mean, rstd,
+                              x.stride(0), dy.stride(0), dx.stride(0), M, N,
+                              IS_RMS=ctx.is_rms, HAS_BIAS=ctx.has_bias)
+        dw = torch.empty((N, ), device=x.device, dtype=weight.dtype)
+        db = torch.empty((N, ), device=x.device, dtype=weight.dtype) if ctx.has_bias else None
+        grid = lambda META: (triton.cdiv(N, META['BLOCK_N']), )
+        _bwd_dwdb_kernel[grid](_dw, _db, dw, dw if db is None else db, G, N,
+                               BLOCK_M=32, BLOCK_N=128, HAS_BIAS=ctx.has_bias)
+        return dx.reshape(ctx.shape), dw, db, None, None, None
+
+
+def layer_norm(x, weight, bias=None, eps=1e-5, dtype=None):
+    """
+    Normalizes :code:`x` over its last dimension, then scales by :code:`weight` and shifts by :code:`bias`, if any.
+
+    :param dtype: data-type of the output; defaults to that of :code:`x`.
+    """
+    return _layer_norm.apply(x, weight, bias, eps, dtype, False)
+
+
+def rms_norm(x, weight, eps=1e-6, dtype=None):
+    """
+    Divides :code:`x` by the root mean square of its last dimension, then scales by :code:`weight`.
+
+    :param dtype: data-type of the output; defaults to that of :code:`x`.
+    """
+    return _layer_norm.apply(x, weight, None, eps, dtype, True)
@@ -3,58 +3,59 @@ import triton.language as tl
 import triton
 
 
-@triton.heuristics({
-    'EVEN_K': lambda *args, **meta: args[5] % (meta['BLOCK_K'] * meta['SPLIT_K']) == 0,
-})
-@triton.autotune(
-    configs=[
-        triton.Config({'BLOCK_M': 128, 'BLOCK_N': 256, 'BLOCK_K': 32, 'SPLIT_K': 1}, num_stages=3, num_warps=8),
-        triton.Config({'BLOCK_M': 256, 'BLOCK_N': 128, 'BLOCK_K': 32, 'SPLIT_K': 1}, num_stages=3, num_warps=8),
-        triton.Config({'BLOCK_M': 256, 'BLOCK_N': 64,  'BLOCK_K': 32, 'SPLIT_K': 1}, num_stages=4, num_warps=4),
-        triton.Config({'BLOCK_M': 64 , 'BLOCK_N': 256, 'BLOCK_K': 32, 'SPLIT_K': 1}, num_stages=4, num_warps=4),
-        triton.Config({'BLOCK_M': 128, 'BLOCK_N': 128, 'BLOCK_K': 32, 'SPLIT_K': 1}, num_stages=4, num_warps=4),
-        triton.Config({'BLOCK_M': 128, 'BLOCK_N': 64 , 'BLOCK_K': 32, 'SPLIT_K': 1}, num_stages=4, num_warps=4),
-        triton.Config({'BLOCK_M': 64 , 'BLOCK_N': 128, 'BLOCK_K': 32, 'SPLIT_K': 1}, num_stages=4, num_warps=4),
-        triton.Config({'BLOCK_M': 128, 'BLOCK_N': 32 , 'BLOCK_K': 32, 'SPLIT_K': 1}, num_stages=4, num_warps=4),
-        triton.Config({'BLOCK_M': 64 , 'BLOCK_N': 32 , 'BLOCK_K': 32, 'SPLIT_K': 1}, num_stages=5, num_warps=2),
-        triton.Config({'BLOCK_M': 32 , 'BLOCK_N': 64 , 'BLOCK_K': 32, 'SPLIT_K': 1}, num_stages=5, num_warps=2),
-    ],
-    key=['M', 'N', 'K'],
-)
+def _num_sms(device):
+    return torch.cuda.get_device_properties(device).multi_processor_count
+
+
+def _is_skinny(M, N, device):
+    # 128x128 tiles do not fill the GPU: data-parallel configs
+    # leave SMs idle and the K dimension has to be split instead
+    return triton.cdiv(M, 128) * triton.cdiv(N, 128) < _num_sms(device)
+
+
+def _prune_configs(configs, named_args):
+    M, N = named_args['M'], named_args['N']
+    if _is_skinny(M, N, named_args['A'].device):
+        return configs
+    return [c for c in configs if c.meta['SPLIT_K'] == 1 and not c.meta['STREAM_K']]
+
+
 @triton.jit
-def _kernel(A, B, C, M, N, K, 
-            stride_am, stride_ak, 
-            stride_bk, stride_bn, 
-            stride_cm, stride_cn, 
-            LOCKS, **META):
-    # extract meta-parameters
+def _tile_coords(tile_id, M, N, **META):
     BLOCK_M = META['BLOCK_M']
     BLOCK_N = META['BLOCK_N']
-    BLOCK_K = META['BLOCK_K']
     GROUP_M = META['GROUP_M']
-    SPLIT_K = META['SPLIT_K']
-    # matrix multiplication
-    pid = tl.program_id(0)
-    pid_z = tl.program_id(1)
     grid_m = (M + BLOCK_M - 1) // BLOCK_M
     grid_n = (N + BLOCK_N - 1) // BLOCK_N
     # re-order program ID for better L2 performance
     width = GROUP_M * grid_n
-    group_id = pid // width
+    group_id = tile_id // width
     group_size = min(grid_m - group_id * GROUP_M, GROUP_M)
-    pid_m = group_id * GROUP_M + (pid % group_size)
-    pid_n = (pid % width) // (group_size)
-    # do matrix multiplication
+    pid_m = group_id * GROUP_M + (tile_id % group_size)
+    pid_n = (tile_id % width) // (group_size)
+    return pid_m, pid_n
+
+
+@triton.jit
+def _mac_loop(A, B, M, N, K,
+              stride_am, stride_ak,
+              stride_bk, stride_bn,
+              pid_m, pid_n, k_lo, k_hi, STEP, **META):
+    # accumulates A[rm, k] * B[k, rn] for k in [k_lo, k_hi),
+    # visiting one out of every STEP blocks along K
+    BLOCK_M = META['BLOCK_M']
+    BLOCK_N = META['BLOCK_N']
+    BLOCK_K = META['BLOCK_K']
     rm = pid_m * BLOCK_M + tl.arange(0, BLOCK_M)
     rn = pid_n * BLOCK_N + tl.arange(0, BLOCK_N)
     ram = tl.max_contiguous(tl.multiple_of(rm % M, BLOCK_M), BLOCK_M)
     rbn = tl.max_contiguous(tl.multiple_of(rn % N, BLOCK_N), BLOCK_N)
-    rk = pid_z*BLOCK_K + tl.arange(0, BLOCK_K)
+    rk = tl.arange(0, BLOCK_K)
     # pointers
-    A = A + (ram[:, None] * stride_am + rk[None, :] * stride_ak)
-    B = B + (rk[:, None] * stride_bk + rbn[None, :] * stride_bn)
+    A = A + (ram[:, None] * stride_am + (k_lo + rk[None, :]) * stride_ak)
+    B = B + ((k_lo + rk[:, None]) * stride_bk + rbn[None, :] * stride_bn)
     acc = tl.zeros((BLOCK_M, BLOCK_N), dtype=tl.float32)
-    for k in range(K, 0, -BLOCK_K*SPLIT_K):
+    for k in range(K - k_lo, K - k_hi, -BLOCK_K*STEP):
         if META['EVEN_K']:
             a = tl.load(A)
             b = tl.load(B)
@@ -62,39 +63,190 @@ def _kernel(A, B, C, M, N, K,
             a = tl.load(A, mask=rk[None, :] < k, other=0.)
             b = tl.load(B, mask=rk[:, None] < k, other=0.)
         acc += tl.dot(a, b)
-        A += BLOCK_K * SPLIT_K * stride_ak
-        B += BLOCK_K * SPLIT_K * stride_bk
-    acc = acc.to(tl.float16)
-    # rematerialize rm and rn to save registers
+        A += BLOCK_K * STEP * stride_ak
+        B += BLOCK_K * STEP * stride_bk
+    return acc
+
+
+@triton.jit
+def _epilogue(acc, rm, rn, mask, BIAS, RESIDUAL, stride_rm, stride_rn, N, **META):
+    # element-wise operations fused into the write-back of C:
+    # bias, activation and residual, in that order
+    if META['HAS_BIAS']:
+        bias = tl.load(BIAS + rn, mask=rn < N, other=0.)
+        acc += bias[None, :].to(tl.float32)
+    if META['ACTIVATION'] == 'relu':
+        acc = tl.maximum(acc, 0.)
+    if META['ACTIVATION'] == 'gelu':
+        # tanh approximation, using 0.5 * (1 + tanh(x)) = sigmoid(2 * x)
+        acc = acc * tl.sigmoid(1.5957691216057308 * (acc + 0.044715 * acc * acc * acc))
+    if META['HAS_RESIDUAL']:
+        RESIDUAL = RESIDUAL + (rm[:, None] * stride_rm + rn[None, :] * stride_rn)
+        acc += tl.load(RESIDUAL, mask=mask, other=0.).to(tl.float32)
+    return acc
+
+
+@triton.jit
+def _write_back(C, LOCKS, WORKSPACE, BIAS, RESIDUAL, acc, tile_id, pid_m, pid_n, turn, num_turns,
+                M, N, stride_cm, stride_cn, stride_rm, stride_rn, **META):
+    # writes the contribution of the `turn`-th out of `num_turns` programs
+    # to the tile. contributions are summed in order of `turn`, so that
+    # the result does not depend on the order in which programs finish
+    BLOCK_M = META['BLOCK_M']
+    BLOCK_N = META['BLOCK_N']
     rm = pid_m * BLOCK_M + tl.arange(0, BLOCK_M)
     rn = pid_n * BLOCK_N + tl.arange(0, BLOCK_N)
     C = C + (rm[:, None] * stride_cm + rn[None, :] * stride_cn)
     mask = (rm < M)[:, None] & (rn < N)[None, :]
-    # handles write-back with reduction-splitting
-    if SPLIT_K == 1:
+    if num_turns == 1:
+        acc = _epilogue(acc, rm, rn, mask, BIAS, RESIDUAL, stride_rm, stride_rn, N)
         tl.store(C, acc, mask=mask)
     else:
-        LOCKS = LOCKS + tl.program_id(0)
-        COUNT = LOCKS + tl.num_programs(0)
-        while tl.atomic_cas(LOCKS, 0, 1) == 1:
+        # partial sums are kept in fp32 when a workspace is available
+        W = WORKSPACE + (rm[:, None] * N + rn[None, :])
+        LOCK = LOCKS + tile_id
+        while tl.atomic_cas(LOCK, turn, -1) != turn:
             pass
-        count = tl.load(COUNT)
-        if count == 0:
+        if turn > 0:
+            if META['HAS_WORKSPACE']:
+                acc += tl.load(W, mask=mask, other=0., cache_modifier='.cg')
+            else:
+                acc += tl.load(C, mask=mask, other=0., cache_modifier='.cg').to(tl.float32)
+        if turn == num_turns - 1:
+            acc = _epilogue(acc, rm, rn, mask, BIAS, RESIDUAL, stride_rm, stride_rn, N)
             tl.store(C, acc, mask=mask)
         else:
-            curr = tl.load(C, mask=mask, other=0.)
-            tl.store(C, acc + curr, mask=mask)
-        tl.atomic_xchg(COUNT, (count + 1) % SPLIT_K)
-        tl.atomic_xchg(LOCKS, 0)
+            if META['HAS_WORKSPACE']:
+                tl.store(W, acc, mask=mask)
+            else:
+                tl.store(C, acc, mask=mask)
+        # hand the tile over to the next program; the last one
+        # leaves the lock in its initial state for the next launch
+        tl.atomic_xchg(LOCK, (turn + 1) % num_turns)
+
+
+@triton.jit
+def _stream_k_write_back(C, FLAGS, WORKSPACE, BIAS, RESIDUAL, acc, pid_m, pid_n, pid, first, num_turns,
+                         M, N, stride_cm, stride_cn, stride_rm, stride_rn, **META):
+    # writes the contribution of program `pid` to a tile shared by programs
+    # [first, first + num_turns). only its first program, which owns the
+    # tile, waits: the others reach the tile in their first segment, store
+    # their partial sum to their slot of the workspace and raise their flag.
+    # the owner adds partial sums in order of program id, so that the result
+    # does not depend on the order in which programs finish
+    BLOCK_M = META['BLOCK_M']
+    BLOCK_N = META['BLOCK_N']
+    rm = pid_m * BLOCK_M + tl.arange(0, BLOCK_M)
+    rn = pid_n * BLOCK_N + tl.arange(0, BLOCK_N)
+    rt = tl.arange(0, BLOCK_M)[:, None] * BLOCK_N + tl.arange(0, BLOCK_N)[None, :]
+    mask = (rm < M)[:, None] & (rn < N)[None, :]
+    if pid == first:
+        t = 1
+        while t < num_turns:
+            # flags are left in their initial state for the next launch
+            while tl.atomic_cas(FLAGS + first + t, 1, 0) != 1:
+                pass
+            acc += tl.load(WORKSPACE + (first + t) * (BLOCK_M * BLOCK_N) + rt, cache_modifier='.cg')
+            t += 1
+        acc = _epilogue(acc, rm, rn, mask, BIAS, RESIDUAL, stride_rm, stride_rn, N)
+        tl.store(C + (rm[:, None] * stride_cm + rn[None, :] * stride_cn), acc, mask=mask)
+    else:
+        tl.store(WORKSPACE + pid * (BLOCK_M * BLOCK_N) + rt, acc)
+        tl.atomic_xchg(FLAGS + pid, 1)
+
+
+@triton.heuristics({
+    'EVEN_K': lambda *args, **meta: args[5] % (meta['BLOCK_K'] * meta['SPLIT_K']) == 0,
+    'HAS_WORKSPACE': lambda *args, **meta: args[13].numel() >= args[3] * args[4],
+})
+@triton.autotune(
+    configs=[
+        triton.Config({'BLOCK_M': 128, 'BLOCK_N': 256, 'BLOCK_K': 32, 'SPLIT_K': 1, 'STREAM_K': 0}, num_stages=3, num_warps=8),
+        triton.Config({'BLOCK_M': 256, 'BLOCK_N': 128, 'BLOCK_K': 32, 'SPLIT_K': 1, 'STREAM_K': 0}, num_stages=3, num_warps=8),
+        triton.Config({'BLOCK_M': 256, 'BLOCK_N': 64,  'BLOCK_K': 32, 'SPLIT_K': 1, 'STREAM_K': 0}, num_stages=4, num_warps=4),
+        triton.Config({'BLOCK_M': 64 , 'BLOCK_N': 256, 'BLOCK_K': 32, 'SPLIT_K': 1, 'STREAM_K': 0}, num_stages=4, num_warps=4),
+        triton.Config({'BLOCK_M': 128, 'BLOCK_N': 128, 'BLOCK_K': 32, 'SPLIT_K': 1, 'STREAM_K': 0}, num_stages=4, num_warps=4),
+        triton.Config({'BLOCK_M': 128, 'BLOCK_N': 64 , 'BLOCK_K': 32, 'SPLIT_K': 1, 'STREAM_K': 0}, num_stages=4, num_warps=4),
+        triton.Config({'BLOCK_M': 64 , 'BLOCK_N': 128, 'BLOCK_K': 32, 'SPLIT_K': 1, 'STREAM_K': 0}, num_stages=4, num_warps=4),
+        triton.Config({'BLOCK_M': 128, 'BLOCK_N': 32 , 'BLOCK_K': 32, 'SPLIT_K': 1, 'STREAM_K': 0}, num_stages=4, num_warps=4),
+        triton.Config({'BLOCK_M': 64 , 'BLOCK_N': 32 , 'BLOCK_K': 32, 'SPLIT_K': 1, 'STREAM_K': 0}, num_stages=5, num_warps=2),
+        triton.Config({'BLOCK_M': 32 , 'BLOCK_N': 64 , 'BLOCK_K': 32, 'SPLIT_K': 1, 'STREAM_K': 0}, num_stages=5, num_warps=2),
+        # skinny problems: split the reduction across programs
+        triton.Config({'BLOCK_M': 32 , 'BLOCK_N': 64 , 'BLOCK_K': 64, 'SPLIT_K': 4, 'STREAM_K': 0}, num_stages=4, num_warps=2),
+        triton.Config({'BLOCK_M': 32 , 'BLOCK_N': 64 , 'BLOCK_K': 64, 'SPLIT_K': 16, 'STREAM_K': 0}, num_stages=4, num_warps=2),
+        triton.Config({'BLOCK_M': 64 , 'BLOCK_N': 64 , 'BLOCK_K': 32, 'SPLIT_K': 8, 'STREAM_K': 0}, num_stages=4, num_warps=4),
+        triton.Config({'BLOCK_M': 32 , 'BLOCK_N': 64 , 'BLOCK_K': 64, 'SPLIT_K': 1, 'STREAM_K': 1}, num_stages=4, num_warps=2),
+        triton.Config({'BLOCK_M': 64 , 'BLOCK_N': 64 , 'BLOCK_K': 32, 'SPLIT_K': 1, 'STREAM_K': 1}, num_stages=4, num_warps=4),
+    ],
+    key=['M', 'N', 'K'],
+    prune_configs_by=_prune_configs,
+)
+@triton.jit
+def _kernel(A, B, C, M, N, K, 
+            stride_am, stride_ak, 
+            stride_bk, stride_bn, 
+            stride_cm, stride_cn, 
+            LOCKS, WORKSPACE,
+            BIAS, RESIDUAL,
+            stride_rm, stride_rn, **META):
+    # extract meta-parameters
+    BLOCK_M = META['BLOCK_M']
+    BLOCK_N = META['BLOCK_N']
+    BLOCK_K = META['BLOCK_K']
+    SPLIT_K = META['SPLIT_K']
+    if META['STREAM_K']:
+        # every program gets the same number of MAC iterations, where
+        # iterations are enumerated tile by tile; a tile whose iterations
+        # span several programs is fixed up by `_stream_k_write_back`
+        pid = tl.program_id(0)
+        num_pids = tl.num_programs(0)
+        grid_m = (M + BLOCK_M - 1) // BLOCK_M
+        grid_n = (N + BLOCK_N - 1) // BLOCK_N
+        iters_per_tile = (K + BLOCK_K - 1) // BLOCK_K
+        total = grid_m * grid_n * iters_per_tile
+        iters_per_pid = (total + num_pids - 1) // num_pids
+        it = pid * iters_per_pid
+        end = min(it + iters_per_pid, total)
+        while it < end:
+            tile_id = it // iters_per_tile
+            tile_start = tile_id * iters_per_tile
+            tile_end = tile_start + iters_per_tile
+            seg_end = min(tile_end, end)
+            pid_m, pid_n = _tile_coords(tile_id, M, N)
+            acc = _mac_loop(A, B, M, N, K,
+                            stride_am, stride_ak,
+                            stride_bk, stride_bn,
+                            pid_m, pid_n, (it - tile_start) * BLOCK_K, (seg_end - tile_start) * BLOCK_K, 1)
+            # programs that share this tile, in order of their k range
+            first = tile_start // iters_per_pid
+            last = (tile_end - 1) // iters_per_pid
+            _stream_k_write_back(C, LOCKS, WORKSPACE, BIAS, RESIDUAL, acc, pid_m, pid_n, pid, first, last - first + 1,
+                                 M, N, stride_cm, stride_cn, stride_rm, stride_rn)
+            it = seg_end
+    else:
+        # matrix multiplication
+        pid = tl.program_id(0)
+        pid_z = tl.program_id(1)
+        pid_m, pid_n = _tile_coords(pid, M, N)
+        acc = _mac_loop(A, B, M, N, K,
+                        stride_am, stride_ak,
+                        stride_bk, stride_bn,
+                        pid_m, pid_n, pid_z * BLOCK_K, K, SPLIT_K)
+        # handles write-back with reduction-splitting
+        _write_back(C, LOCKS, WORKSPACE, BIAS, RESIDUAL, acc, pid, pid_m, pid_n, pid_z, SPLIT_K,
+                    M, N, stride_cm, stride_cn, stride_rm, stride_rn)
 
 
 class _matmul(torch.autograd.Function):
     kernel = _kernel
 
     _locks = dict()
+    _workspaces = dict()
+
+    _activations = [None, 'relu', 'gelu']
 
     @staticmethod
-    def _call(a, b):
+    def _call(a, b, bias, activation, residual, dtype):
         device = a.device
         # handle non-contiguous inputs if necessary
         if a.stride(0) > 1 and a.stride(1) > 1:
@@ -105,27 +257,55 @@ class _matmul(torch.autograd.Function):
         assert a.shape[1] == b.shape[0], "incompatible dimensions"
         M, K = a.shape
         _, N = b.shape
+        assert activation in _matmul._activations, f"unsupported activation {activation}"
+        assert bias is None or bias.shape == (N, ), "bias must be a vector of size N"
+        assert residual is None or residual.shape == (M, N), "residual must be of shape (M, N)"
         # allocates output
-        c = torch.empty((M, N), device=device, dtype=a.dtype)
+        c = torch.empty((M, N), device=device, dtype=a.dtype if dtype is None else dtype)
         # allocate locks for split-k
         if a.device not in _matmul._locks:
             _matmul._locks[device] = torch.zeros(1024 * 1024, dtype=torch.int32, device=device)
         locks = _matmul._locks[device]
+        # allocate a fp32 workspace for partial sums when split-k
+        # configs may be selected; stream-k always keeps one partial
+        # tile of at most 64x64 elements per program
+        numel = max(M * N if _is_skinny(M, N, device) else 1, _num_sms(device) * 64 * 64)
+        if device not in _matmul._workspaces or _matmul._workspaces[device].numel() < numel:
+            _matmul._workspaces[device] = torch.empty(numel, dtype=torch.float32, device=device)
+        workspace = _matmul._workspaces[device]
         # launch kernel
-        grid = lambda META: (triton.cdiv(M, META['BLOCK_M']) * triton.cdiv(N, META['BLOCK_N']), META['SPLIT_K'])
+        def grid(META):
+            if META['STREAM_K']:
+                return (_num_sms(device), )
+            return (triton.cdiv(M, META['BLOCK_M']) * triton.cdiv(N, META['BLOCK_N']), META['SPLIT_K'])
         _kernel[grid](a, b, c, 
                       M, N, K, 
                       a.stride(0), a.stride(1), 
                       b.stride(0), b.stride(1), 
                       c.stride(0), c.stride(1), 
-                      locks, 
-                      GROUP_M=8)
+                      locks, workspace, 
+                      c if bias is None else bias, 
+                      c if residual is None else residual, 
+                      *(c.stride() if residual is None else residual.stride()), 
+                      GROUP_M=8, 
+                      HAS_BIAS=bias is not None, 
+                      ACTIVATION=activation, 
+                      HAS_RESIDUAL=residual is not None)
         # done
         return c
 
     @staticmethod
-    def forward(ctx, a, b):
-        return _matmul._call(a, b)
+    def forward(ctx, a, b, bias, activation, residual, dtype):
+        return _matmul._call(a, b, bias, activation, residual, dtype)
+
 
+def matmul(a, b, bias=None, activation=None, residual=None, dtype=None):
+    """
+    Computes :code:`activation(a @ b + bias) + residual`, in a single pass over the output.
 
-matmul = _matmul.apply
+    :param bias: optional vector of size N added to every row of the product.
+    :param activation: one of :code:`None`, :code:`'relu'` or :code:`'gelu'` (tanh approximation).
+    :param residual: optional (M, N) tensor added after the activation.
+    :param dtype: data-type of the output; defaults to that of :code:`a`.
+    """
+    return _matmul.apply(a, b, bias, activation, residual, dtype)
@@ -0,0 +1,171 @@
+import torch
+import triton
+import triton.language as tl
+from .matmul import _tile_coords, _epilogue
+
+# ********************************************************
+# --------------------------------------------------------
+# Matrix multiplication with weights quantized to int8 or
+# int4, with one fp16 scale per output channel and group
+# of rows of the weight matrix. Weights are dequantized in
+# registers, right before being fed to tl.dot, so that they
+# are only read once from DRAM, in their compact form.
+#
+# int4 weights of a (K, N) matrix are packed two per byte,
+# as a (K / 2, N) matrix: the low nibble of row j holds row
+# j and the high nibble holds row j + K / 2, both biased by
+# 8. This keeps the two halves of each tile contiguous.
+# --------------------------------------------------------
+# ********************************************************
+
+
+def _prune_configs(configs, named_args):
+    # tiles must neither straddle two groups nor run past K
+    K, group_size = named_args['K'], named_args['GROUP_SIZE']
+    return [c for c in configs if K % (2 * c.meta['BLOCK_K']) == 0 and group_size % c.meta['BLOCK_K'] == 0]
+
+
+@triton.autotune(
+    configs=[
+        # small batches: weight loads dominate
+        triton.Config({'BLOCK_M': 16 , 'BLOCK_N': 64 , 'BLOCK_K': 64}, num_stages=4, num_warps=2),
+        triton.Config({'BLOCK_M': 16 , 'BLOCK_N': 128, 'BLOCK_K': 64}, num_stages=4, num_warps=4),
+        triton.Config({'BLOCK_M': 32 , 'BLOCK_N': 64 , 'BLOCK_K': 64}, num_stages=4, num_warps=4),
+        triton.Config({'BLOCK_M': 32 , 'BLOCK_N': 128, 'BLOCK_K': 32}, num_stages=4, num_warps=4),
+        # large batches
+        triton.Config({'BLOCK_M': 64 , 'BLOCK_N': 64 , 'BLOCK_K': 32}, num_stages=4, num_warps=4),
+        triton.Config({'BLOCK_M': 128, 'BLOCK_N': 64 , 'BLOCK_K': 32}, num_stages=4, num_warps=4),
+        triton.Config({'BLOCK_M': 64 , 'BLOCK_N': 128, 'BLOCK_K': 32}, num_stages=4, num_warps=4),
+        triton.Config({'BLOCK_M': 128, 'BLOCK_N': 128, 'BLOCK_K': 32}, num_stages=3, num_warps=8),
+    ],
+    key=['M', 'N', 'K'],
+    prune_configs_by=_prune_configs,
+)
+@triton.jit
+def _kernel(A, B, SCALES, C, BIAS, M, N, K,
+            stride_am, stride_ak,
+            stride_bk, stride_bn,
+            stride_sg, stride_cm, stride_cn, GROUP_SIZE, **META):
+    BLOCK_M = META['BLOCK_M']
+    BLOCK_N = META['BLOCK_N']
+    BLOCK_K = META['BLOCK_K']
+    pid_m, pid_n = _tile_coords(tl.program_id(0), M, N)
+    rm = pid_m * BLOCK_M + tl.arange(0, BLOCK_M)
+    rn = pid_n * BLOCK_N + tl.arange(0, BLOCK_N)
+    ram = tl.max_contiguous(tl.multiple_of(rm % M, BLOCK_M), BLOCK_M)
+    rbn = tl.max_contiguous(tl.multiple_of(rn % N, BLOCK_N), BLOCK_N)
+    rk = tl.arange(0, BLOCK_K)
+    A = A + (ram[:, None] * stride_am + rk[None, :] * stride_ak)
+    B = B + (rk[:, None] * stride_bk + rbn[None, :] * stride_bn)
+    S = SCALES + rbn
+    acc = tl.zeros((BLOCK_M, BLOCK_N), dtype=tl.float32)
+    if META['BITS'] == 8:
+        for k in range(0, K, BLOCK_K):
+            a = tl.load(A)
+            q = tl.load(B)
+            scale = tl.load(S + (k // GROUP_SIZE) * stride_sg)
+            acc += tl.dot(a, q.to(tl.float16) * scale[None, :])
+            A += BLOCK_K * stride_ak
+            B += BLOCK_K * stride_bk
+    else:
+        # every packed row contributes to both halves of the reduction
+        HALF = K // 2
+        A_HI = A + HALF * stride_ak
+        for k in range(0, HALF, BLOCK_K):
+            a_lo = tl.load(A)
+            a_hi = tl.load(A_HI)
+            q = tl.load(B)
+            scale_lo = tl.load(S + (k // GROUP_SIZE) * stride_sg)
+            scale_hi = tl.load(S + ((k + HALF) // GROUP_SIZE) * stride_sg)
+            lo = ((q & 15) - 8).to(tl.int8)
+            hi = (((q >> 4) & 15) - 8).to(tl.int8)
+            acc += tl.dot(a_lo, lo.to(tl.float16) * scale_lo[None, :])
+            acc += tl.dot(a_hi, hi.to(tl.float16) * scale_hi[None, :])
+            A += BLOCK_K * stride_ak
+            A_HI += BLOCK_K * stride_ak
+            B += BLOCK_K * stride_bk
+    # write-back
+    mask = (rm < M)[:, None] & (rn < N)[None, :]
+    acc = _epilogue(acc, rm, rn, mask, BIAS, C, stride_cm, stride_cn, N)
+    tl.store(C + (rm[:, None] * stride_cm + rn[None, :] * stride_cn), acc, mask=mask)
+
+
+def quantize(w, bits=8, group_size=None):
+    """
+    Quantizes a (K, N) weight matrix symmetrically, with one scale per column and group of
+    :code:`group_size` rows (a single group by default). Returns the quantized weights, in the
+    layout expected by :code:`quant_matmul`, and the (K / group_size, N) fp16 scales.
+    """
+    assert bits in [4, 8], "only int8 and int4 weights are supported"
+    K, N = w.shape
+    group_size = K if group_size is None else group_size
+    assert K % group_size == 0, "K must be a multiple of the group size"
+    qmax = 2**(bits - 1) - 1
+    groups = w.float().reshape(K // group_size, group_size, N)
+    scales = groups.abs().amax(dim=1).clamp(min=1e-8) / qmax
+    q = torch.round(groups / scales[:, None, :]).clamp(-qmax - 1, qmax).to(torch.int32).reshape(K, N)
+    scales = scales.to(torch.float16)
+    if bits == 8:
+        return q.to(torch.int8), scales
+    assert K % 2 == 0, "K must be even for int4 weights"
+    q = q + 8
+    packed = q[:K // 2] | (q[K // 2:] << 4)
+    return packed.to(torch.uint8).view(torch.int8), scales
+
+
+class _quant_matmul(torch.autograd.Function):
+    kernel = _kernel
+
+    _activations = [None, 'relu', 'gelu']
+
+    @staticmethod
+    def _call(a, b, scales, bits, bias, activation, dtype):
+        # handle non-contiguous inputs if necessary
+        if a.stride(0) > 1 and a.stride(1) > 1:
+            a = a.contiguous()
+        if b.stride(1) != 1:
+            b = b.contiguous()
+        # checks constraints
+        assert bits in [4, 8], "only int8 and int4 weights are supported"
+        assert a.dtype == torch.float16, "activations must be fp16"
+        assert b.dtype == torch.int8, "quantized weights must be stored as int8"
+        M, K = a.shape
+        N = b.shape[1]
+        assert b.shape[0] * (8 // bits) == K, "incompatible dimensions"
+        assert scales.dim() == 2 and scales.shape[1] == N and K % scales.shape[0] == 0, "invalid scales"
+        assert activation in _quant_matmul._activations, f"unsupported activation {activation}"
+        assert bias is None or bias.shape == (N, ), "bias must be a vector of size N"
+        group_size = K // scales.shape[0]
+        assert K % 64 == 0 and group_size % 32 == 0, "K and the group size must be multiples of 64 and 32"
+        scales = scales.to(torch.float16)
+        # allocates output
+        c = torch.empty((M, N), device=a.device, dtype=a.dtype if dtype is None else dtype)
+        # launch kernel
+        grid = lambda META: (triton.cdiv(M, META['BLOCK_M']) * triton.cdiv(N, META['BLOCK_N']), )
+        _kernel[grid](a, b, scales, c, c if bias is None else bias,
+                      M, N, K,
+                      a.stride(0), a.stride(1),
+                      b.stride(0), b.stride(1),
+                      scales.stride(0), c.stride(0), c.stride(1), group_size,
+                      GROUP_M=8,
+                      BITS=bits,
+                      HAS_BIAS=bias is not None,
+                      ACTIVATION=activation,
+                      HAS_RESIDUAL=False)
+        return c
+
+    @staticmethod
+    def forward(ctx, a, b, scales, bits, bias, activation, dtype):
+        return _quant_matmul._call(a, b, scales, bits, bias, activation, dtype)
+
+
+def quant_matmul(a, b, scales, bits=8, bias=None, activation=None, dtype=None):
+    """
+    Computes :code:`activation(a @ dequantize(b, scales) + bias)`, where :code:`b` and :code:`scales`
+    are produced by :code:`quantize` and :code:`a` is fp16. Weights are dequantized on the fly.
+
+    :param bits: 8 for int8 weights, 4 for packed int4 weights.
+    :param activation: one of :code:`None`, :code:`'relu'` or :code:`'gelu'` (tanh approximation).
+    :param dtype: data-type of the output; defaults to that of :code:`a`.
+    """
+    return _quant_matmul.apply(a, b, scales, bits, bias, activation, dtype)
@@ -0,0 +1,80 @@
+import torch
+import triton
+import triton.language as tl
+
+# ********************************************************
+# --------------------------------------------------------
+# Top-k along the last dimension, for rows of up to 4096
+# elements: every program keeps the first BLOCK_K >= k
+# values of a few rows with tl.topk and writes back k.
+# --------------------------------------------------------
+# ********************************************************
+
+_MAX_N = 4096
+
+
+def next_power_of_2(n):
+    return 1 << (n - 1).bit_length()
+
+
+@triton.jit
+def _kernel(X, VALUES, INDICES, M, N, K, stride_xm, stride_vm, stride_im, **META):
+    BLOCK_M = META['BLOCK_M']
+    BLOCK_N = META['BLOCK_N']
+    rm = tl.program_id(0) * BLOCK_M + tl.arange(0, BLOCK_M)
+    rn = tl.arange(0, BLOCK_N)
+    # padding sorts after every element of the row, since
+    # ties are broken by index
+    mask = (rm < M)[:, None] & (rn < N)[None, :]
+    x = tl.load(X + (rm[:, None] * stride_xm + rn[None, :]), mask=mask, other=META['PAD'])
+    values, indices = tl.topk(x, META['BLOCK_K'], largest=META['LARGEST'])
+    rk = tl.arange(0, META['BLOCK_K'])
+    mask = (rm < M)[:, None] & (rk < K)[None, :]
+    tl.store(VALUES + (rm[:, None] * stride_vm + rk[None, :]), values, mask=mask)
+    tl.store(INDICES + (rm[:, None] * stride_im + rk[None, :]), indices, mask=mask)
+
+
+_float_dtypes = [torch.float16, torch.bfloat16, torch.float32]
+_int_dtypes = [torch.int8, torch.int16, torch.int32]
+
+
+def topk(x, k, largest=True):
+    """
+    Returns the :code:`k` largest (or smallest) elements of :code:`x` along its last dimension, in sorted
+    order, as well as their int64 indices. Ties are broken in favor of the lowest index, so the result
+    is deterministic.
+
+    :param x: a tensor whose last dimension has at most 4096 elements.
+    :param largest: return the :code:`k` smallest elements instead if :code:`False`.
+    """
+    # checks constraints
+    N = x.shape[-1]
+    assert 0 <= k <= N, "k must be in [0, N]"
+    assert N <= _MAX_N, f"the last dimension must have at most {_MAX_N} elements"
+    assert x.dtype in _float_dtypes + _int_dtypes, f"unsupported data-type {x.dtype}"
+    shape = x.shape
+    x = x.reshape(-1, N)
+    if x.stride(-1) != 1:
+        x = x.contiguous()
+    M = x.shape[0]
+    # allocates outputs
+    values = torch.empty((M, k), device=x.device, dtype=x.dtype)
+    indices = torch.empty((M, k), device=x.device, dtype=torch.int64)
+    if M == 0 or k == 0:
+        return values.reshape(shape[:-1] + (k, )), indices.reshape(shape[:-1] + (k, ))
+    # padding value
+    if x.dtype in _float_dtypes:
+        pad = float('-inf') if largest else float('inf')
+    else:
+        pad = torch.iinfo(x.dtype).min if largest else torch.iinfo(x.dtype).max
+    # short rows are batched, so that every program sorts at least 1024 elements
+    BLOCK_N = max(next_power_of_2(N), 2)
+    BLOCK_K = next_power_of_2(k)
+    BLOCK_M = max(1024 // BLOCK_N, 1)
+    num_warps = 4 if BLOCK_M * BLOCK_N <= 1024 else 8
+    grid = (triton.cdiv(M, BLOCK_M), )
+    _kernel[grid](x, values, indices, M, N, k,
+                  x.stride(0), values.stride(0), indices.stride(0),
+                  BLOCK_M=BLOCK_M, BLOCK_N=BLOCK_N, BLOCK_K=BLOCK_K, PAD=pad, LARGEST=largest,
+                  num_warps=num_warps)
+    return values.reshape(shape[:-1] + (k, )), indices.reshape(shape[:-1] + (k, ))